@@ -1,74 +1,70 @@
+#include "assembler.h"
+#include "cfg.h"
+#include "peephole.h"
+#include "register_allocator.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <set>
 #include <cctype>
+#include <cstdint>
 #include <algorithm>
 #include <sstream>
-#include <unordered_map>
-
-// Ԫʽݽṹ
-struct Quadruple {
-    int label;        // ǩ/к
-    std::string op;   // 
-    std::string arg1; // 1
-    std::string arg2; // 2
-    std::string result; // 
-};
+#include <stdexcept>
 
-// жǷΪʱTͷ֣
+// 判断是否为临时变量（T开头后跟数字）
 bool is_temp(const std::string& s) {
     return !s.empty() && s[0] == 'T' && std::all_of(s.begin() + 1, s.end(), ::isdigit);
 }
 
-// жǷΪֳ
+// 判断是否为数字常量
 bool is_number(const std::string& s) {
     return !s.empty() && std::all_of(s.begin(), s.end(), ::isdigit);
 }
 
-// ļԪʽ
+// 从文件解析四元式
 std::vector<Quadruple> parse_quads(const std::string& filename) {
     std::ifstream file(filename);
     std::vector<Quadruple> quads;
     std::string line;
 
     while (std::getline(file, line)) {
-        // 
+        // 跳过空行
         if (line.empty()) continue;
 
-        // ȡǩţкţ
+        // 提取标签号（行号）
         size_t start_pos = line.find('(');
         if (start_pos == std::string::npos) continue;
 
         std::string label_str = line.substr(0, line.find(' '));
         int label = std::stoi(label_str);
 
-        // ȡڵ
+        // 提取括号内的内容
         std::string content = line.substr(start_pos + 1);
         content = content.substr(0, content.find(')'));
 
-        // ŷָ
+        // 按逗号分割各部分
         std::vector<std::string> parts;
         std::stringstream ss(content);
         std::string part;
         while (std::getline(ss, part, ',')) {
-            // ȥǰո
+            // 去除前后空格
             part.erase(0, part.find_first_not_of(' '));
             part.erase(part.find_last_not_of(' ') + 1);
             parts.push_back(part);
         }
 
-        // ȷ4֣㲹գ
+        // 确保有4个部分（不足补空）
         while (parts.size() < 4) parts.push_back("");
 
-        // Ԫʽ󲢼б
+        // 构建四元式对象并加入列表
         Quadruple quad{ label, parts[0], parts[1], parts[2], parts[3] };
         quads.push_back(quad);
     }
     return quads;
 }
 
-// ռбʱͷ֣
+// 收集所有变量（非临时变量和非数字）
 std::set<std::string> collect_vars(const std::vector<Quadruple>& quads) {
     std::set<std::string> vars;
     for (const auto& quad : quads) {
@@ -82,178 +78,674 @@ std::set<std::string> collect_vars(const std::vector<Quadruple>& quads) {
     return vars;
 }
 
-// ɻ
-void generate_assembly(const std::vector<Quadruple>& quads, const std::set<std::string>& vars, const std::string& output_filename) {
-    std::ofstream asm_file(output_filename);
-    std::cout << "ɻ뵽: " << output_filename << std::endl;
-
-    /******************** ļͷ ********************/
-    asm_file << ";************************************\n";
-    asm_file << ";*  pas.asm                          *\n";
-    asm_file << ";*  ԪʽļɵĻļ       *\n";
-    asm_file << ";************************************\n\n";
-    std::cout << ";************************************\n";
-    std::cout << ";*  pas.asm                          *\n";
-    std::cout << ";*  ԪʽļɵĻļ       *\n";
-    std::cout << ";************************************\n\n";
-
-    /******************** ݶζ ********************/
-    asm_file << "data segment   \n";
-    std::cout << "data segment   \n";
-    // Ϊÿ洢ռ
-    for (const auto& var : vars) {
-        asm_file << "    " << var << "           DW ?\n";  // DW ? ʾһֿռ
-        std::cout << "    " << var << "           DW ?\n";
+namespace {
+
+// 汇编指令的运算对象：立即数、寄存器或数据段中的字（变量、溢出槽位）
+struct Operand {
+    enum Kind { NONE, IMM, REG, MEM };
+    Kind kind = NONE;
+    int reg = -1;
+    int16_t value = 0;
+    std::string text;
+
+    bool is_reg(int r) const { return kind == REG && reg == r; }
+    bool same(const Operand& other) const { return kind == other.kind && text == other.text; }
+};
+
+Operand immediate(int16_t value) {
+    Operand operand;
+    operand.kind = Operand::IMM;
+    operand.value = value;
+    operand.text = std::to_string(static_cast<uint16_t>(value)) + "D";  // D表示十进制立即数
+    return operand;
+}
+
+Operand in_register(int reg) {
+    Operand operand;
+    operand.kind = Operand::REG;
+    operand.reg = reg;
+    operand.text = register_name(reg);
+    return operand;
+}
+
+Operand in_memory(const std::string& name) {
+    Operand operand;
+    operand.kind = Operand::MEM;
+    operand.text = name;
+    return operand;
+}
+
+const unsigned MULDIV_MASK = (1u << REG_AX) | (1u << REG_DX);  // 乘除隐含使用的寄存器
+
+std::string slot_name(int slot) {
+    return "_S" + std::to_string(slot + 1);
+}
+
+// 第 k 个 switch 四元式的跳转表，按四元式的顺序编号
+std::string table_name(int k) {
+    return "_JT" + std::to_string(k + 1);
+}
+
+// 条件跳转四元式对应的有符号条件转移指令
+std::string jump_instruction(const std::string& op) {
+    if (op == "j<") return "jl";
+    if (op == "j<=") return "jle";
+    if (op == "j>") return "jg";
+    if (op == "j>=") return "jge";
+    if (op == "j=") return "je";
+    if (op == "j<>") return "jne";
+    throw std::runtime_error("未知的条件跳转：" + op);
+}
+
+bool compare_constants(const std::string& op, int16_t a, int16_t b) {
+    if (op == "j<") return a < b;
+    if (op == "j<=") return a <= b;
+    if (op == "j>") return a > b;
+    if (op == "j>=") return a >= b;
+    if (op == "j=") return a == b;
+    return a != b;
+}
+
+// 8086 各指令形式的时钟周期数（取自 Intel 8086 手册，乘除取区间的中值）。
+// r 为寄存器，m 为内存字，i 为立即数；内存形式另加有效地址的计算时间，直接寻址为6个周期
+struct InstructionCost {
+    const char* op;
+    const char* form;
+    int cycles;
+};
+
+const InstructionCost COST_TABLE[] = {
+    { "mov", "r,r", 2 }, { "mov", "r,m", 8 }, { "mov", "m,r", 9 }, { "mov", "r,i", 4 }, { "mov", "m,i", 10 },
+    { "add", "r,r", 3 }, { "add", "r,m", 9 }, { "add", "m,r", 16 }, { "add", "r,i", 4 }, { "add", "m,i", 17 },
+    { "sub", "r,r", 3 }, { "sub", "r,m", 9 }, { "sub", "m,r", 16 }, { "sub", "r,i", 4 }, { "sub", "m,i", 17 },
+    { "cmp", "r,r", 3 }, { "cmp", "r,m", 9 }, { "cmp", "m,r", 9 }, { "cmp", "r,i", 4 }, { "cmp", "m,i", 10 },
+    { "xor", "r,r", 3 }, { "test", "r,r", 3 },
+    { "inc", "r", 2 }, { "inc", "m", 15 }, { "dec", "r", 2 }, { "dec", "m", 15 },
+    { "neg", "r", 3 }, { "neg", "m", 16 },
+    { "shl", "r,i", 2 }, { "shl", "m,i", 15 },  // 8086 只能移1位
+    { "imul", "r", 141 }, { "imul", "m", 147 },
+    { "idiv", "r", 175 }, { "idiv", "m", 181 },
+    { "cwd", "", 5 }, { "push", "r", 11 }, { "pop", "r", 8 },
+    { "jmp", "", 15 }, { "jmp", "m", 18 }, { "jcc", "", 16 },  // 条件转移按转移成立计
+};
+const int DIRECT_ADDRESS_CYCLES = 6;
+
+int instruction_cycles(const std::string& op, const Operand& a, const Operand& b) {
+    static const char forms[] = { ' ', 'i', 'r', 'm' };  // 按 Operand::Kind
+    std::string form;
+    if (a.kind != Operand::NONE) form += forms[a.kind];
+    if (b.kind != Operand::NONE) form += std::string(",") + forms[b.kind];
+    for (const auto& entry : COST_TABLE) {
+        if (op == entry.op && form == entry.form) {
+            bool memory = a.kind == Operand::MEM || b.kind == Operand::MEM;
+            return entry.cycles + (memory ? DIRECT_ADDRESS_CYCLES : 0);
+        }
     }
-    asm_file << "data ends      \n\n";
-    std::cout << "data ends      \n\n";
-
-    /******************** ζ ********************/
-    asm_file << "code segment    \n";
-    asm_file << "main proc far   \n";
-    asm_file << "    assume cs:code,ds:data\n\n";  // öμĴ
-    asm_file << "start:\n";
-    // ׼ʼ
-    asm_file << "    push ds\n";      // DSĴ
-    asm_file << "    sub bx,bx\n";    // BX
-    asm_file << "    push bx\n";      // ѹ뷵صַ
-    asm_file << "    mov bx,data\n";  // ݶεַ
-    asm_file << "    mov ds,bx\n";    // DSĴ
-
-    // ̨ͬ
-    std::cout << "code segment    \n";
-    std::cout << "main proc far   \n";
-    std::cout << "    assume cs:code,ds:data\n\n";
-    std::cout << "start:\n";
-    std::cout << "    push ds\n";
-    std::cout << "    sub bx,bx\n";
-    std::cout << "    push bx\n";
-    std::cout << "    mov bx,data\n";
-    std::cout << "    mov ds,bx\n";
-
-    // ʱĴӳ
-    std::unordered_map<std::string, std::string> temp_reg_map;
-
-    /******************** Ԫʽת ********************/
-    for (const auto& quad : quads) {
-        // ǩΪ
-        asm_file << quad.label << ":\n";
-        std::cout << quad.label << ":\n";
-
-        // תָj>, j>=, j=
-        if (quad.op == "j>" || quad.op == "j>=" || quad.op == "j="||quad.op == "j<" || quad.op == "j<=" || quad.op == "j<>") {
-            std::string arg1 = quad.arg1;
-            std::string arg2 = quad.arg2;
-            std::string jmp_target = quad.result;
-
-            // һƶAXĴ
-            asm_file << "    mov AX, " << arg1 << "\n";
-            std::cout << "    mov AX, " << arg1 << "\n";
-
-            // Ƚָ
-            asm_file << "    cmp AX, " << arg2 << "\n";
-            std::cout << "    cmp AX, " << arg2 << "\n";
-
-            // ݲɲͬתָ
-            if (quad.op == "j>") {
-                asm_file << "    jg  " << jmp_target << "\n";  // ת
-                std::cout << "    jg  " << jmp_target << "\n";
-            }
-            else if (quad.op == "j>=") {
-                asm_file << "    jge " << jmp_target << "\n";  // ڵת
-                std::cout << "    jge " << jmp_target << "\n";
-            }
-            else if (quad.op == "j=") {
-                asm_file << "    je  " << jmp_target << "\n";  // ת
-                std::cout << "    je  " << jmp_target << "\n";
-            }
-            else if (quad.op == "j<") {
-                asm_file << "    jl " << jmp_target << "\n";  // Сת
-                std::cout << "    jl " << jmp_target << "\n";
+    throw std::runtime_error("代价表中没有指令形式：" + op + " " + form);
+}
+
+// 一条指令与一段候选的指令序列
+struct Instruction {
+    std::string op;
+    Operand a, b = Operand();  // 单操作数指令不写 b
+};
+using Sequence = std::vector<Instruction>;
+
+int sequence_cycles(const Sequence& code) {
+    int cycles = 0;
+    for (const auto& instruction : code) cycles += instruction_cycles(instruction.op, instruction.a, instruction.b);
+    return cycles;
+}
+
+// n 的非相邻形式（NAF），从最高位起，各位为 0、1、-1，最高位为1。非零位最少，移位加减的条数也最少
+std::vector<int> non_adjacent_form(uint32_t n) {
+    std::vector<int> digits;
+    while (n != 0) {
+        int digit = 0;
+        if (n & 1) {
+            digit = (n & 3) == 3 ? -1 : 1;
+            n = digit < 0 ? n + 1 : n - 1;
+        }
+        digits.push_back(digit);
+        n >>= 1;
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+// 按寄存器分配的结果逐条翻译四元式
+// 运算结果在寄存器中时直接在其中计算，两个运算对象都不在寄存器中时借用一个本条四元式执行期间
+// 空闲的寄存器；乘除用 AX、DX，分配保证跨过乘除仍要使用的值不在这两个寄存器中。
+// 除法按四元式的语义处理除数为0（结果为0）与 -1（取负，避免 -32768/-1 溢出）。
+// 指令选择：赋值、加减、乘法与条件转移先列出若干候选序列（通用翻译，以及 add m,i、inc/dec、
+// neg、xor、test、移位加减代替乘常数等模式），按代价表估计的周期数取最快的一个
+class Emitter {
+public:
+    Emitter(const std::vector<Quadruple>& quads, const RegisterAllocation& allocation, std::vector<AsmInstruction>& code,
+        AsmStats& stats)
+        : quads(quads), allocation(allocation), code(code), stats(stats) {}
+
+    void translate(int i) {
+        const Quadruple& quad = quads[i];
+        current = i;
+        labels = 0;
+        code.push_back(label_line(std::to_string(quad.label)));
+        if (entries > 0) {
+            entries--;  // 跳转表的表项，目标已写在数据段的表中
+            return;
+        }
+        int before = stats.cycles;
+        saved = 0;
+        loadVariables(i);
+        Operand a = operand(i, 0), b = operand(i, 1);
+        if (is_cond_jump(quad.op)) {
+            conditionalJump(quad, a, b);
+        }
+        else if (quad.op == "j") {
+            emitJump("jmp", quad.result);
+        }
+        else if (quad.op == "switch") {
+            jumpTable(quad, a);
+        }
+        else {
+            Operand d = operand(i, 2);
+            if (quad.op == ":=") copy(d, a);
+            else if (quad.op == "+" || quad.op == "-") addSubtract(quad.op, d, a, b);
+            else if (quad.op == "*") multiply(d, a, b);
+            else if (quad.op == "/") divide(d, a, b);
+            else throw std::runtime_error("无法翻译的四元式：" + quad.op);
+            storeVariable(i);
+        }
+        stats.generic_cycles += stats.cycles - before + saved;
+    }
+
+private:
+    const std::vector<Quadruple>& quads;
+    const RegisterAllocation& allocation;
+    std::vector<AsmInstruction>& code;
+    AsmStats& stats;
+    int current = 0;
+    int labels = 0;
+    int saved = 0;  // 本条四元式的指令选择比通用翻译节省的周期
+    unsigned scratchInUse = 0;
+    std::vector<int> pushed;
+    int tables = 0;   // 已翻译的 switch 四元式个数
+    int entries = 0;  // 尚未跳过的跳转表表项
+
+    Operand operand(int i, int k) const {
+        const Quadruple& quad = quads[i];
+        const std::string& name = k == 0 ? quad.arg1 : k == 1 ? quad.arg2 : quad.result;
+        if (name.empty()) return Operand();
+        if (is_number(name)) return immediate(static_cast<int16_t>(std::stol(name)));
+        int index = allocation.operand_interval[3 * i + k];
+        if (index < 0) return in_memory(name);
+        const LiveInterval& interval = allocation.intervals[index];
+        if (interval.reg >= 0) return in_register(interval.reg);
+        return in_memory(interval.variable ? name : slot_name(interval.slot));
+    }
+
+    void emit(const std::string& op, const Operand& a = Operand(), const Operand& b = Operand()) {
+        AsmInstruction line;
+        line.op = op;
+        line.a = a.text;
+        line.b = b.text;
+        line.cycles = instruction_cycles(op, a, b);
+        line.memory = a.kind == Operand::MEM || b.kind == Operand::MEM;
+        code.push_back(line);
+        stats.instructions++;
+        stats.cycles += line.cycles;
+        if (line.memory) stats.memory_operands++;
+    }
+
+    void emitJump(const std::string& op, const std::string& target) {
+        AsmInstruction line;
+        line.op = op;
+        line.a = target;
+        line.cycles = instruction_cycles(op == "jmp" ? op : "jcc", Operand(), Operand());
+        code.push_back(line);
+        stats.instructions++;
+        stats.cycles += line.cycles;
+    }
+
+    // candidates[0] 是通用翻译；输出估计周期最少的候选（相同时取指令少的、靠前的）
+    void select(const std::vector<Sequence>& candidates) {
+        size_t best = 0;
+        int bestCycles = sequence_cycles(candidates[0]);
+        for (size_t k = 1; k < candidates.size(); k++) {
+            int cycles = sequence_cycles(candidates[k]);
+            if (cycles < bestCycles || (cycles == bestCycles && candidates[k].size() < candidates[best].size())) {
+                best = k;
+                bestCycles = cycles;
             }
-            else if (quad.op == "j<=") {
-                asm_file << "    jle  " << jmp_target << "\n";  // Сڵת
-                std::cout << "    jle  " << jmp_target << "\n";
+        }
+        saved += sequence_cycles(candidates[0]) - bestCycles;
+        for (const auto& instruction : candidates[best]) emit(instruction.op, instruction.a, instruction.b);
+    }
+
+    std::string newLabel() {
+        return "L" + std::to_string(quads[current].label) + "_" + std::to_string(++labels);
+    }
+
+    // 取一个本条四元式执行期间空闲的寄存器；都被占用时借用一个与本条四元式无关的寄存器，用后恢复
+    int acquire(unsigned avoid) {
+        unsigned taken = allocation.busy[current] | avoid | scratchInUse;
+        for (int reg = 0; reg < NUM_REGISTERS; reg++) {
+            if (!(taken & (1u << reg))) {
+                scratchInUse |= 1u << reg;
+                return reg;
             }
-            else if (quad.op == "j<>") {
-                asm_file << "    jne  " << jmp_target << "\n";  // ת
-                std::cout << "    jne  " << jmp_target << "\n";
+        }
+        unsigned involved = avoid | scratchInUse;
+        for (int k = 0; k < 3; k++) {
+            Operand used = operand(current, k);
+            if (used.kind == Operand::REG) involved |= 1u << used.reg;
+        }
+        for (int reg = 0; reg < NUM_REGISTERS; reg++) {
+            if (involved & (1u << reg)) continue;
+            emit("push", in_register(reg));
+            code.back().memory = true;
+            stats.memory_operands++;
+            pushed.push_back(reg);
+            scratchInUse |= 1u << reg;
+            return reg;
+        }
+        throw std::runtime_error("没有可借用的寄存器");
+    }
+
+    void release(int reg) {
+        if (!pushed.empty() && pushed.back() == reg) {
+            emit("pop", in_register(reg));
+            code.back().memory = true;
+            stats.memory_operands++;
+            pushed.pop_back();
+        }
+        scratchInUse &= ~(1u << reg);
+    }
+
+    // 放在寄存器中的变量在区间开始处装入，块内最后一次定值后写回
+    void loadVariables(int i) {
+        for (int k = 0; k < 2; k++) {
+            int index = allocation.operand_interval[3 * i + k];
+            if (index < 0 || (k == 1 && index == allocation.operand_interval[3 * i])) continue;
+            const LiveInterval& interval = allocation.intervals[index];
+            if (interval.variable && interval.reg >= 0 && interval.load && interval.start == 2 * i) {
+                emit("mov", in_register(interval.reg), in_memory(interval.name));
             }
         }
-        // תָ
-        else if (quad.op == "j") {
-            asm_file << "    jmp " << quad.result << "\n";
-            std::cout << "    jmp " << quad.result << "\n";
-        }
-        // ֵָ
-        else if (quad.op == ":=") {
-            // ԴʱʹAXĴ֮ǰ
-            if (is_temp(quad.arg1)) {
-                asm_file << "    mov " << quad.result << ", AX\n";
-                std::cout << "    mov " << quad.result << ", AX\n";
+    }
+
+    void storeVariable(int i) {
+        int index = allocation.operand_interval[3 * i + 2];
+        if (index < 0) return;
+        const LiveInterval& interval = allocation.intervals[index];
+        if (interval.variable && interval.reg >= 0 && interval.last_def == i) {
+            emit("mov", in_memory(interval.name), in_register(interval.reg));
+        }
+    }
+
+    void copy(const Operand& d, const Operand& a) {
+        if (d.same(a)) return;
+        if (d.kind == Operand::MEM && a.kind == Operand::MEM) {
+            int s = acquire(0);
+            emit("mov", in_register(s), a);
+            emit("mov", d, in_register(s));
+            release(s);
+            return;
+        }
+        std::vector<Sequence> candidates = { { { "mov", d, a } } };
+        if (d.kind == Operand::REG && a.kind == Operand::IMM && a.value == 0) candidates.push_back({ { "xor", d, d } });
+        select(candidates);
+    }
+
+    static bool both_memory(const Operand& x, const Operand& y) {
+        return x.kind == Operand::MEM && y.kind == Operand::MEM;
+    }
+
+    // 在 t（寄存器或内存字）中计算 a op b，追加到 code；需要两个内存运算对象、
+    // 或者先写 t 会冲掉 b 时不可行，返回 false。idioms 为真时用常数折叠、inc/dec 与 neg
+    static bool arithmetic(Sequence& code, const Operand& t, const std::string& op, const Operand& a, const Operand& b,
+        bool idioms) {
+        if (idioms && a.kind == Operand::IMM && b.kind == Operand::IMM) {
+            code.push_back({ "mov", t, immediate(static_cast<int16_t>(op == "+" ? a.value + b.value : a.value - b.value)) });
+            return true;
+        }
+        if (b.same(t) && !a.same(t)) {
+            if (op == "+" || both_memory(t, a)) return false;
+            // t 与减数同在一处：a - b = -b + a
+            code.push_back({ "neg", t });
+            code.push_back({ "add", t, a });
+            return true;
+        }
+        if (idioms && op == "-" && a.kind == Operand::IMM && a.value == 0) {
+            if (both_memory(t, b)) return false;
+            if (!b.same(t)) code.push_back({ "mov", t, b });
+            code.push_back({ "neg", t });
+            return true;
+        }
+        if (!a.same(t)) {
+            if (both_memory(t, a)) return false;
+            code.push_back({ "mov", t, a });
+        }
+        if (idioms && b.kind == Operand::IMM) {
+            int16_t value = op == "+" ? b.value : static_cast<int16_t>(-b.value);
+            if (value == 0) return true;
+            if (value == 1 || value == -1) {
+                code.push_back({ value == 1 ? "inc" : "dec", t });
+                return true;
             }
-            else {
-                // ֱӸֵ
-                asm_file << "    mov AX, " << quad.arg1 << "\n";
-                asm_file << "    mov " << quad.result << ", AX\n";
-                std::cout << "    mov AX, " << quad.arg1 << "\n";
-                std::cout << "    mov " << quad.result << ", AX\n";
+        }
+        if (both_memory(t, b)) return false;
+        code.push_back({ op == "+" ? "add" : "sub", t, b });
+        return true;
+    }
+
+    void addSubtract(const std::string& op, const Operand& d, Operand a, Operand b) {
+        if (op == "+" && b.same(d) && !a.same(d)) std::swap(a, b);
+        int s = d.kind == Operand::REG ? -1 : acquire(0);
+        // 通用翻译：结果在寄存器中时直接在其中计算，否则在借用的寄存器中算好再写入
+        std::vector<Sequence> candidates(1);
+        if (s < 0) {
+            arithmetic(candidates[0], d, op, a, b, false);
+        }
+        else {
+            arithmetic(candidates[0], in_register(s), op, a, b, false);
+            candidates[0].push_back({ "mov", d, in_register(s) });
+        }
+        // 其余候选：直接在结果处计算（如 add m,i、inc m），或经借用的寄存器；加法两种次序都试
+        for (int order = 0; order < (op == "+" ? 2 : 1); order++) {
+            const Operand& x = order == 0 ? a : b;
+            const Operand& y = order == 0 ? b : a;
+            Sequence direct;
+            if (arithmetic(direct, d, op, x, y, true)) candidates.push_back(direct);
+            Sequence via;
+            if (s >= 0 && arithmetic(via, in_register(s), op, x, y, true)) {
+                via.push_back({ "mov", d, in_register(s) });
+                candidates.push_back(via);
             }
         }
-        // ӷָ
-        else if (quad.op == "+") {
-            // һʱѾAX
-            if (is_temp(quad.arg1)) {
-                if (is_temp(quad.arg2)) {
-                    // ʱ
-                    asm_file << "    mov BX, " << quad.arg2 << "\n";  // صڶʱBX
-                    asm_file << "    add AX, BX\n";                   // ִмӷ
-                    std::cout << "    mov BX, " << quad.arg2 << "\n";
-                    std::cout << "    add AX, BX\n";
-                }
-                else {
-                    // ڶֻ
-                    asm_file << "    add AX, " << quad.arg2 << "D\n";  // Dʾ
-                    std::cout << "    add AX, " << quad.arg2 << "D\n";
+        select(candidates);
+        if (s >= 0) release(s);
+    }
+
+    // 在 t 中计算 x*n（n 按16位回绕），negate 为真时再取负。按 n 的非相邻形式从高位起
+    // 逐位左移一位、遇非零位加减 x；中途还要读 x 时 t 不能与 x 同处
+    static bool multiplyByConstant(Sequence& code, const Operand& t, const Operand& x, uint16_t n, bool negate) {
+        std::vector<int> digits = non_adjacent_form(n);
+        bool readsX = std::any_of(digits.begin() + 1, digits.end(), [](int digit) { return digit != 0; });
+        if (readsX && x.same(t)) return false;
+        if (!x.same(t)) {
+            if (both_memory(t, x)) return false;
+            code.push_back({ "mov", t, x });
+        }
+        for (size_t k = 1; k < digits.size(); k++) {
+            code.push_back({ "shl", t, immediate(1) });
+            if (digits[k] == 0) continue;
+            if (both_memory(t, x)) return false;
+            code.push_back({ digits[k] > 0 ? "add" : "sub", t, x });
+        }
+        if (negate) code.push_back({ "neg", t });
+        return true;
+    }
+
+    // imul 只有单操作数形式：DX:AX = AX * r/m16，低16位即回绕后的乘积。
+    // 乘以常数时还考虑移位加减：8086 的 lea 不带比例因子，算不了 x*3、x*5 这类地址式乘法
+    void multiply(const Operand& d, const Operand& a, const Operand& b) {
+        // 通用翻译：已在 AX 中的一方作被乘数；否则让立即数装入 AX，另一方直接作 imul 的运算对象
+        Operand x = a, y = b;
+        if (y.is_reg(REG_AX) || (!x.is_reg(REG_AX) && y.kind == Operand::IMM && x.kind != Operand::IMM)) std::swap(x, y);
+        int s = y.kind == Operand::IMM ? acquire(MULDIV_MASK) : -1;
+        Operand ax = in_register(REG_AX);
+        std::vector<Sequence> candidates(1);
+        Sequence& generic = candidates[0];
+        if (!x.is_reg(REG_AX)) generic.push_back({ "mov", ax, x });
+        if (y.kind == Operand::IMM) {
+            generic.push_back({ "mov", in_register(s), y });
+            generic.push_back({ "imul", in_register(s) });
+        }
+        else {
+            generic.push_back({ "imul", y });
+        }
+        if (!d.is_reg(REG_AX)) generic.push_back({ "mov", d, ax });
+
+        // 乘以常数：两个常数直接折叠；否则在结果处或借用的寄存器中移位加减，
+        // 乘数取绝对值最后取负，或者取16位无符号值，两种都试
+        x = a;
+        y = b;
+        if (x.kind == Operand::IMM) std::swap(x, y);
+        if (x.kind == Operand::IMM) {
+            candidates.push_back({ { "mov", d, immediate(static_cast<int16_t>(x.value * y.value)) } });
+        }
+        else if (y.kind == Operand::IMM && y.value == 0) {
+            candidates.push_back({ { "mov", d, immediate(0) } });
+            if (d.kind == Operand::REG) candidates.push_back({ { "xor", d, d } });
+        }
+        else if (y.kind == Operand::IMM) {
+            uint16_t magnitude = static_cast<uint16_t>(y.value < 0 ? -y.value : y.value);
+            for (int form = 0; form < 2; form++) {
+                uint16_t n = form == 0 ? magnitude : static_cast<uint16_t>(y.value);
+                bool negate = form == 0 && y.value < 0;
+                Sequence direct;
+                if (multiplyByConstant(direct, d, x, n, negate)) candidates.push_back(direct);
+                Sequence via;
+                if (s >= 0 && multiplyByConstant(via, in_register(s), x, n, negate)) {
+                    via.push_back({ "mov", d, in_register(s) });
+                    candidates.push_back(via);
                 }
             }
-            else {
-                // صһAX
-                asm_file << "    mov AX, " << quad.arg1 << "\n";
-                std::cout << "    mov AX, " << quad.arg1 << "\n";
-                if (is_temp(quad.arg2)) {
-                    // ʱ
-                    asm_file << "    mov BX, " << quad.arg2 << "\n";  // صڶʱBX
-                    asm_file << "    add AX, BX\n";                   // ִмӷ
-                    std::cout << "    mov BX, " << quad.arg2 << "\n";
-                    std::cout << "    add AX, BX\n";
-                }
-                else {
-                    asm_file << "    add AX, " << quad.arg2 << "D\n";
-                    std::cout << "    add AX, " << quad.arg2 << "D\n";
-                }
+        }
+        select(candidates);
+        if (s >= 0) release(s);
+    }
+
+    void divide(const Operand& d, const Operand& a, const Operand& b) {
+        Operand ax = in_register(REG_AX);
+        if (b.kind == Operand::IMM && b.value == 0) {
+            emit("mov", d, immediate(0));
+            return;
+        }
+        if (b.kind == Operand::IMM && b.value == -1) {
+            if (!a.is_reg(REG_AX)) emit("mov", ax, a);
+            emit("neg", ax);
+            if (!d.is_reg(REG_AX)) emit("mov", d, ax);
+            return;
+        }
+        // 除数须是 AX、DX 之外的寄存器或内存字
+        Operand divisor = b;
+        int s = -1;
+        if (b.kind == Operand::IMM || b.is_reg(REG_AX) || b.is_reg(REG_DX)) {
+            s = acquire(MULDIV_MASK);
+            divisor = in_register(s);
+            emit("mov", divisor, b);
+        }
+        if (!a.is_reg(REG_AX)) emit("mov", ax, a);
+        if (b.kind == Operand::IMM) {
+            emit("cwd");
+            emit("idiv", divisor);
+        }
+        else {
+            std::string zero = newLabel(), negate = newLabel(), done = newLabel();
+            emit("cmp", divisor, immediate(0));
+            emitJump("je", zero);
+            emit("cmp", divisor, immediate(-1));
+            emitJump("je", negate);
+            emit("cwd");
+            emit("idiv", divisor);
+            emitJump("jmp", done);
+            code.push_back(label_line(negate));
+            emit("neg", ax);
+            emitJump("jmp", done);
+            code.push_back(label_line(zero));
+            emit("xor", ax, ax);
+            code.push_back(label_line(done));
+        }
+        if (s >= 0) release(s);
+        if (!d.is_reg(REG_AX)) emit("mov", d, ax);
+    }
+
+    void conditionalJump(const Quadruple& quad, Operand a, Operand b) {
+        std::string op = quad.op;
+        if (a.kind == Operand::IMM && b.kind == Operand::IMM) {
+            if (compare_constants(op, a.value, b.value)) emitJump("jmp", quad.result);
+            return;
+        }
+        if (a.kind == Operand::IMM) {
+            std::swap(a, b);
+            op = mirror_relop(op);
+        }
+        if (a.kind == Operand::MEM && b.kind == Operand::MEM) {
+            int s = acquire(0);
+            emit("mov", in_register(s), a);
+            emit("cmp", in_register(s), b);
+            release(s);  // pop 不影响标志位
+        }
+        else {
+            std::vector<Sequence> candidates = { { { "cmp", a, b } } };
+            // 与0比较：test 置 OF=0，各有符号条件的结果与 cmp a,0 相同
+            if (a.kind == Operand::REG && b.kind == Operand::IMM && b.value == 0) candidates.push_back({ { "test", a, a } });
+            select(candidates);
+        }
+        emitJump(jump_instruction(op), quad.result);
+    }
+
+    // 按下标经数据段中的跳转表转移：jmp word ptr _JTk[r]，表项为字，下标先左移1位。
+    // 8086 只能用 BX、SI、DI 变址：下标已在其中且之后不再使用时直接改写，否则用一个空闲的；
+    // 都不空闲时逐个比较表项（jmp 之后无法恢复借用的寄存器）
+    void jumpTable(const Quadruple& quad, const Operand& index) {
+        std::string table = table_name(tables++);
+        entries = switch_entries(quad);
+        auto target = [&](int k) { return quads[current + 1 + k].result; };
+        if (index.kind == Operand::IMM) {
+            if (index.value >= 0 && index.value < entries) emitJump("jmp", target(index.value));
+            return;
+        }
+        int reg = -1;
+        int interval = allocation.operand_interval[3 * current];
+        if (index.kind == Operand::REG && index.reg != REG_AX && index.reg != REG_CX && index.reg != REG_DX &&
+            allocation.intervals[interval].end <= 2 * current) {
+            reg = index.reg;
+        }
+        unsigned taken = allocation.busy[current] | scratchInUse;
+        for (int r : { REG_BX, REG_SI, REG_DI }) {
+            if (reg < 0 && !(taken & (1u << r))) reg = r;
+        }
+        if (reg < 0) {
+            for (int k = 0; k < entries; k++) {
+                emit("cmp", index, immediate(static_cast<int16_t>(k)));
+                emitJump("je", target(k));
             }
-            // 洢AXйʹ
-            temp_reg_map[quad.result] = "AX";
+            return;
+        }
+        if (!index.is_reg(reg)) emit("mov", in_register(reg), index);
+        emit("shl", in_register(reg), immediate(1));
+        emit("jmp", in_memory("word ptr " + table + "[" + register_name(reg) + "]"));
+    }
+};
+
+}
+
+std::vector<std::string> assemble(const std::vector<Quadruple>& quads, const std::set<std::string>& vars, AsmStats* stats,
+    bool peephole) {
+    AsmStats local;
+    AsmStats& counts = stats ? *stats : local;
+    counts = AsmStats();
+    RegisterAllocation allocation = allocate_registers(quads);
+    counts.intervals = static_cast<int>(allocation.intervals.size());
+    counts.spilled = allocation.spilled;
+    counts.spill_slots = allocation.slots;
+    for (const auto& quad : quads) {
+        for (const std::string* name : { &quad.arg1, &quad.arg2, &quad.result }) {
+            if (is_jump(quad.op) && name == &quad.result) continue;
+            if (!name->empty() && !is_number(*name)) counts.naive_memory++;
         }
-        // ˷ָضʾ
-        else if (quad.op == "*") {
-            asm_file << "    mul "<< quad.arg1<<"\n";  // xxǳ
-            std::cout << "    mul "<< quad.arg1<<"\n";
-            // AX
-            temp_reg_map[quad.result] = "AX";
+    }
+
+    std::vector<std::string> lines;
+    /******************** 汇编文件头 ********************/
+    lines.push_back(";************************************");
+    lines.push_back(";*  pas.asm                          *");
+    lines.push_back(";*  由四元式文件生成的汇编文件       *");
+    lines.push_back(";************************************");
+    lines.push_back("");
+
+    /******************** 数据段定义 ********************/
+    // 每个变量与溢出槽位分配一个字（DW ?）
+    lines.push_back("data segment   ");
+    for (const auto& var : vars) {
+        lines.push_back("    " + var + "           DW ?");
+    }
+    for (int slot = 0; slot < allocation.slots; slot++) {
+        lines.push_back("    " + slot_name(slot) + "           DW ?");
+    }
+    // 跳转表：switch 四元式之后的各条 j 的目标标号
+    std::vector<std::string> table_targets;
+    for (size_t i = 0, k = 0; i < quads.size(); i++) {
+        int entries = switch_entries(quads[i]);
+        if (entries == 0) continue;
+        std::string line = "    " + table_name(static_cast<int>(k++)) + "           DW ";
+        for (int e = 0; e < entries; e++) {
+            const std::string& target = quads[i + 1 + e].result;
+            line += (e ? ", " : "") + target;
+            table_targets.push_back(target);
         }
+        lines.push_back(line);
+    }
+    lines.push_back("data ends      ");
+    lines.push_back("");
+
+    /******************** 代码段定义 ********************/
+    lines.push_back("code segment    ");
+    lines.push_back("main proc far   ");
+    lines.push_back("    assume cs:code,ds:data");  // 设置段寄存器关联
+    lines.push_back("");
+    lines.push_back("start:");
+    // 标准程序初始化代码：保存DS，压入返回地址，设置DS
+    lines.push_back("    push ds");
+    lines.push_back("    sub bx,bx");
+    lines.push_back("    push bx");
+    lines.push_back("    mov bx,data");
+    lines.push_back("    mov ds,bx");
+
+    /******************** 四元式转换 ********************/
+    std::vector<AsmInstruction> code;
+    Emitter emitter(quads, allocation, code, counts);
+    for (size_t i = 0; i < quads.size(); i++) {
+        emitter.translate(static_cast<int>(i));
     }
 
-    /********************  ********************/
-    asm_file << "117:\n";  // ǩ
-    asm_file << "    ret\n";  // زϵͳ
-    asm_file << "main endp\n";  // ̽
-    asm_file << "code ends\n";  // ν
-    asm_file << "    end start\n";  // ڵΪstart
-    std::cout << "117:\n";
-    std::cout << "    ret\n";
-    std::cout << "main endp\n";
-    std::cout << "code ends\n";
-    std::cout << "    end start\n";
-}
\ No newline at end of file
+    /******************** 程序结束部分 ********************/
+    // 程序结束标签：跳出程序的四元式以最后一条之后的标号为目标
+    int exit_label = quads.empty() ? 100 : quads.back().label + 1;
+    code.push_back(label_line(std::to_string(exit_label)));
+    AsmInstruction ret;
+    ret.op = "ret";                      // 返回操作系统（属于程序框架，不计周期）
+    code.push_back(ret);
+
+    /******************** 窥孔优化 ********************/
+    // 各四元式的标号大多不再被引用，删去后相邻四元式的指令才能一起匹配；跳转表引用的标号保留
+    if (peephole) {
+        counts.peephole = peephole_optimize(code, table_targets);
+        counts.instructions += counts.peephole.instructions_after - counts.peephole.instructions_before;
+        counts.cycles += counts.peephole.cycles_after - counts.peephole.cycles_before;
+        counts.memory_operands += counts.peephole.memory_after - counts.peephole.memory_before;
+    }
+    for (const auto& line : code) {
+        lines.push_back(format_instruction(line));
+    }
+    lines.push_back("main endp");        // 过程结束
+    lines.push_back("code ends");        // 代码段结束
+    lines.push_back("    end start");    // 程序结束，入口点为start
+    return lines;
+}
+
+// 生成汇编代码，同时输出到控制台
+AsmStats generate_assembly(const std::vector<Quadruple>& quads, const std::set<std::string>& vars, const std::string& output_filename) {
+    AsmStats stats;
+    std::vector<std::string> lines = assemble(quads, vars, &stats);
+    std::ofstream asm_file(output_filename);
+    std::cout << "生成汇编代码到: " << output_filename << std::endl;
+    for (const auto& line : lines) {
+        asm_file << line << "\n";
+        std::cout << line << "\n";
+    }
+    return stats;
+}
@@ -1,23 +1,41 @@
-#pragma once
-#ifndef ASSEMBLER_H
-#define ASSEMBLER_H
-
-#include <string>
-#include <vector>
-#include <set>
-
-struct Quadruple {
-    int label;
-    std::string op;
-    std::string arg1;
-    std::string arg2;
-    std::string result;
-};
-
-bool is_temp(const std::string& s);
-bool is_number(const std::string& s);
-std::vector<Quadruple> parse_quads(const std::string& filename);
-std::set<std::string> collect_vars(const std::vector<Quadruple>& quads);
-void generate_assembly(const std::vector<Quadruple>& quads, const std::set<std::string>& vars, const std::string& output_filename);
-
+#pragma once
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include "peephole.h"
+#include <string>
+#include <vector>
+#include <set>
+
+struct Quadruple {
+    int label;
+    std::string op;
+    std::string arg1;
+    std::string arg2;
+    std::string result;
+};
+
+bool is_temp(const std::string& s);
+bool is_number(const std::string& s);
+std::vector<Quadruple> parse_quads(const std::string& filename);
+std::set<std::string> collect_vars(const std::vector<Quadruple>& quads);
+
+// 生成的汇编代码的静态统计
+struct AsmStats {
+    int instructions = 0;     // 指令条数（不含程序框架）
+    int memory_operands = 0;  // 访问数据段或栈的指令条数
+    int naive_memory = 0;     // 所有名字都放在内存中时各四元式读写内存的次数
+    int intervals = 0;        // 寄存器分配的生存区间
+    int spilled = 0;          // 溢出的区间
+    int spill_slots = 0;      // 数据段中的溢出槽位
+    int cycles = 0;           // 按代价表估计的时钟周期（每条指令执行一次，条件转移按转移成立计）
+    int generic_cycles = 0;   // 同样的寄存器分配下各四元式都用通用翻译时的估计周期
+    PeepholeStats peephole;   // 窥孔优化的统计；上面的指令、访存与周期数是窥孔优化之后的
+};
+// 经寄存器分配翻译成完整的8086汇编程序，每个元素为一行。peephole 为真时输出前先对指令序列做窥孔优化
+std::vector<std::string> assemble(const std::vector<Quadruple>& quads, const std::set<std::string>& vars, AsmStats* stats = nullptr,
+    bool peephole = true);
+// 写入汇编文件并输出到控制台
+AsmStats generate_assembly(const std::vector<Quadruple>& quads, const std::set<std::string>& vars, const std::string& output_filename);
+
 #endif // ASSEMBLER_H
\ No newline at end of file
@@ -0,0 +1,145 @@
+// 汇编生成基准测试
+// 对不同规模、不同随机种子的合成程序运行全部优化遍后生成8086汇编，统计寄存器分配的区间、
+// 溢出与槽位数，生成的指令条数与访存指令条数（并与所有名字都放在内存中时的访存次数比较），
+// 按代价表估计的时钟周期与全部用通用翻译时的周期，窥孔优化删去的指令条数（最后汇总各规则的命中次数），
+// 再用汇编解释器执行，核对各变量的最终值与四元式解释执行一致，并统计执行的指令与访存条数。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -I. -o asm_bench bench/asm_bench.cpp assembler.cpp peephole.cpp register_allocator.cpp cfg.cpp value_numbering.cpp constant_folding.cpp ssa.cpp sccp.cpp copy_propagation.cpp jump_optimization.cpp reassociation.cpp liveness.cpp dead_code.cpp loop_unswitching.cpp loop_unrolling.cpp licm.cpp induction.cpp copy_coalescing.cpp temp_recycling.cpp block_layout.cpp switch_lowering.cpp
+// 运行：
+//   ./asm_bench [--sizes 1000,10000,...] [--seeds N] [--raw] [--no-peephole]
+//   --raw 不做四元式优化，直接翻译合成程序
+//   --no-peephole 不做窥孔优化
+#include "asm_interpreter.h"
+#include "optimizer.h"
+#include "quad_interpreter.h"
+#include "synthetic_program.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+std::map<std::string, int16_t> randomInputs(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::map<std::string, int16_t> inputs;
+    for (char c = 'a'; c <= 'h'; c++) {
+        inputs[std::string(1, c)] = static_cast<int16_t>(rng() % 200) - 100;
+    }
+    return inputs;
+}
+
+// 与 main 中相同的优化顺序
+void optimize(std::vector<Quadruple>& quads) {
+    constant_folding(quads);
+    sparse_constant_propagation(quads);
+    optimize_jumps(quads);
+    reassociate_expressions(quads);
+    local_value_numbering(quads);
+    unswitch_loops(quads);
+    unroll_loops(quads);
+    hoist_loop_invariants(quads);
+    reduce_induction_variables(quads);
+    propagate_copies(quads);
+    eliminate_dead_code(quads);
+    coalesce_copies(quads);
+    recycle_temps(quads);
+    BlockProfile profile = profile_quads(quads);
+    layout_blocks(quads, profile.finished ? &profile : nullptr);
+    lower_switches(quads);
+}
+
+bool allOk = true;
+std::vector<int> ruleHits(default_peephole_rules().size(), 0);
+int labelsRemoved = 0;
+
+void runProgram(size_t size, unsigned seed, bool raw, bool peephole) {
+    std::vector<Quadruple> quads = SyntheticProgram(size, seed).build();
+    if (!raw) optimize(quads);
+    std::map<std::string, int16_t> inputs = randomInputs(seed);
+    QuadRun expected = runQuads(quads, inputs);
+
+    AsmStats stats;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> lines = assemble(quads, collect_vars(quads), &stats, peephole);
+    double time = millisecondsSince(start);
+    AsmRun actual = runAsm(lines, inputs);
+    bool same = actual.finished == expected.finished;
+    for (const auto& entry : expected.vars) {
+        // 优化后不再出现的变量不在数据段中，保持输入值
+        auto it = actual.vars.find(entry.first);
+        auto input = inputs.find(entry.first);
+        int16_t value = it != actual.vars.end() ? it->second : input != inputs.end() ? input->second : 0;
+        same = same && value == entry.second;
+    }
+    allOk = allOk && same;
+    for (size_t r = 0; r < stats.peephole.hits.size(); r++) ruleHits[r] += stats.peephole.hits[r];
+    labelsRemoved += stats.peephole.labels;
+    std::cout << std::setw(9) << size << std::setw(6) << seed << std::setw(9) << quads.size()
+        << std::fixed << std::setprecision(2) << std::setw(10) << time
+        << std::setw(8) << stats.intervals << std::setw(7) << stats.spilled << std::setw(7) << stats.spill_slots
+        << std::setw(9) << stats.instructions << std::setw(9) << stats.memory_operands
+        << std::setw(9) << stats.naive_memory << std::setw(10) << stats.cycles << std::setw(10) << stats.generic_cycles
+        << std::setw(7) << stats.peephole.instructions_before - stats.peephole.instructions_after
+        << std::setw(12) << expected.executed << std::setw(12) << actual.executed << std::setw(12) << actual.memory
+        << (same ? "  一致" : "  不一致!") << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = { 1000, 10000, 100000 };
+    int seeds = 3;
+    bool raw = false;
+    bool peephole = true;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoul(size));
+            }
+        }
+        else if (arg == "--seeds" && i + 1 < argc) {
+            seeds = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--raw") {
+            raw = true;
+        }
+        else if (arg == "--no-peephole") {
+            peephole = false;
+        }
+        else {
+            std::cerr << "用法: " << argv[0] << " [--sizes 1000,10000,...] [--seeds N] [--raw] [--no-peephole]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::setw(9) << "规模" << std::setw(6) << "种子" << std::setw(9) << "四元式"
+        << std::setw(10) << "耗时(ms)" << std::setw(8) << "区间" << std::setw(7) << "溢出" << std::setw(7) << "槽位"
+        << std::setw(9) << "指令" << std::setw(9) << "访存" << std::setw(9) << "全内存"
+        << std::setw(10) << "周期" << std::setw(10) << "通用周期" << std::setw(7) << "窥孔"
+        << std::setw(12) << "执行四元式" << std::setw(12) << "执行指令" << std::setw(12) << "执行访存" << std::endl;
+    for (size_t size : sizes) {
+        for (int seed = 1; seed <= seeds; seed++) {
+            runProgram(size, seed, raw, peephole);
+        }
+    }
+    std::cout << "窥孔规则命中：";
+    for (size_t r = 0; r < ruleHits.size(); r++) {
+        std::cout << " " << default_peephole_rules()[r].name << "=" << ruleHits[r];
+    }
+    std::cout << "，删除标号" << labelsRemoved << "个" << std::endl;
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+#pragma once
+#include <cctype>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 8086汇编解释器：执行 assemble 生成的程序（数据段只有 DW 字与跳转表，代码段只用到通用寄存器、
+// 数据段中的字、栈与经跳转表的 jmp word ptr T[r]），用于核对生成的汇编与四元式的执行结果一致，
+// 并统计实际执行的指令条数与访问内存（数据段与栈）的次数
+struct AsmRun {
+    std::map<std::string, int16_t> vars;  // 结束时数据段中各字的值
+    long long executed = 0;               // 执行的指令条数
+    long long memory = 0;                 // 其中访问内存的指令条数
+    bool finished = false;                // 是否在步数上限内执行到 ret
+};
+
+inline AsmRun runAsm(const std::vector<std::string>& lines,
+    const std::map<std::string, int16_t>& initial = {}, long long maxSteps = 100000000) {
+    // 运算对象：寄存器（0..5 为 AX..DI，6 为 DS）、数据段中的字或立即数
+    struct Arg {
+        enum Kind { NONE, REG, MEM, IMM } kind = NONE;
+        int index = 0;
+        int16_t value = 0;
+    };
+    struct Instruction {
+        std::string op;
+        Arg a, b;
+        std::string target;  // 转移指令的目标标号
+        int jump = -1;
+        int table = -1;      // 经跳转表的间接转移：表号与变址寄存器
+        int index = 0;
+    };
+
+    auto trim = [](std::string s) {
+        size_t begin = s.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return std::string();
+        size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    };
+    auto upper = [](std::string s) {
+        for (char& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        return s;
+    };
+
+    std::vector<std::string> words;
+    std::unordered_map<std::string, int> wordOf;
+    std::vector<Instruction> code;
+    std::unordered_map<std::string, int> labelAt;
+    std::vector<std::vector<std::string>> tableLabels;  // 各跳转表的表项标号
+    std::vector<std::vector<int>> tables;
+    std::unordered_map<std::string, int> tableOf;
+    static const char* registers[] = { "AX", "BX", "CX", "DX", "SI", "DI", "DS" };
+
+    auto decode = [&](const std::string& text) {
+        Arg arg;
+        std::string name = trim(text);
+        if (name.empty()) return arg;
+        std::string key = upper(name);
+        for (int r = 0; r < 7; r++) {
+            if (key == registers[r]) {
+                arg.kind = Arg::REG;
+                arg.index = r;
+                return arg;
+            }
+        }
+        auto it = wordOf.find(key);
+        if (it != wordOf.end()) {
+            arg.kind = Arg::MEM;
+            arg.index = it->second;
+            return arg;
+        }
+        arg.kind = Arg::IMM;
+        if (key == "DATA") return arg;  // 段地址，解释器中不用
+        if (key.back() == 'D') key.pop_back();
+        long value = std::stol(key);
+        arg.value = static_cast<int16_t>(value);
+        return arg;
+    };
+
+    bool inData = false, inCode = false;
+    for (const auto& raw : lines) {
+        std::string line = trim(raw.substr(0, raw.find(';')));
+        if (line.empty()) continue;
+        std::string key = upper(line);
+        if (key == "DATA SEGMENT") {
+            inData = true;
+            continue;
+        }
+        if (key == "DATA ENDS") {
+            inData = false;
+            continue;
+        }
+        if (inData) {
+            std::string name = line.substr(0, line.find(' '));
+            std::string value = trim(line.substr(key.find(" DW ") + 4));
+            if (value != "?") {
+                // 跳转表：DW 之后是逗号分隔的标号
+                tableOf[upper(name)] = static_cast<int>(tableLabels.size());
+                tableLabels.emplace_back();
+                std::stringstream ss(value);
+                std::string label;
+                while (std::getline(ss, label, ',')) tableLabels.back().push_back(trim(label));
+                continue;
+            }
+            wordOf[upper(name)] = static_cast<int>(words.size());
+            words.push_back(name);
+            continue;
+        }
+        if (key == "START:") {
+            inCode = true;
+            continue;
+        }
+        if (!inCode || key == "MAIN ENDP" || key == "CODE ENDS" || key.compare(0, 3, "END") == 0) continue;
+        if (line.back() == ':') {
+            labelAt[line.substr(0, line.size() - 1)] = static_cast<int>(code.size());
+            continue;
+        }
+        Instruction instruction;
+        size_t space = line.find(' ');
+        instruction.op = upper(line.substr(0, space));
+        std::string rest = space == std::string::npos ? "" : trim(line.substr(space + 1));
+        size_t bracket = rest.find('[');
+        if (instruction.op == "JMP" && bracket != std::string::npos) {
+            size_t name = rest.find_last_of(' ', bracket) + 1;
+            auto table = tableOf.find(upper(rest.substr(name, bracket - name)));
+            if (table == tableOf.end()) throw std::runtime_error("未定义的跳转表：" + rest);
+            instruction.table = table->second;
+            instruction.index = decode(rest.substr(bracket + 1, rest.find(']') - bracket - 1)).index;
+        }
+        else if (instruction.op[0] == 'J') {
+            instruction.target = rest;
+        }
+        else {
+            size_t comma = rest.find(',');
+            instruction.a = decode(rest.substr(0, comma));
+            if (comma != std::string::npos) instruction.b = decode(rest.substr(comma + 1));
+        }
+        code.push_back(instruction);
+    }
+    for (auto& instruction : code) {
+        if (instruction.target.empty()) continue;
+        auto it = labelAt.find(instruction.target);
+        if (it == labelAt.end()) throw std::runtime_error("未定义的标号：" + instruction.target);
+        instruction.jump = it->second;
+    }
+    for (const auto& labels : tableLabels) {
+        tables.emplace_back();
+        for (const auto& label : labels) {
+            auto it = labelAt.find(label);
+            if (it == labelAt.end()) throw std::runtime_error("未定义的标号：" + label);
+            tables.back().push_back(it->second);
+        }
+    }
+
+    int16_t reg[7] = { 0 };
+    std::vector<int16_t> memory(words.size(), 0);
+    for (size_t w = 0; w < words.size(); w++) {
+        auto it = initial.find(words[w]);
+        if (it != initial.end()) memory[w] = it->second;
+    }
+    std::vector<int16_t> stack;
+    int16_t flagA = 0, flagB = 0;  // 最近一次比较（或运算结果与0比较）的两个值
+
+    AsmRun run;
+    auto get = [&](const Arg& arg) -> int16_t {
+        if (arg.kind == Arg::REG) return reg[arg.index];
+        if (arg.kind == Arg::MEM) return memory[arg.index];
+        return arg.value;
+    };
+    auto set = [&](const Arg& arg, int16_t value) {
+        if (arg.kind == Arg::REG) reg[arg.index] = value;
+        else if (arg.kind == Arg::MEM) memory[arg.index] = value;
+        else throw std::runtime_error("不能写入立即数");
+    };
+    auto result = [&](const Arg& arg, int value) {
+        int16_t r = static_cast<int16_t>(value);
+        set(arg, r);
+        flagA = r;
+        flagB = 0;
+    };
+
+    int pc = 0;
+    int n = static_cast<int>(code.size());
+    while (pc < n && run.executed < maxSteps) {
+        const Instruction& in = code[pc++];
+        run.executed++;
+        if (in.a.kind == Arg::MEM || in.b.kind == Arg::MEM || in.op == "PUSH" || in.op == "POP" || in.table >= 0) {
+            run.memory++;
+        }
+        const std::string& op = in.op;
+        if (op == "MOV") set(in.a, get(in.b));
+        else if (op == "ADD") result(in.a, get(in.a) + get(in.b));
+        else if (op == "SUB") result(in.a, get(in.a) - get(in.b));
+        else if (op == "XOR") result(in.a, get(in.a) ^ get(in.b));
+        else if (op == "TEST") {
+            flagA = static_cast<int16_t>(get(in.a) & get(in.b));
+            flagB = 0;
+        }
+        else if (op == "NEG") result(in.a, -get(in.a));
+        else if (op == "INC") result(in.a, get(in.a) + 1);
+        else if (op == "DEC") result(in.a, get(in.a) - 1);
+        else if (op == "SHL" || op == "SAL") result(in.a, get(in.a) << (get(in.b) & 15));
+        else if (op == "CMP") {
+            flagA = get(in.a);
+            flagB = get(in.b);
+        }
+        else if (op == "IMUL") {
+            int32_t product = static_cast<int32_t>(reg[0]) * get(in.a);
+            reg[0] = static_cast<int16_t>(product);
+            reg[3] = static_cast<int16_t>(product >> 16);
+        }
+        else if (op == "CWD") reg[3] = reg[0] < 0 ? -1 : 0;
+        else if (op == "IDIV") {
+            int32_t dividend = static_cast<int32_t>((static_cast<uint32_t>(static_cast<uint16_t>(reg[3])) << 16) |
+                static_cast<uint16_t>(reg[0]));
+            int32_t divisor = get(in.a);
+            if (divisor == 0 || dividend / divisor > 32767 || dividend / divisor < -32768) {
+                throw std::runtime_error("除法溢出");
+            }
+            reg[0] = static_cast<int16_t>(dividend / divisor);
+            reg[3] = static_cast<int16_t>(dividend % divisor);
+        }
+        else if (op == "PUSH") stack.push_back(get(in.a));
+        else if (op == "POP") {
+            if (stack.empty()) throw std::runtime_error("栈为空");
+            set(in.a, stack.back());
+            stack.pop_back();
+        }
+        else if (op == "RET") {
+            run.finished = true;
+            break;
+        }
+        else if (in.table >= 0) {
+            uint16_t offset = static_cast<uint16_t>(reg[in.index]);
+            const std::vector<int>& table = tables[in.table];
+            if (offset % 2 || offset / 2 >= table.size()) throw std::runtime_error("跳转表下标越界");
+            pc = table[offset / 2];
+        }
+        else if (op[0] == 'J') {
+            bool taken = op == "JMP" || (op == "JE" && flagA == flagB) || (op == "JNE" && flagA != flagB) ||
+                (op == "JL" && flagA < flagB) || (op == "JLE" && flagA <= flagB) ||
+                (op == "JG" && flagA > flagB) || (op == "JGE" && flagA >= flagB);
+            if (taken) pc = in.jump;
+        }
+        else {
+            throw std::runtime_error("解释器不支持的指令：" + op);
+        }
+    }
+    for (size_t w = 0; w < words.size(); w++) {
+        run.vars[words[w]] = memory[w];
+    }
+    return run;
+}
@@ -0,0 +1,226 @@
+// 语法树代码生成基准测试
+// 随机生成含深层嵌套表达式、if 与计数 while 循环的源程序，经词法、语法分析后比较两条代码生成路径：
+// 语法分析器逐个运算生成的四元式（未优化）经寄存器分配翻译成汇编，与 CodeGenerator 由语法树
+// 按 Sethi-Ullman 次序直接生成的四元式与汇编。统计临时变量个数、指令条数、寄存器与溢出次数，
+// 并用四元式解释器与汇编解释器核对三者执行后各变量的值一致。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -I. -o codegen_bench bench/codegen_bench.cpp code_generator.cpp parser.cpp lexer.cpp assembler.cpp peephole.cpp register_allocator.cpp cfg.cpp liveness.cpp
+// 运行：
+//   ./codegen_bench [--statements 20,200,...] [--depth N] [--seeds N]
+#include "asm_interpreter.h"
+#include "code_generator.h"
+#include "parser.h"
+#include "quad_interpreter.h"
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 随机源程序：变量 a..h 参与运算，循环计数器 i0、i1… 只在自己的循环中递增
+class SourceProgram {
+public:
+    SourceProgram(size_t statements, int depth, unsigned seed) : statements(statements), depth(depth), rng(seed) {}
+
+    std::string build() {
+        std::ostringstream out;
+        out << "begin\n";
+        for (size_t i = 0; i < statements; i++) {
+            statement(out, 1, true);
+            out << ";\n";
+        }
+        out << "a:=a\nend\n#\n~\n";
+        return out.str();
+    }
+
+private:
+    size_t statements;
+    int depth;
+    std::mt19937 rng;
+    int counters = 0;
+
+    int pick(int n) { return static_cast<int>(rng() % n); }
+
+    std::string variable() { return std::string(1, static_cast<char>('a' + pick(8))); }
+
+    void expression(std::ostream& out, int level) {
+        if (level <= 0 || pick(4) == 0) {
+            if (pick(3) == 0) out << pick(20);
+            else out << variable();
+            return;
+        }
+        out << "(";
+        expression(out, level - 1);
+        out << (pick(2) ? "+" : "*");
+        expression(out, level - 1);
+        out << ")";
+    }
+
+    // inList 为真时语句在复合语句的语句序列中，循环的初始化与 while 可以直接并列；
+    // 否则（then、else 部分）要用 begin…end 包起来
+    void statement(std::ostream& out, int nesting, bool inList) {
+        int kind = nesting > 2 ? 0 : pick(6);
+        if (kind <= 3) {
+            out << variable() << ":=";
+            expression(out, depth);
+        }
+        else if (kind == 4) {
+            out << "if ";
+            expression(out, depth / 2);
+            static const char* relops[] = { "<", "<=", ">", ">=", "=" };
+            out << relops[pick(5)];
+            expression(out, depth / 2);
+            out << " then ";
+            statement(out, nesting + 1, false);
+            if (pick(2)) {
+                out << " else ";
+                statement(out, nesting + 1, false);
+            }
+        }
+        else {
+            std::string counter = "i" + std::to_string(counters++);
+            if (!inList) out << "begin ";
+            out << counter << ":=0; while " << counter << "<" << 1 + pick(4) << " do begin ";
+            statement(out, nesting + 1, true);
+            out << "; " << counter << ":=" << counter << "+1 end";
+            if (!inList) out << " end";
+        }
+    }
+};
+
+std::vector<Quadruple> toQuadruples(const std::vector<std::string>& lines) {
+    std::vector<Quadruple> quads;
+    for (const auto& line : lines) {
+        std::string content = line.substr(line.find('(') + 1);
+        content = content.substr(0, content.rfind(')'));
+        std::vector<std::string> parts;
+        std::stringstream ss(content);
+        std::string part;
+        while (std::getline(ss, part, ',')) {
+            part.erase(0, part.find_first_not_of(' '));
+            part.erase(part.find_last_not_of(' ') + 1);
+            parts.push_back(part);
+        }
+        while (parts.size() < 4) parts.push_back("");
+        quads.push_back(Quadruple{ std::stoi(line.substr(0, line.find(' '))), parts[0], parts[1], parts[2], parts[3] });
+    }
+    return quads;
+}
+
+size_t countTemps(const std::vector<Quadruple>& quads) {
+    std::set<std::string> temps;
+    for (const auto& quad : quads) {
+        if (is_temp(quad.result)) temps.insert(quad.result);
+    }
+    return temps.size();
+}
+
+std::map<std::string, int16_t> randomInputs(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::map<std::string, int16_t> inputs;
+    for (char c = 'a'; c <= 'h'; c++) {
+        inputs[std::string(1, c)] = static_cast<int16_t>(rng() % 200) - 100;
+    }
+    return inputs;
+}
+
+// 变量在 actual 中时值应与 expected 相同
+bool sameVariables(const std::map<std::string, int16_t>& expected, const std::map<std::string, int16_t>& actual) {
+    for (const auto& entry : expected) {
+        auto it = actual.find(entry.first);
+        if (it != actual.end() && it->second != entry.second) return false;
+    }
+    return true;
+}
+
+bool allOk = true;
+
+void runProgram(size_t statements, int depth, unsigned seed) {
+    std::string source = SourceProgram(statements, depth, seed).build();
+
+    // 词法、语法分析的过程输出很多，运行时关掉标准输出
+    std::ostringstream discard;
+    std::streambuf* saved = std::cout.rdbuf(discard.rdbuf());
+    Lexer lexer;
+    Parser parser;
+    bool parsed = parser.parse(lexer.tokenize(source));
+    std::cout.rdbuf(saved);
+    if (!parsed) {
+        std::cout << std::setw(8) << statements << std::setw(6) << seed << "  语法分析失败!" << std::endl;
+        allOk = false;
+        return;
+    }
+
+    std::vector<Quadruple> parserQuads = toQuadruples(parser.getQuadruples());
+    AsmStats stats;
+    std::vector<std::string> quadAsm = assemble(parserQuads, collect_vars(parserQuads), &stats);
+    CodeGenerator generator;
+    std::vector<Quadruple> treeQuads = toQuadruples(generator.generateQuadruples(parser.getAST()));
+    std::vector<std::string> treeAsm = generator.generateAssembly(parser.getAST());
+
+    std::map<std::string, int16_t> inputs = randomInputs(seed);
+    QuadRun expected = runQuads(parserQuads, inputs);
+    QuadRun tree = runQuads(treeQuads, inputs);
+    AsmRun quadRun = runAsm(quadAsm, inputs);
+    AsmRun treeRun = runAsm(treeAsm, inputs);
+    bool same = expected.finished && tree.finished && quadRun.finished && treeRun.finished &&
+        sameVariables(expected.vars, tree.vars) && sameVariables(expected.vars, quadRun.vars) &&
+        sameVariables(expected.vars, treeRun.vars);
+    allOk = allOk && same;
+
+    std::cout << std::setw(8) << statements << std::setw(6) << seed
+        << std::setw(9) << parserQuads.size() << std::setw(9) << treeQuads.size()
+        << std::setw(8) << countTemps(parserQuads) << std::setw(8) << generator.getTempCount()
+        << std::setw(9) << stats.instructions << std::setw(9) << generator.getInstructionCount()
+        << std::setw(12) << quadRun.executed << std::setw(12) << treeRun.executed
+        << std::setw(7) << generator.getRegisterCount() << std::setw(7) << generator.getSpillCount()
+        << (same ? "  一致" : "  不一致!") << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = { 20, 200, 2000 };
+    int depth = 6;
+    int seeds = 3;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--statements" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoul(size));
+            }
+        }
+        else if (arg == "--depth" && i + 1 < argc) {
+            depth = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--seeds" && i + 1 < argc) {
+            seeds = std::max(1, std::stoi(argv[++i]));
+        }
+        else {
+            std::cerr << "用法: " << argv[0] << " [--statements 20,200,...] [--depth N] [--seeds N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "表达式深度 " << depth << "；四元式路径为语法分析器的四元式经寄存器分配翻译，未做优化" << std::endl;
+    std::cout << std::setw(8) << "语句" << std::setw(6) << "种子"
+        << std::setw(9) << "四元式" << std::setw(9) << "树四元式"
+        << std::setw(8) << "临时" << std::setw(8) << "树临时"
+        << std::setw(9) << "指令" << std::setw(9) << "树指令"
+        << std::setw(12) << "执行指令" << std::setw(12) << "树执行指令"
+        << std::setw(7) << "寄存器" << std::setw(7) << "溢出" << std::endl;
+    for (size_t size : sizes) {
+        for (int seed = 1; seed <= seeds; seed++) {
+            runProgram(size, depth, seed);
+        }
+    }
+    return allOk ? 0 : 1;
+}
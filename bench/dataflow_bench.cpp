@@ -0,0 +1,166 @@
+// 数据流求解器基准测试
+// 在不同规模的合成程序上求解活跃变量（后向、并集）与必定赋值（前向、交集）两个问题，
+// 统计求解耗时、求解器每秒处理的块数与每块的传递函数调用次数；活跃变量另用按块号轮转迭代的
+// 朴素求解器核对结果，并比较两者的传递函数调用次数。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -I. -o dataflow_bench bench/dataflow_bench.cpp cfg.cpp assembler.cpp peephole.cpp register_allocator.cpp liveness.cpp
+// 运行：
+//   ./dataflow_bench [--sizes 400000,1000000,...]
+#include "dataflow.h"
+#include "synthetic_program.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// 与 compute_liveness 相同的活跃变量问题，用于单独测量求解器
+struct LiveProblem {
+    using Value = BitVector;
+    static constexpr bool forward = false;
+
+    const Liveness& live;
+    BitVector exitLive;
+
+    Value top() const { return BitVector(live.names.size()); }
+    Value boundary() const { return exitLive; }
+    bool meet(Value& into, const Value& from) const { return into.unite(from); }
+    void transfer(int block, const Value& out, Value& in) const {
+        in.transfer(live.use[block], out, live.def[block]);
+    }
+};
+
+// 必定赋值：前向问题，交汇为交集，out = in ∪ def
+struct AssignedProblem {
+    using Value = BitVector;
+    static constexpr bool forward = true;
+
+    const Liveness& live;
+
+    Value top() const {
+        Value all(live.names.size());
+        for (size_t i = 0; i < live.names.size(); i++) all.set(i);
+        return all;
+    }
+    Value boundary() const { return BitVector(live.names.size()); }
+    bool meet(Value& into, const Value& from) const { return into.intersect(from); }
+    void transfer(int block, const Value& in, Value& out) const {
+        out = in;
+        out.unite(live.def[block]);
+    }
+};
+
+// 朴素求解：按块号反复扫描全部块直到不再变化
+long long roundRobinLiveness(const CFG& cfg, const Liveness& live, std::vector<BitVector>& in) {
+    size_t bits = live.names.size();
+    BitVector exitLive(bits);
+    for (size_t i = 0; i < bits; i++) {
+        if (!is_temp(live.names[i])) exitLive.set(i);
+    }
+    std::vector<char> isExit(cfg.num_blocks(), 0);
+    for (int b : cfg.exits) isExit[b] = 1;
+    in.assign(cfg.num_blocks(), BitVector(bits));
+    long long visits = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int b = cfg.num_blocks() - 1; b >= 0; b--) {
+            if (!cfg.reachable(b)) continue;
+            BitVector out = isExit[b] ? exitLive : BitVector(bits);
+            for (int s = cfg.succ_begin(b); s < cfg.succ_end(b); s++) out.unite(in[cfg.succ[s]]);
+            BitVector next(bits);
+            next.transfer(live.use[b], out, live.def[b]);
+            visits++;
+            if (next != in[b]) {
+                in[b] = std::move(next);
+                changed = true;
+            }
+        }
+    }
+    return visits;
+}
+
+bool allOk = true;
+
+void runSize(size_t size) {
+    std::vector<Quadruple> quads = SyntheticProgram(size).build();
+    CFG cfg = build_cfg(quads);
+    compute_dominators(cfg);
+    size_t blocks = cfg.rpo.size();
+
+    auto start = std::chrono::steady_clock::now();
+    Liveness live = compute_liveness(quads, cfg);
+    double liveTime = millisecondsSince(start);
+
+    LiveProblem liveProblem{ live, BitVector(live.names.size()) };
+    for (size_t i = 0; i < live.names.size(); i++) {
+        if (!is_temp(live.names[i])) liveProblem.exitLive.set(i);
+    }
+    start = std::chrono::steady_clock::now();
+    DataflowResult<BitVector> solved = solve_dataflow(cfg, liveProblem);
+    double solveTime = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    DataflowResult<BitVector> assigned = solve_dataflow(cfg, AssignedProblem{ live });
+    double assignedTime = millisecondsSince(start);
+
+    std::vector<BitVector> naiveIn;
+    start = std::chrono::steady_clock::now();
+    long long naiveVisits = roundRobinLiveness(cfg, live, naiveIn);
+    double naiveTime = millisecondsSince(start);
+    bool same = true;
+    for (int b : cfg.rpo) same = same && naiveIn[b] == live.live_in[b] && solved.in[b] == live.live_in[b];
+    allOk = allOk && same;
+
+    std::cout << std::setw(9) << quads.size() << std::setw(9) << blocks
+        << std::setw(6) << live.names.size() << std::fixed << std::setprecision(2)
+        << std::setw(10) << liveTime << std::setw(10) << solveTime
+        << std::setw(10) << blocks / solveTime / 1000
+        << std::setw(8) << static_cast<double>(live.visits) / blocks
+        << std::setw(10) << assignedTime
+        << std::setw(8) << static_cast<double>(assigned.visits) / blocks
+        << std::setw(10) << naiveTime
+        << std::setw(8) << static_cast<double>(naiveVisits) / blocks
+        << (same ? "  一致" : "  不一致!") << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = { 400000, 1000000, 4000000 };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoul(size));
+            }
+        }
+        else {
+            std::cerr << "用法: " << argv[0] << " [--sizes 400000,1000000,...]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::setw(9) << "四元式" << std::setw(9) << "块" << std::setw(6) << "名字"
+        << std::setw(10) << "活跃(ms)" << std::setw(10) << "求解(ms)" << std::setw(10) << "M块/秒"
+        << std::setw(8) << "次/块"
+        << std::setw(10) << "赋值(ms)" << std::setw(8) << "次/块"
+        << std::setw(10) << "轮转(ms)" << std::setw(8) << "次/块" << std::endl;
+    std::cout << "（活跃：完整的活跃变量分析，含建立名字表与 use/def 集合；求解：只计求解器）" << std::endl;
+    for (size_t size : sizes) {
+        runSize(size);
+    }
+    return allOk ? 0 : 1;
+}
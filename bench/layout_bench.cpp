@@ -0,0 +1,147 @@
+// 基本块布局基准测试
+// 对不同规模、不同随机种子的合成程序运行全部优化遍后，分别按静态估计、按另一组输入的执行剖面
+// 与按同一组输入的执行剖面重排基本块，用同一组输入执行，统计执行的四元式条数与转移次数
+// （成立的条件跳转与无条件跳转），并用解释器核对各变量的最终值与重排前一致。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -I. -o layout_bench bench/layout_bench.cpp cfg.cpp assembler.cpp peephole.cpp register_allocator.cpp value_numbering.cpp constant_folding.cpp ssa.cpp sccp.cpp copy_propagation.cpp jump_optimization.cpp reassociation.cpp liveness.cpp dead_code.cpp loop_unswitching.cpp loop_unrolling.cpp licm.cpp induction.cpp copy_coalescing.cpp temp_recycling.cpp block_layout.cpp
+// 运行：
+//   ./layout_bench [--sizes 1000,10000,...] [--seeds N] [--raw]
+//   --raw 不做其他优化，直接重排合成程序
+#include "optimizer.h"
+#include "quad_interpreter.h"
+#include "synthetic_program.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+std::map<std::string, int16_t> randomInputs(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::map<std::string, int16_t> inputs;
+    for (char c = 'a'; c <= 'h'; c++) {
+        inputs[std::string(1, c)] = static_cast<int16_t>(rng() % 200) - 100;
+    }
+    return inputs;
+}
+
+// 与 main 中相同的优化顺序（不含布局）
+void optimize(std::vector<Quadruple>& quads) {
+    constant_folding(quads);
+    sparse_constant_propagation(quads);
+    optimize_jumps(quads);
+    reassociate_expressions(quads);
+    local_value_numbering(quads);
+    unswitch_loops(quads);
+    unroll_loops(quads);
+    hoist_loop_invariants(quads);
+    reduce_induction_variables(quads);
+    propagate_copies(quads);
+    eliminate_dead_code(quads);
+    coalesce_copies(quads);
+    recycle_temps(quads);
+}
+
+bool allOk = true;
+
+// 按 inputs 执行 quads：返回转移次数，executed 为执行的四元式条数，结果与 expected 不同时记为不一致
+long long measure(const std::vector<Quadruple>& quads, const std::map<std::string, int16_t>& inputs,
+    const QuadRun& expected, long long& executed, bool& same) {
+    BlockProfile profile = profile_quads(quads, inputs);
+    executed = std::accumulate(profile.executed.begin(), profile.executed.end(), 0LL);
+    QuadRun run = runQuads(quads, inputs);
+    same = same && run.finished == expected.finished && run.vars == expected.vars;
+    return std::accumulate(profile.taken.begin(), profile.taken.end(), 0LL);
+}
+
+void runProgram(size_t size, unsigned seed, bool raw) {
+    std::vector<Quadruple> quads = SyntheticProgram(size, seed).build();
+    if (!raw) optimize(quads);
+    std::map<std::string, int16_t> inputs = randomInputs(seed);
+    std::map<std::string, int16_t> training = randomInputs(seed + 1000);
+    QuadRun expected = runQuads(quads, inputs);
+
+    bool same = true;
+    long long executed = 0, staticExecuted = 0, trainedExecuted = 0, selfExecuted = 0;
+    long long taken = measure(quads, inputs, expected, executed, same);
+
+    std::vector<Quadruple> staticLayout = quads;
+    auto start = std::chrono::steady_clock::now();
+    LayoutStats stats = layout_blocks(staticLayout);
+    double time = millisecondsSince(start);
+    long long staticTaken = measure(staticLayout, inputs, expected, staticExecuted, same);
+
+    std::vector<Quadruple> trainedLayout = quads;
+    BlockProfile trainingProfile = profile_quads(quads, training);
+    LayoutStats trained = layout_blocks(trainedLayout, &trainingProfile);
+    long long trainedTaken = measure(trainedLayout, inputs, expected, trainedExecuted, same);
+
+    std::vector<Quadruple> selfLayout = quads;
+    BlockProfile profile = profile_quads(quads, inputs);
+    LayoutStats self = layout_blocks(selfLayout, &profile);
+    long long selfTaken = measure(selfLayout, inputs, expected, selfExecuted, same);
+    allOk = allOk && same;
+
+    std::cout << std::setw(9) << size << std::setw(6) << seed << std::setw(9) << quads.size()
+        << std::fixed << std::setprecision(2) << std::setw(10) << time
+        << std::setw(7) << stats.moved << std::setw(7) << trained.moved << std::setw(7) << self.cold
+        << std::setw(11) << executed << std::setw(11) << taken
+        << std::setw(11) << staticExecuted << std::setw(11) << staticTaken
+        << std::setw(11) << trainedExecuted << std::setw(11) << trainedTaken
+        << std::setw(11) << selfExecuted << std::setw(11) << selfTaken
+        << (same ? "  一致" : "  不一致!") << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = { 1000, 10000, 100000 };
+    int seeds = 3;
+    bool raw = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoul(size));
+            }
+        }
+        else if (arg == "--seeds" && i + 1 < argc) {
+            seeds = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--raw") {
+            raw = true;
+        }
+        else {
+            std::cerr << "用法: " << argv[0] << " [--sizes 1000,10000,...] [--seeds N] [--raw]" << std::endl;
+            return 1;
+        }
+    }
+
+    // 静态：静态估计；训练：另一组输入的剖面；自身：同一组输入的剖面
+    std::cout << std::setw(9) << "规模" << std::setw(6) << "种子" << std::setw(9) << "四元式"
+        << std::setw(10) << "耗时(ms)" << std::setw(7) << "静移动" << std::setw(7) << "训移动" << std::setw(7) << "冷块"
+        << std::setw(11) << "执行" << std::setw(11) << "转移"
+        << std::setw(11) << "静态执行" << std::setw(11) << "静态转移"
+        << std::setw(11) << "训练执行" << std::setw(11) << "训练转移"
+        << std::setw(11) << "自身执行" << std::setw(11) << "自身转移" << std::endl;
+    for (size_t size : sizes) {
+        for (int seed = 1; seed <= seeds; seed++) {
+            runProgram(size, seed, raw);
+        }
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+// 四元式优化遍基准测试
+// 对不同规模、不同随机种子的合成程序依次运行各优化遍，统计每遍的耗时、四元式数变化、
+// 解释执行的四元式条数与其中乘除运算条数的变化，并用解释器核对优化前后各变量的最终值一致。
+// 各遍由遍管理器运行（耗时含补算分析），多线程时另用单线程重跑一遍，核对结果逐位相同。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -I. -o opt_bench bench/opt_bench.cpp cfg.cpp assembler.cpp peephole.cpp register_allocator.cpp value_numbering.cpp constant_folding.cpp ssa.cpp sccp.cpp copy_propagation.cpp jump_optimization.cpp reassociation.cpp liveness.cpp dead_code.cpp loop_unswitching.cpp loop_unrolling.cpp licm.cpp induction.cpp copy_coalescing.cpp temp_recycling.cpp block_layout.cpp switch_lowering.cpp pass_manager.cpp -pthread
+// 运行：
+//   ./opt_bench [--sizes 1000,10000,...] [--seeds N] [--threads N] [--passes fold,sccp,jumps,reassoc,lvn,unswitch,unroll,licm,iv,copyprop,dce,copies,temps,layout,switch,...]
+#include "optimizer.h"
+#include "pass_manager.h"
+#include "quad_interpreter.h"
+#include "synthetic_program.h"
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Pass {
+    std::string name;
+    std::function<int(std::vector<Quadruple>&)> run;  // 整体遍，返回该遍报告的改动数
+    PassManager::BlockPass block = nullptr;           // 块内遍
+    unsigned preserves = 0;
+};
+
+const std::vector<Pass>& allPasses() {
+    static const std::vector<Pass> passes = {
+        { "fold", [](std::vector<Quadruple>& quads) {
+            FoldStats stats = constant_folding(quads);
+            return stats.folded + stats.simplified + stats.jumps;
+        } },
+        { "sccp", [](std::vector<Quadruple>& quads) {
+            SCCPStats stats = sparse_constant_propagation(quads);
+            return stats.constants + stats.jumps;
+        } },
+        { "jumps", [](std::vector<Quadruple>& quads) {
+            JumpStats stats = optimize_jumps(quads);
+            return stats.threaded + stats.inverted + stats.to_next + stats.unreachable;
+        } },
+        { "reassoc", [](std::vector<Quadruple>& quads) {
+            ReassocStats stats = reassociate_expressions(quads);
+            return stats.chains;
+        } },
+        { "lvn", nullptr, [](BlockWork& work, const Analyses& analyses) {
+            number_values_in_block(work, analyses.names());
+        } },
+        { "unswitch", [](std::vector<Quadruple>& quads) {
+            UnswitchStats stats = unswitch_loops(quads);
+            return stats.unswitched;
+        } },
+        { "unroll", [](std::vector<Quadruple>& quads) {
+            UnrollStats stats = unroll_loops(quads);
+            return stats.full + stats.partial;
+        } },
+        { "licm", [](std::vector<Quadruple>& quads) {
+            LICMStats stats = hoist_loop_invariants(quads);
+            return stats.hoisted + stats.rewritten;
+        } },
+        { "iv", [](std::vector<Quadruple>& quads) {
+            IVStats stats = reduce_induction_variables(quads);
+            return stats.reduced + stats.replaced + stats.removed;
+        } },
+        { "copyprop", [](std::vector<Quadruple>& quads) {
+            CopyPropStats stats = propagate_copies(quads);
+            return stats.copies + stats.phis;
+        } },
+        { "dce", [](std::vector<Quadruple>& quads) {
+            return eliminate_dead_code(quads).removed;
+        } },
+        { "copies", nullptr, [](BlockWork& work, const Analyses& analyses) {
+            coalesce_copies_in_block(work, analyses.names());
+        } },
+        { "temps", [](std::vector<Quadruple>& quads) {
+            TempStats stats = recycle_temps(quads);
+            return stats.before - stats.after;
+        }, nullptr, ANALYSIS_CFG | ANALYSIS_LOOPS },
+        { "layout", [](std::vector<Quadruple>& quads) {
+            BlockProfile profile = profile_quads(quads);
+            LayoutStats stats = layout_blocks(quads, profile.finished ? &profile : nullptr);
+            return stats.moved + stats.inverted + stats.removed + stats.added;
+        } },
+        { "switch", [](std::vector<Quadruple>& quads) {
+            return lower_switches(quads).chains;
+        } },
+    };
+    return passes;
+}
+
+std::map<std::string, int16_t> randomInputs(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::map<std::string, int16_t> inputs;
+    for (char c = 'a'; c <= 'h'; c++) {
+        inputs[std::string(1, c)] = static_cast<int16_t>(rng() % 200) - 100;
+    }
+    return inputs;
+}
+
+void addPasses(PassManager& manager, const std::vector<Pass>& passes) {
+    for (const auto& pass : passes) {
+        if (pass.block) {
+            manager.add_block_pass(pass.name, pass.block, ANALYSIS_NAMES);
+        }
+        else {
+            auto run = pass.run;
+            manager.add_pass(pass.name, [run](std::vector<Quadruple>& quads, const Analyses&) { return run(quads); },
+                0, pass.preserves);
+        }
+    }
+}
+
+bool allOk = true;
+
+void runProgram(size_t size, unsigned seed, const std::vector<Pass>& passes, unsigned threads) {
+    const std::vector<Quadruple> original = SyntheticProgram(size, seed).build();
+    std::map<std::string, int16_t> inputs = randomInputs(seed);
+    QuadRun before = runQuads(original, inputs);
+
+    PassManager manager(threads);
+    addPasses(manager, passes);
+    manager.set_observer([&](const PassReport& report, const std::vector<Quadruple>& quads) {
+        QuadRun after = runQuads(quads, inputs);
+        bool same = after.finished == before.finished && after.vars == before.vars;
+        allOk = allOk && same;
+        std::cout << std::setw(9) << size << std::setw(6) << seed << "  " << std::left
+            << std::setw(8) << report.name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(10) << report.analysis_ms + report.ms << std::setw(9) << report.changes
+            << std::setw(9) << report.before << std::setw(9) << report.after
+            << std::setw(12) << before.executed << std::setw(12) << after.executed
+            << std::setw(10) << before.multiplies << std::setw(10) << after.multiplies
+            << (same ? "  一致" : "  不一致!") << std::endl;
+        before.executed = after.executed;
+        before.multiplies = after.multiplies;
+    });
+    std::vector<Quadruple> quads = original;
+    manager.run(quads);
+
+    if (manager.threads() > 1) {
+        PassManager serial(1);
+        addPasses(serial, passes);
+        std::vector<Quadruple> expected = original;
+        serial.run(expected);
+        bool same = expected.size() == quads.size();
+        for (size_t i = 0; same && i < quads.size(); i++) {
+            same = expected[i].label == quads[i].label && expected[i].op == quads[i].op &&
+                expected[i].arg1 == quads[i].arg1 && expected[i].arg2 == quads[i].arg2 &&
+                expected[i].result == quads[i].result;
+        }
+        allOk = allOk && same;
+        std::cout << std::setw(9) << size << std::setw(6) << seed << "  " << manager.threads()
+            << "个线程与单线程的结果" << (same ? "逐位一致" : "不一致!") << std::endl;
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = { 1000, 10000, 100000 };
+    int seeds = 3;
+    unsigned threads = 0;
+    std::vector<Pass> passes = allPasses();
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoul(size));
+            }
+        }
+        else if (arg == "--seeds" && i + 1 < argc) {
+            seeds = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--passes" && i + 1 < argc) {
+            passes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string name;
+            while (std::getline(ss, name, ',')) {
+                for (const auto& pass : allPasses()) {
+                    if (pass.name == name) passes.push_back(pass);
+                }
+            }
+        }
+        else {
+            std::cerr << "用法: " << argv[0]
+                << " [--sizes 1000,10000,...] [--seeds N] [--threads N] [--passes fold,sccp,jumps,reassoc,lvn,unswitch,unroll,licm,iv,copyprop,dce,copies,temps,layout,switch,...]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::setw(9) << "四元式" << std::setw(6) << "种子" << "  " << std::left
+        << std::setw(8) << "遍" << std::right << std::setw(10) << "耗时(ms)" << std::setw(9) << "改动"
+        << std::setw(9) << "优化前" << std::setw(9) << "优化后"
+        << std::setw(12) << "执行前" << std::setw(12) << "执行后"
+        << std::setw(10) << "乘除前" << std::setw(10) << "乘除后" << std::endl;
+    for (size_t size : sizes) {
+        for (int seed = 1; seed <= seeds; seed++) {
+            runProgram(size, seed, passes, threads);
+        }
+    }
+    return allOk ? 0 : 1;
+}
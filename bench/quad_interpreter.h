@@ -0,0 +1,99 @@
+#pragma once
+#include "assembler.h"
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 四元式解释器：按8086的16位有符号整数语义执行四元式序列，
+// 用于核对优化前后程序的结果一致，并统计实际执行的四元式条数
+struct QuadRun {
+    std::map<std::string, int16_t> vars;  // 结束时各普通变量的值（不含临时变量）
+    long long executed = 0;               // 执行的四元式条数
+    long long multiplies = 0;             // 其中乘除运算的条数（8086上 mul/div 比加减慢一个数量级）
+    bool finished = false;                // 是否在步数上限内跳出程序
+};
+
+inline QuadRun runQuads(const std::vector<Quadruple>& quads,
+    const std::map<std::string, int16_t>& initial = {}, long long maxSteps = 100000000) {
+    QuadRun run;
+    if (quads.empty()) {
+        run.vars = initial;
+        run.finished = true;
+        return run;
+    }
+    int base = quads[0].label;
+    int n = static_cast<int>(quads.size());
+
+    // 预先把名字解析为槽位，常数放在只读槽位中
+    std::unordered_map<std::string, int> slotOf;
+    std::vector<int16_t> slots;
+    std::vector<std::string> names;
+    auto slot = [&](const std::string& name) {
+        if (name.empty()) return -1;
+        auto it = slotOf.find(name);
+        if (it != slotOf.end()) return it->second;
+        int16_t value = 0;
+        if (is_number(name)) value = static_cast<int16_t>(std::stol(name));
+        else if (initial.count(name)) value = initial.at(name);
+        slotOf[name] = static_cast<int>(slots.size());
+        slots.push_back(value);
+        names.push_back(name);
+        return static_cast<int>(slots.size()) - 1;
+    };
+    struct Decoded { int op, a, b, r, target; };
+    std::vector<Decoded> code(n);
+    static const char* ops[] = { ":=", "+", "-", "*", "/", "j", "j<", "j<=", "j>", "j>=", "j=", "j<>", "switch" };
+    for (int i = 0; i < n; i++) {
+        const Quadruple& q = quads[i];
+        int op = -1;
+        for (int k = 0; k < 13; k++) {
+            if (q.op == ops[k]) op = k;
+        }
+        Decoded& d = code[i];
+        d.op = op;
+        d.a = slot(q.arg1);
+        d.b = slot(q.arg2);
+        d.r = -1;
+        d.target = 0;
+        if (op >= 5 && op <= 11) d.target = std::stoi(q.result) - base;
+        else if (op != 12) d.r = slot(q.result);
+    }
+    for (const auto& entry : initial) slot(entry.first);
+
+    int pc = 0;
+    while (pc >= 0 && pc < n && run.executed < maxSteps) {
+        const Decoded& d = code[pc];
+        run.executed++;
+        int16_t x = d.a >= 0 ? slots[d.a] : 0;
+        int16_t y = d.b >= 0 ? slots[d.b] : 0;
+        bool jump = false;
+        switch (d.op) {
+        case 0: slots[d.r] = x; break;
+        case 1: slots[d.r] = static_cast<int16_t>(x + y); break;
+        case 2: slots[d.r] = static_cast<int16_t>(x - y); break;
+        case 3: slots[d.r] = static_cast<int16_t>(x * y); run.multiplies++; break;
+        case 4: slots[d.r] = y == 0 ? 0 : static_cast<int16_t>(x / y); run.multiplies++; break;
+        case 5: jump = true; break;
+        case 6: jump = x < y; break;
+        case 7: jump = x <= y; break;
+        case 8: jump = x > y; break;
+        case 9: jump = x >= y; break;
+        case 10: jump = x == y; break;
+        case 11: jump = x != y; break;
+        case 12:  // 跳转表：转到其后第 x+1 条
+            if (x < 0 || x >= y) throw std::runtime_error("跳转表下标越界");
+            pc += 1 + x;
+            continue;
+        default: break;
+        }
+        pc = jump ? d.target : pc + 1;
+    }
+    run.finished = pc < 0 || pc >= n;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!is_number(names[i]) && !is_temp(names[i])) run.vars[names[i]] = slots[i];
+    }
+    return run;
+}
@@ -0,0 +1,148 @@
+// SLR分析表生成器规模基准测试
+// 依次在一组由小到大的文法上运行生成器，记录各阶段（FIRST、FOLLOW、LR0、TABLE）的
+// 耗时与常驻内存增量，用于跟踪生成器随文法规模的伸缩情况。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -pthread -I. bench/slr_bench.cpp slr_generator.cpp grammar.cpp -o slr_bench
+// 运行：
+//   ./slr_bench [--threads N] [--grammars 目录] [--sizes 250,500,1000,...]
+#include "slr_generator.h"
+#include "parallel.h"
+#include "synthetic_grammar.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace {
+
+// 当前进程的常驻内存（KB）
+long currentRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long>(counters.WorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * 4;  // 按4KB页计算
+#endif
+}
+
+struct PhaseSample {
+    std::string phase;
+    double milliseconds;
+    long rssDeltaKb;
+};
+
+void runOne(const Grammar& grammar, unsigned threads) {
+    SLRGenerator generator(grammar, threads);
+    std::vector<PhaseSample> samples;
+    auto last = std::chrono::steady_clock::now();
+    long lastRss = currentRssKb();
+    generator.setPhaseCallback([&](const std::string& phase) {
+        auto now = std::chrono::steady_clock::now();
+        long rss = currentRssKb();
+        samples.push_back({ phase,
+            std::chrono::duration<double, std::milli>(now - last).count(),
+            rss - lastRss });
+        last = now;
+        lastRss = rss;
+    });
+    generator.generateParsingTable();
+
+    size_t items = 0;
+    for (const auto& state : generator.getStates()) {
+        items += state.items.size();
+    }
+    double total = 0;
+    std::cout << std::left << std::setw(16) << grammar.name
+        << std::right << std::setw(7) << grammar.productions.size()
+        << std::setw(8) << generator.getStates().size()
+        << std::setw(10) << items;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& sample : samples) {
+        std::cout << std::setw(11) << sample.milliseconds;
+        total += sample.milliseconds;
+    }
+    std::cout << std::setw(11) << total;
+    for (const auto& sample : samples) {
+        std::cout << std::setw(9) << sample.rssDeltaKb;
+    }
+    std::cout << std::setw(10) << currentRssKb() << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = 0;
+    std::string grammarDir = "grammars";
+    std::vector<int> sizes = { 250, 500, 1000, 2000, 4000 };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--grammars" && i + 1 < argc) {
+            grammarDir = argv[++i];
+        }
+        else if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoi(size));
+            }
+        }
+        else {
+            std::cerr << "用法: " << argv[0]
+                << " [--threads N] [--grammars 目录] [--sizes 250,500,...]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Grammar> ladder = {
+        SLRGenerator::arithmeticGrammar(),
+        SLRGenerator::booleanGrammar(),
+        SLRGenerator::statementGrammar(),
+    };
+    try {
+        ladder.push_back(Grammar::load(grammarDir + "/pascal.g"));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "跳过Pascal文法：" << e.what() << std::endl;
+    }
+    // 浅链（depth=4）接近普通语句文法；深链（depth=32）让闭包与状态数随优先级层数增长
+    for (int size : sizes) {
+        ladder.push_back(syntheticGrammar(size));
+    }
+    for (int size : sizes) {
+        ladder.push_back(syntheticGrammar(size, 32));
+    }
+
+    std::cout << "线程数: " << resolveThreadCount(threads) << std::endl;
+    std::cout << std::left << std::setw(16) << "文法"
+        << std::right << std::setw(7) << "产生式" << std::setw(8) << "状态"
+        << std::setw(10) << "项目"
+        << std::setw(11) << "FIRST(ms)" << std::setw(11) << "FOLLOW(ms)"
+        << std::setw(11) << "LR0(ms)" << std::setw(11) << "TABLE(ms)"
+        << std::setw(11) << "总计(ms)"
+        << std::setw(9) << "FIRST" << std::setw(9) << "FOLLOW"
+        << std::setw(9) << "LR0" << std::setw(9) << "TABLE"
+        << std::setw(10) << "RSS(KB)" << std::endl;
+    for (const auto& grammar : ladder) {
+        runOne(grammar, threads);
+    }
+    return 0;
+}
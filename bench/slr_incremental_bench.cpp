@@ -0,0 +1,142 @@
+// SLR分析表增量更新基准测试
+// 对每个文法施加若干产生式增删，比较 updateProductions 与完整重建的耗时，
+// 并逐项核对增量结果（FIRST/FOLLOW、状态、ACTION/GOTO表）与完整重建一致。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -pthread -I. bench/slr_incremental_bench.cpp slr_generator.cpp grammar.cpp -o slr_incremental_bench
+// 运行：
+//   ./slr_incremental_bench [--grammars 目录] [--sizes 500,2000,...]
+#include "slr_generator.h"
+#include "synthetic_grammar.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using SymbolSets = std::map<std::string, std::set<std::string>>;
+
+// 比较时忽略空集合：operator[] 会顺带留下空表项
+bool sameSets(const SymbolSets& a, const SymbolSets& b) {
+    SymbolSets x, y;
+    for (const auto& entry : a) if (!entry.second.empty()) x.insert(entry);
+    for (const auto& entry : b) if (!entry.second.empty()) y.insert(entry);
+    return x == y;
+}
+
+bool sameAutomaton(const SLRGenerator& a, const SLRGenerator& b) {
+    if (a.getStates().size() != b.getStates().size()) return false;
+    for (size_t i = 0; i < a.getStates().size(); i++) {
+        if (a.getStates()[i].items != b.getStates()[i].items ||
+            a.getStates()[i].transitions != b.getStates()[i].transitions) {
+            return false;
+        }
+    }
+    return sameSets(a.getFirstSets(), b.getFirstSets()) &&
+        sameSets(a.getFollowSets(), b.getFollowSets()) &&
+        a.getActionTable() == b.getActionTable() &&
+        a.getGotoTable() == b.getGotoTable();
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+bool allOk = true;
+
+void runDelta(SLRGenerator& generator, const std::string& label,
+    const std::vector<Production>& added, const std::vector<Production>& removed) {
+    auto start = std::chrono::steady_clock::now();
+    SLRGenerator::UpdateStats stats = generator.updateProductions(added, removed);
+    double incremental = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    SLRGenerator rebuilt(generator.getGrammar());
+    rebuilt.generateParsingTable();
+    double full = millisecondsSince(start);
+
+    bool same = sameAutomaton(generator, rebuilt);
+    allOk = allOk && same;
+    std::cout << std::left << std::setw(16) << generator.getGrammar().name
+        << std::setw(14) << label << std::right << std::fixed << std::setprecision(2)
+        << std::setw(10) << incremental << std::setw(10) << full
+        << std::setw(8) << (incremental > 0 ? full / incremental : 0)
+        << std::setw(7) << stats.firstRecomputed << std::setw(7) << stats.followRecomputed
+        << std::setw(8) << stats.statesReused << std::setw(8) << stats.statesRebuilt
+        << std::setw(8) << stats.rowsPatched << std::setw(8) << stats.rowsRegenerated
+        << (stats.fullRebuild ? "  完整重建" : "")
+        << (same ? "  一致" : "  不一致!") << std::endl;
+}
+
+void runGrammar(const Grammar& grammar) {
+    SLRGenerator generator(grammar);
+    generator.generateParsingTable();
+
+    // 选取位于文法中部与末尾的两条产生式作为修改对象
+    Production middle = grammar.productions[grammar.productions.size() / 2];
+    Production last = grammar.productions.back();
+    Production extraMiddle(middle.left, { "tNew", middle.left });
+    Production extraLast(last.left, { last.left, "tNew" });
+
+    runDelta(generator, "增加(中部)", { extraMiddle }, {});
+    runDelta(generator, "撤销增加", {}, { extraMiddle });
+    runDelta(generator, "增加(末尾)", { extraLast }, {});
+    runDelta(generator, "撤销增加", {}, { extraLast });
+    runDelta(generator, "删除(中部)", {}, { middle });
+    runDelta(generator, "恢复删除", { middle }, {});
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string grammarDir = "grammars";
+    std::vector<int> sizes = { 500, 2000 };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--grammars" && i + 1 < argc) {
+            grammarDir = argv[++i];
+        }
+        else if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoi(size));
+            }
+        }
+        else {
+            std::cerr << "用法: " << argv[0] << " [--grammars 目录] [--sizes 500,2000,...]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Grammar> grammars = {
+        SLRGenerator::arithmeticGrammar(),
+        SLRGenerator::booleanGrammar(),
+        SLRGenerator::statementGrammar(),
+    };
+    try {
+        grammars.push_back(Grammar::load(grammarDir + "/pascal.g"));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "跳过Pascal文法：" << e.what() << std::endl;
+    }
+    for (int size : sizes) {
+        grammars.push_back(syntheticGrammar(size));
+        grammars.push_back(syntheticGrammar(size, 32));
+    }
+
+    std::cout << std::left << std::setw(16) << "文法" << std::setw(14) << "修改"
+        << std::right << std::setw(10) << "增量(ms)" << std::setw(10) << "重建(ms)"
+        << std::setw(8) << "加速比" << std::setw(7) << "FIRST" << std::setw(7) << "FOLLOW"
+        << std::setw(8) << "复用" << std::setw(8) << "重算" << std::setw(8) << "改行"
+        << std::setw(8) << "重生成" << std::endl;
+    for (const auto& grammar : grammars) {
+        runGrammar(grammar);
+    }
+    return allOk ? 0 : 1;
+}
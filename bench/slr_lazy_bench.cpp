@@ -0,0 +1,143 @@
+// SLR分析表惰性构造基准测试
+// 对每个文法随机生成一批句子，分别用完整构造与惰性构造的分析表分析，
+// 统计首次分析耗时（含建表）与稳定状态下的分析速度，并核对两种模式的分析结果一致。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -pthread -I. bench/slr_lazy_bench.cpp slr_generator.cpp grammar.cpp -o slr_lazy_bench
+// 运行：
+//   ./slr_lazy_bench [--grammars 目录] [--sizes 500,2000,...] [--sentences N]
+#include "slr_generator.h"
+#include "synthetic_grammar.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+struct ModeResult {
+    double firstParse = 0;     // 建表 + 分析第一个句子（ms）
+    double steadyPerSentence = 0;  // 表已就绪后平均每句耗时（us）
+    size_t states = 0;         // 结束时已构造的状态数
+    std::vector<bool> accepted;
+    std::vector<std::vector<int>> reductions;
+};
+
+ModeResult runMode(const Grammar& grammar, bool lazyMode,
+    const std::vector<std::vector<std::string>>& sentences) {
+    ModeResult result;
+    SLRGenerator generator(grammar);
+    auto start = std::chrono::steady_clock::now();
+    if (lazyMode) generator.prepareLazyTable();
+    else generator.generateParsingTable();
+    std::vector<int> reductions;
+    bool ok = generator.parse(sentences[0], &reductions);
+    result.firstParse = millisecondsSince(start);
+
+    // 先完整分析一遍收集结果（惰性模式也在此时补齐所需状态），再计时重复分析
+    for (const auto& sentence : sentences) {
+        reductions.clear();
+        ok = generator.parse(sentence, &reductions);
+        result.accepted.push_back(ok);
+        result.reductions.push_back(reductions);
+    }
+    const int rounds = 5;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (const auto& sentence : sentences) {
+            generator.parse(sentence);
+        }
+    }
+    result.steadyPerSentence = millisecondsSince(start) * 1000 / (rounds * sentences.size());
+    result.states = generator.getStates().size();
+    return result;
+}
+
+bool allOk = true;
+
+void runGrammar(const Grammar& grammar, int sentenceCount) {
+    std::mt19937 rng(12345);
+    std::vector<std::vector<std::string>> sentences;
+    for (int i = 0; i < sentenceCount; i++) {
+        sentences.push_back(randomSentence(grammar, rng));
+    }
+
+    ModeResult eager = runMode(grammar, false, sentences);
+    ModeResult lazy = runMode(grammar, true, sentences);
+    bool same = eager.accepted == lazy.accepted && eager.reductions == lazy.reductions;
+    allOk = allOk && same;
+    size_t accepted = 0;
+    for (bool ok : eager.accepted) accepted += ok;
+
+    std::cout << std::left << std::setw(16) << grammar.name << std::right
+        << std::fixed << std::setprecision(2)
+        << std::setw(7) << accepted << "/" << std::setw(3) << std::left << sentences.size()
+        << std::right
+        << std::setw(11) << eager.firstParse << std::setw(11) << lazy.firstParse
+        << std::setw(11) << eager.steadyPerSentence << std::setw(11) << lazy.steadyPerSentence
+        << std::setw(8) << eager.states << std::setw(8) << lazy.states
+        << (same ? "  一致" : "  不一致!") << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string grammarDir = "grammars";
+    std::vector<int> sizes = { 500, 2000, 8000 };
+    int sentenceCount = 20;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--grammars" && i + 1 < argc) {
+            grammarDir = argv[++i];
+        }
+        else if (arg == "--sentences" && i + 1 < argc) {
+            sentenceCount = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string size;
+            while (std::getline(ss, size, ',')) {
+                sizes.push_back(std::stoi(size));
+            }
+        }
+        else {
+            std::cerr << "用法: " << argv[0]
+                << " [--grammars 目录] [--sizes 500,2000,...] [--sentences N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Grammar> grammars = {
+        SLRGenerator::arithmeticGrammar(),
+        SLRGenerator::booleanGrammar(),
+        SLRGenerator::statementGrammar(),
+    };
+    try {
+        grammars.push_back(Grammar::load(grammarDir + "/pascal.g"));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "跳过Pascal文法：" << e.what() << std::endl;
+    }
+    for (int size : sizes) {
+        grammars.push_back(syntheticGrammar(size));
+        grammars.push_back(syntheticGrammar(size, 32));
+    }
+
+    std::cout << std::left << std::setw(16) << "文法" << std::right << std::setw(11) << "接受"
+        << std::setw(11) << "完整首次" << std::setw(11) << "惰性首次"
+        << std::setw(11) << "完整us/句" << std::setw(11) << "惰性us/句"
+        << std::setw(8) << "完整状态" << std::setw(8) << "惰性状态" << std::endl;
+    std::cout << "（首次：建表并分析第一个句子的耗时，单位ms）" << std::endl;
+    for (const auto& grammar : grammars) {
+        runGrammar(grammar, sentenceCount);
+    }
+    return allOk ? 0 : 1;
+}
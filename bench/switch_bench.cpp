@@ -0,0 +1,145 @@
+// 多路分支基准测试
+// 生成一个循环，每次迭代算出选择子 s = (i mod m)*步长+偏移，再用语法制导翻译生成的 if-else 链
+// （j= 转到分支体，否则 j 到下一个比较）按 s 选一个分支累加到 acc。步长为1时常数密集，改为跳转表；
+// 步长大时常数稀疏，改为二分比较。“连续”在第一个链的最后一个 else 中接着比较另一个选择子 u
+// 的链（两条链首尾相接，前一条的 fallback 是后一条的链头）。分别用四元式解释器与8086汇编解释器执行改写前后的程序，
+// 统计执行的四元式条数、指令条数与访存次数，并核对各变量的最终值一致。
+//
+// 编译（在仓库根目录）：
+//   g++ -std=c++17 -O2 -I. -o switch_bench bench/switch_bench.cpp cfg.cpp assembler.cpp peephole.cpp register_allocator.cpp liveness.cpp constant_folding.cpp switch_lowering.cpp
+// 运行：
+//   ./switch_bench [--cases 4,8,16,...] [--iterations N]
+#include "cfg.h"
+#include "optimizer.h"
+#include "asm_interpreter.h"
+#include "quad_interpreter.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// 四元式按下标生成，标号为 100+下标；跳转目标先写下标，最后换成标号
+std::vector<Quadruple> buildProgram(int cases, int iterations, int stride, int offset, bool chained) {
+    std::vector<Quadruple> quads;
+    auto add = [&](const std::string& op, const std::string& a, const std::string& b, const std::string& r) {
+        quads.push_back({ 100 + static_cast<int>(quads.size()), op, a, b, r });
+        return static_cast<int>(quads.size()) - 1;
+    };
+    std::string m = std::to_string(cases + 2);  // 有两个余数落到最后的 else
+    add(":=", "0", "", "i");
+    add(":=", "0", "", "acc");
+    int loop = add("j<", "i", std::to_string(iterations), "");
+    int exit = add("j", "", "", "");
+    quads[loop].result = std::to_string(exit + 1);
+    // 选择子 var := (i mod modulus)*stride+offset
+    auto selector = [&](const std::string& var, const std::string& modulus) {
+        add("/", "i", modulus, "T1");
+        add("*", "T1", modulus, "T2");
+        add("-", "i", "T2", "T3");
+        add("*", "T3", std::to_string(stride), "T4");
+        add("+", "T4", std::to_string(offset), var);
+    };
+    std::vector<int> ends;
+    auto ladder = [&](const std::string& var, const std::string& sum) {
+        for (int k = 0; k < cases; k++) {
+            int test = add("j=", var, std::to_string(k * stride + offset), "");
+            int skip = add("j", "", "", "");
+            quads[test].result = std::to_string(skip + 1);
+            add("+", sum, std::to_string(3 * k + 1), sum);
+            ends.push_back(add("j", "", "", ""));
+            quads[skip].result = std::to_string(skip + 3);
+        }
+    };
+    selector("s", m);
+    if (chained) {
+        add(":=", "0", "", "acc2");
+        selector("u", std::to_string(cases + 3));
+    }
+    ladder("s", "acc");
+    if (chained) ladder("u", "acc2");
+    add("-", "acc", "1", "acc");
+    int end = add("+", "i", "1", "i");
+    for (int e : ends) quads[e].result = std::to_string(end);
+    add("j", "", "", std::to_string(loop));
+    quads[exit].result = std::to_string(quads.size());
+    for (auto& quad : quads) {
+        if (is_jump(quad.op)) quad.result = std::to_string(100 + std::stoi(quad.result));
+    }
+    return quads;
+}
+
+bool allOk = true;
+
+void runProgram(int cases, int iterations, int stride, bool chained, const char* kind) {
+    std::vector<Quadruple> quads = buildProgram(cases, iterations, stride, 5, chained);
+    QuadRun before = runQuads(quads);
+    AsmRun asmBefore = runAsm(assemble(quads, collect_vars(quads)));
+
+    auto start = std::chrono::steady_clock::now();
+    SwitchStats stats = lower_switches(quads);
+    double time = millisecondsSince(start);
+    QuadRun after = runQuads(quads);
+    AsmRun asmAfter = runAsm(assemble(quads, collect_vars(quads)));
+
+    bool same = before.finished && after.finished && asmBefore.finished && asmAfter.finished &&
+        before.vars == after.vars;
+    for (const auto& entry : before.vars) {
+        same = same && asmBefore.vars.at(entry.first) == entry.second && asmAfter.vars.at(entry.first) == entry.second;
+    }
+    allOk = allOk && same;
+    std::cout << std::setw(6) << kind << std::setw(6) << cases << std::setw(7) << stride
+        << std::fixed << std::setprecision(2) << std::setw(10) << time
+        << std::setw(6) << stats.tables << std::setw(6) << stats.trees << std::setw(7) << stats.added
+        << std::setw(11) << before.executed << std::setw(11) << after.executed
+        << std::setw(11) << asmBefore.executed << std::setw(11) << asmAfter.executed
+        << std::setw(11) << asmBefore.memory << std::setw(11) << asmAfter.memory
+        << (same ? "  一致" : "  不一致!") << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> caseCounts = { 4, 8, 16, 64, 200 };
+    int iterations = 10000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cases" && i + 1 < argc) {
+            caseCounts.clear();
+            std::stringstream ss(argv[++i]);
+            std::string count;
+            while (std::getline(ss, count, ',')) {
+                caseCounts.push_back(std::stoi(count));
+            }
+        }
+        else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::stoi(argv[++i]));
+        }
+        else {
+            std::cerr << "用法: " << argv[0] << " [--cases 4,8,16,...] [--iterations N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // 表：跳转表个数；树：二分比较个数；增加：净增加的四元式
+    std::cout << std::setw(6) << "常数" << std::setw(6) << "分支" << std::setw(7) << "步长"
+        << std::setw(10) << "耗时(ms)" << std::setw(6) << "表" << std::setw(6) << "树" << std::setw(7) << "增加"
+        << std::setw(11) << "原四元式" << std::setw(11) << "新四元式"
+        << std::setw(11) << "原指令" << std::setw(11) << "新指令"
+        << std::setw(11) << "原访存" << std::setw(11) << "新访存" << std::endl;
+    for (int cases : caseCounts) {
+        runProgram(cases, iterations, 1, false, "密集");
+        runProgram(cases, iterations, 37, false, "稀疏");
+        runProgram(cases, iterations, 1, true, "连续");
+        runProgram(cases, iterations, 37, true, "连续");
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "grammar.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// 合成文法：families个语句族，每族带一条depth层的运算符优先级链，
+// 族之间共享 id、(、) 与语句分隔符，产生式总数约为 families * (2 * depth + 3)
+inline Grammar syntheticGrammar(int targetProductions, int depth = 4) {
+    int perFamily = 2 * depth + 3;
+    int families = std::max(1, targetProductions / perFamily);
+    std::vector<Production> productions;
+    productions.push_back(Production("S'", { "P" }));
+    productions.push_back(Production("P", { "P", ";", "S" }));
+    productions.push_back(Production("P", { "S" }));
+    for (int f = 0; f < families; f++) {
+        std::string family = std::to_string(f);
+        auto level = [&](int k) { return "X" + family + "_" + std::to_string(k); };
+        productions.push_back(Production("S", { "kw" + family, level(0) }));
+        for (int k = 0; k < depth; k++) {
+            std::string op = "op" + family + "_" + std::to_string(k);
+            productions.push_back(Production(level(k), { level(k), op, level(k + 1) }));
+            productions.push_back(Production(level(k), { level(k + 1) }));
+        }
+        productions.push_back(Production(level(depth), { "id" }));
+        productions.push_back(Production(level(depth), { "(", level(0), ")" }));
+    }
+    return Grammar("合成" + std::to_string(productions.size()) + "/d" + std::to_string(depth),
+        productions);
+}
+
+// 按文法随机推导出一个句子（终结符序列）。
+// 深度超过maxDepth后只选推导高度最小的产生式，保证推导终止
+inline std::vector<std::string> randomSentence(const Grammar& grammar, std::mt19937& rng,
+    int maxDepth = 12) {
+    // 各非终结符的最小推导高度
+    std::map<std::string, int> height;
+    bool changed;
+    do {
+        changed = false;
+        for (const auto& prod : grammar.productions) {
+            int h = 1;
+            bool known = true;
+            for (const auto& symbol : prod.right) {
+                if (grammar.isTerminal(symbol)) continue;
+                auto it = height.find(symbol);
+                if (it == height.end()) {
+                    known = false;
+                    break;
+                }
+                h = std::max(h, it->second + 1);
+            }
+            if (!known) continue;
+            auto it = height.find(prod.left);
+            if (it == height.end() || h < it->second) {
+                height[prod.left] = h;
+                changed = true;
+            }
+        }
+    } while (changed);
+
+    std::map<std::string, std::vector<const Production*>> byLeft;
+    for (size_t i = 1; i < grammar.productions.size(); i++) {
+        byLeft[grammar.productions[i].left].push_back(&grammar.productions[i]);
+    }
+    auto productionHeight = [&](const Production& prod) {
+        int h = 1;
+        for (const auto& symbol : prod.right) {
+            if (!grammar.isTerminal(symbol)) h = std::max(h, height[symbol] + 1);
+        }
+        return h;
+    };
+
+    std::vector<std::string> sentence;
+    std::function<void(const std::string&, int)> expand = [&](const std::string& symbol, int depth) {
+        if (grammar.isTerminal(symbol)) {
+            sentence.push_back(symbol);
+            return;
+        }
+        const auto& candidates = byLeft[symbol];
+        const Production* chosen = nullptr;
+        if (depth < maxDepth) {
+            chosen = candidates[rng() % candidates.size()];
+        }
+        else {
+            for (const auto* prod : candidates) {
+                if (!chosen || productionHeight(*prod) < productionHeight(*chosen)) chosen = prod;
+            }
+        }
+        for (const auto& next : chosen->right) {
+            expand(next, depth + 1);
+        }
+    };
+    expand(grammar.start, 0);
+    return sentence;
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "assembler.h"
+#include <random>
+#include <string>
+#include <vector>
+
+// 合成四元式程序：按语法分析器对赋值、if、while的翻译方式随机生成结构化程序，
+// 用于在大规模输入上测试控制流分析与各优化遍。
+//   while:  L: (jrop,x,y,L+2) (j,,,出口) 循环体 (j,,,L)
+//   if:     (jrop,x,y,+2) (j,,,else) then部分 (j,,,结束) else部分
+//   多路:   if v=c1 then … else if v=c2 then … 的 j= 链，最后的 else 有时是比较另一个变量的链
+// while循环都是计数循环（循环变量 i<深度>，轮数 trips 以内），有的从0加到上界，有的从上界减到0，
+// 有的先把循环变量乘一个常数放入临时变量再比较；循环变量单调变化，程序总能终止。
+// 循环末尾有时再加（减）1一次或按条件加（减）1一次，供循环展开与归纳变量分析检查不规则的步长。
+// 内层循环中的 if 有时只比较外层循环变量与常数，条件在内层循环中不变，供循环判断外提。
+// 赋值语句只写 a..h，不会破坏循环变量；循环体中的表达式有时以 i<深度>*常数 开头，供归纳变量分析。
+// 程序开头给 k0..k3 赋常数，此后只在循环中重复赋同一个常数，供常量传播跨越循环与分支
+class SyntheticProgram {
+public:
+    SyntheticProgram(size_t targetQuads, unsigned seed = 1, int maxDepth = 3, int trips = 4)
+        : target(targetQuads), rng(seed), maxDepth(maxDepth), trips(trips) {}
+
+    std::vector<Quadruple> build() {
+        for (int k = 0; k < 4; k++) {
+            constants[k] = std::to_string(pick(10));
+            emit(":=", constants[k], "", constantVariable(k));
+        }
+        while (quads.size() < target) {
+            statement(0);
+        }
+        return quads;
+    }
+
+private:
+    size_t target;
+    std::mt19937 rng;
+    int maxDepth;
+    int trips;
+    int tempCounter = 1;
+    std::vector<Quadruple> quads;
+    std::string lastArg1, lastOp, lastArg2;  // 上一个表达式，用于制造公共子表达式
+    std::string constants[4];                // k0..k3 的值
+    std::vector<std::string> counters;       // 外围各层循环的循环变量
+
+    int next() const { return 100 + static_cast<int>(quads.size()); }
+    int pick(int n) { return std::uniform_int_distribution<int>(0, n - 1)(rng); }
+
+    void emit(const std::string& op, const std::string& arg1, const std::string& arg2,
+        const std::string& result) {
+        quads.push_back(Quadruple{ next(), op, arg1, arg2, result });
+        if (op[0] == 'j') forgetExpression();
+    }
+    // 基本块边界：上一个表达式的临时变量在汇合点之后不一定有定值
+    void forgetExpression() { lastOp.clear(); }
+    void patch(int label, int target) {
+        quads[label - 100].result = std::to_string(target);
+    }
+    std::string newTemp() { return "T" + std::to_string(tempCounter++); }
+    std::string variable() { return std::string(1, static_cast<char>('a' + pick(8))); }
+    std::string constantVariable(int k) { return "k" + std::to_string(k); }
+    std::string operand() {
+        int choice = pick(20);
+        if (choice < 5) return std::to_string(pick(10));
+        if (choice < 8) return constantVariable(pick(4));
+        return variable();
+    }
+    // 条件的左运算对象，偶尔是常数变量，使条件可在编译时判定
+    std::string condition() {
+        return pick(4) == 0 ? constantVariable(pick(4)) : variable();
+    }
+    std::string relop() {
+        static const char* ops[] = { "j<", "j<=", "j>", "j>=", "j=", "j<>" };
+        return ops[pick(6)];
+    }
+
+    void assignment() {
+        std::string value = operand();
+        if (!counters.empty() && pick(4) == 0) {
+            std::string temp = newTemp();
+            emit("*", counters[pick(static_cast<int>(counters.size()))], std::to_string(2 + pick(8)), temp);
+            value = temp;
+        }
+        int terms = 1 + pick(3);
+        for (int i = 0; i < terms; i++) {
+            std::string op = pick(3) == 0 ? "*" : "+";
+            std::string rhs = operand();
+            if (!lastOp.empty() && pick(4) == 0) {
+                op = lastOp;
+                value = lastArg1;
+                rhs = lastArg2;
+            }
+            std::string temp = newTemp();
+            emit(op, value, rhs, temp);
+            lastArg1 = value;
+            lastOp = op;
+            lastArg2 = rhs;
+            value = temp;
+        }
+        emit(":=", value, "", variable());
+    }
+
+    void body(int depth) {
+        int count = 1 + pick(4);
+        for (int i = 0; i < count; i++) {
+            statement(depth);
+        }
+    }
+
+    void ifStatement(int depth) {
+        if (counters.size() >= 2 && pick(3) == 0) {
+            // 外层循环变量在内层循环中不变
+            std::string outer = counters[pick(static_cast<int>(counters.size()) - 1)];
+            emit(relop(), outer, std::to_string(pick(trips)), std::to_string(next() + 2));
+        }
+        else {
+            emit(relop(), condition(), operand(), std::to_string(next() + 2));
+        }
+        int falseJump = next();
+        emit("j", "", "", "0");
+        body(depth + 1);
+        int skipElse = next();
+        emit("j", "", "", "0");
+        patch(falseJump, next());
+        if (pick(2) == 0) body(depth + 1);
+        patch(skipElse, next());
+        forgetExpression();
+    }
+
+    void whileStatement(int depth) {
+        std::string counter = "i" + std::to_string(depth);
+        bool down = pick(4) == 0;
+        int bound = 1 + pick(trips);
+        emit(":=", down ? std::to_string(bound) : "0", "", counter);
+        int start = next();
+        std::string tested = counter;
+        int scale = pick(4) == 0 ? 2 + pick(3) : 1;
+        if (scale > 1) {
+            tested = newTemp();
+            emit("*", counter, std::to_string(scale), tested);
+        }
+        emit(down ? "j>" : "j<", tested, down ? "0" : std::to_string(bound * scale), std::to_string(next() + 2));
+        int exitJump = next();
+        emit("j", "", "", "0");
+        counters.push_back(counter);
+        body(depth + 1);
+        counters.pop_back();
+        if (pick(4) == 0) {
+            int k = pick(4);
+            emit(":=", constants[k], "", constantVariable(k));
+        }
+        int extra = pick(8);
+        if (extra == 0) step(counter, down);
+        else if (extra == 1) {
+            emit(relop(), condition(), operand(), std::to_string(next() + 2));
+            int skip = next();
+            emit("j", "", "", "0");
+            step(counter, down);
+            patch(skip, next());
+            forgetExpression();
+        }
+        step(counter, down);
+        emit("j", "", "", std::to_string(start));
+        patch(exitJump, next());
+    }
+
+    void step(const std::string& counter, bool down) {
+        std::string temp = newTemp();
+        emit(down ? "-" : "+", counter, "1", temp);
+        emit(":=", temp, "", counter);
+    }
+
+    // 比较同一变量与若干互不相同的常数（步长为1时密集，否则稀疏）。循环中常比较循环变量，使各分支都能执行到；
+    // 最后的 else 有时紧接着另一个变量的链，两条链首尾相接
+    void ladderStatement(int depth, const std::string& previous = "") {
+        std::string var;
+        do {
+            var = !counters.empty() && pick(2) == 0 ? counters[pick(static_cast<int>(counters.size()))] : variable();
+        } while (var == previous);
+        int cases = 4 + pick(5);
+        int first = pick(3), stride = pick(2) == 0 ? 1 : 2 + pick(20);
+        std::vector<int> ends;
+        for (int k = 0; k < cases; k++) {
+            emit("j=", var, std::to_string(first + k * stride), std::to_string(next() + 2));
+            int falseJump = next();
+            emit("j", "", "", "0");
+            if (depth < maxDepth && pick(4) == 0) body(depth + 1);
+            else assignment();
+            ends.push_back(next());
+            emit("j", "", "", "0");
+            patch(falseJump, next());
+        }
+        int last = pick(3);
+        if (last == 0) ladderStatement(depth, var);
+        else if (last == 1) assignment();
+        for (int end : ends) patch(end, next());
+        forgetExpression();
+    }
+
+    void statement(int depth) {
+        int choice = pick(10);
+        if (depth < maxDepth && choice < 2) whileStatement(depth);
+        else if (depth < maxDepth && choice < 4) ifStatement(depth);
+        else if (depth < maxDepth && choice < 5) ladderStatement(depth);
+        else assignment();
+    }
+};
@@ -0,0 +1,349 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+BlockProfile profile_quads(const std::vector<Quadruple>& quads, const std::map<std::string, int16_t>& inputs,
+    long long max_steps) {
+    BlockProfile profile;
+    int n = static_cast<int>(quads.size());
+    profile.executed.assign(n, 0);
+    profile.taken.assign(n, 0);
+    if (n == 0) {
+        profile.finished = true;
+        return profile;
+    }
+
+    // 名字预先换成下标，常数也放进值表
+    std::unordered_map<std::string, int> index;
+    std::vector<int16_t> values;
+    auto slot = [&](const std::string& name) {
+        if (name.empty()) return -1;
+        auto it = index.find(name);
+        if (it != index.end()) return it->second;
+        int16_t value = 0;
+        if (is_number(name)) value = constant_value(name);
+        else if (inputs.count(name)) value = inputs.at(name);
+        index[name] = static_cast<int>(values.size());
+        values.push_back(value);
+        return static_cast<int>(values.size()) - 1;
+    };
+    struct Operands { int a, b, r; };
+    std::vector<Operands> operands(n);
+    for (int i = 0; i < n; i++) {
+        const Quadruple& quad = quads[i];
+        int result = is_jump(quad.op) ? jump_target(quad) - quads[0].label
+            : quad.op == "switch" ? switch_entries(quad) : slot(quad.result);
+        operands[i] = { slot(quad.arg1), slot(quad.arg2), result };
+    }
+
+    long long steps = 0;
+    int pc = 0;
+    while (pc >= 0 && pc < n && steps < max_steps) {
+        const Quadruple& quad = quads[pc];
+        const Operands& o = operands[pc];
+        profile.executed[pc]++;
+        steps++;
+        int16_t a = o.a >= 0 ? values[o.a] : 0, b = o.b >= 0 ? values[o.b] : 0;
+        if (quad.op == "switch") {
+            if (a < 0 || a >= o.r) throw std::runtime_error("跳转表下标越界：" + std::to_string(a));
+            profile.taken[pc]++;
+            pc += 1 + a;
+            continue;
+        }
+        if (is_jump(quad.op)) {
+            if (quad.op == "j" || evaluate_relop(quad.op, a, b)) {
+                profile.taken[pc]++;
+                pc = o.r;
+                continue;
+            }
+        }
+        else {
+            int16_t result = a;
+            // 与生成的代码一致：除数为0时结果为0，-32768/-1 回绕为 -32768
+            if (quad.op != ":=" && !evaluate_arith(quad.op, a, b, result)) {
+                result = b == 0 ? 0 : static_cast<int16_t>(-static_cast<int>(a));
+            }
+            values[o.r] = result;
+        }
+        pc++;
+    }
+    profile.finished = pc < 0 || pc >= n;
+    return profile;
+}
+
+namespace {
+
+const int EXIT = -1;  // 后继为程序出口
+
+class Layout {
+public:
+    Layout(std::vector<Quadruple>& quads, const BlockProfile* profile, LayoutStats& stats)
+        : quads(quads), profile(profile), stats(stats), n(static_cast<int>(quads.size())), cfg(build_cfg(quads)),
+          blocks(cfg.num_blocks()) {
+        compute_dominators(cfg);
+        loops = find_loops(cfg);
+        if (profile && (profile->executed.size() != quads.size() || profile->taken.size() != quads.size())) {
+            throw std::runtime_error("执行剖面与四元式序列的长度不符");
+        }
+        stats.profiled = profile != nullptr;
+        successors();
+        if (profile) profiledWeights();
+        else staticWeights();
+    }
+
+    void run() {
+        std::vector<int> order = chainOrder();
+        stats.taken_before = takenWeight(identity());
+        stats.taken_after = takenWeight(order);
+        for (int p = 0; p < blocks; p++) {
+            if (order[p] != p) stats.moved++;
+        }
+        emit(order);
+    }
+
+private:
+    std::vector<Quadruple>& quads;
+    const BlockProfile* profile;
+    LayoutStats& stats;
+    int n;
+    CFG cfg;
+    int blocks;
+    std::vector<Loop> loops;
+    // 块的两个后继：顺序执行到的 fall 与跳转到的 target（没有时为 -2），以及两条边的权重
+    std::vector<int> fall, target;
+    std::vector<double> fallWeight, targetWeight, frequency;
+    std::vector<char> cold;
+
+    std::vector<int> identity() const {
+        std::vector<int> order(blocks);
+        std::iota(order.begin(), order.end(), 0);
+        return order;
+    }
+
+    int blockOf(int label) const {
+        int index = label - quads[0].label;
+        return index >= n ? EXIT : cfg.block_of_quad[index];
+    }
+
+    void successors() {
+        fall.assign(blocks, -2);
+        target.assign(blocks, -2);
+        for (int b = 0; b < blocks; b++) {
+            const Quadruple& last = quads[cfg.last_quad(b)];
+            if (is_jump(last.op)) target[b] = blockOf(jump_target(last));
+            if (last.op != "j") fall[b] = b + 1 < blocks ? b + 1 : EXIT;
+        }
+    }
+
+    // 剖面：跳转成立的次数是跳转边的权重，其余执行次数是顺序执行边的权重
+    void profiledWeights() {
+        fallWeight.assign(blocks, 0);
+        targetWeight.assign(blocks, 0);
+        frequency.assign(blocks, 0);
+        cold.assign(blocks, 0);
+        for (int b = 0; b < blocks; b++) {
+            int last = cfg.last_quad(b);
+            frequency[b] = static_cast<double>(profile->executed[cfg.first_quad(b)]);
+            targetWeight[b] = static_cast<double>(profile->taken[last]);
+            if (fall[b] != -2) fallWeight[b] = static_cast<double>(profile->executed[last] - profile->taken[last]);
+            cold[b] = profile->executed[cfg.first_quad(b)] == 0;
+            if (cold[b]) stats.cold++;
+        }
+    }
+
+    // 静态估计：块的频率取 8^循环深度；条件跳转的回边与留在循环内的一侧按 7/8 的概率成立，
+    // 离开循环的一侧按 1/8，其余两侧各半。不可达的块作为冷块
+    void staticWeights() {
+        std::vector<int> depth(blocks, 0), innermost(blocks, -1);
+        for (int l = 0; l < static_cast<int>(loops.size()); l++) {
+            for (int b : loops[l].blocks) {
+                if (innermost[b] < 0) {
+                    innermost[b] = l;
+                    depth[b] = loops[l].depth;
+                }
+            }
+        }
+        auto inLoop = [&](int l, int b) {
+            return b >= 0 && std::binary_search(loops[l].blocks.begin(), loops[l].blocks.end(), b);
+        };
+        auto backEdge = [&](int from, int to) { return to >= 0 && cfg.reachable(from) && cfg.dominates(to, from); };
+
+        fallWeight.assign(blocks, 0);
+        targetWeight.assign(blocks, 0);
+        frequency.assign(blocks, 0);
+        cold.assign(blocks, 0);
+        for (int b = 0; b < blocks; b++) {
+            if (!cfg.reachable(b)) {
+                cold[b] = 1;
+                stats.cold++;
+                continue;
+            }
+            frequency[b] = 1;
+            for (int d = 0; d < depth[b]; d++) frequency[b] *= 8;
+            if (fall[b] == -2) {
+                targetWeight[b] = frequency[b];
+                continue;
+            }
+            if (target[b] == -2) {
+                fallWeight[b] = frequency[b];
+                continue;
+            }
+            double taken = 0.5;
+            int l = innermost[b];
+            if (backEdge(b, target[b])) taken = 0.875;
+            else if (backEdge(b, fall[b])) taken = 0.125;
+            else if (l >= 0 && inLoop(l, fall[b]) && !inLoop(l, target[b])) taken = 0.125;
+            else if (l >= 0 && inLoop(l, target[b]) && !inLoop(l, fall[b])) taken = 0.875;
+            targetWeight[b] = frequency[b] * taken;
+            fallWeight[b] = frequency[b] * (1 - taken);
+        }
+    }
+
+    // 按边的权重从大到小把后继接成链：u 是所在链的尾、v 是所在链的头时连起来，v 在 u 之后顺序执行。
+    // 入口块总是链头；有剖面时不连没有执行过的边，冷块单独成链。
+    // 入口所在的链放在最前，其余的链按链头原来的位置排列，冷块组成的链放到最后
+    std::vector<int> chainOrder() {
+        struct Edge { int from, to; double weight; };
+        std::vector<Edge> edges;
+        for (int b = 0; b < blocks; b++) {
+            if (target[b] >= 0) edges.push_back({ b, target[b], targetWeight[b] });
+            if (fall[b] >= 0 && fall[b] != target[b]) edges.push_back({ b, fall[b], fallWeight[b] });
+        }
+        std::stable_sort(edges.begin(), edges.end(), [](const Edge& x, const Edge& y) { return x.weight > y.weight; });
+
+        std::vector<int> next(blocks, -1), prev(blocks, -1), head(blocks);
+        std::iota(head.begin(), head.end(), 0);
+        for (const auto& edge : edges) {
+            if (edge.to == 0 || next[edge.from] >= 0 || prev[edge.to] >= 0) continue;
+            if (profile && edge.weight <= 0) continue;
+            if (head[edge.from] == edge.to) continue;  // 会连成环
+            next[edge.from] = edge.to;
+            prev[edge.to] = edge.from;
+            for (int b = edge.to; b >= 0; b = next[b]) head[b] = head[edge.from];
+        }
+
+        std::vector<int> heads;
+        for (int b = 0; b < blocks; b++) {
+            if (prev[b] < 0) heads.push_back(b);
+        }
+        auto chainCold = [&](int h) {
+            for (int b = h; b >= 0; b = next[b]) {
+                if (!cold[b]) return false;
+            }
+            return true;
+        };
+        std::stable_partition(heads.begin(), heads.end(), [&](int h) { return h == 0 || !chainCold(h); });
+        std::vector<int> order;
+        for (int h : heads) {
+            stats.chains++;
+            for (int b = h; b >= 0; b = next[b]) order.push_back(b);
+        }
+        return order;
+    }
+
+    // 条件跳转的两侧都不顺序执行时，权重大的一侧作为条件跳转的目标，另一侧用无条件跳转
+    bool invertWithJump(int b) const { return fallWeight[b] > targetWeight[b]; }
+
+    // 按布局 order 执行时估计的转移次数：成立的条件跳转与无条件跳转都计
+    long long takenWeight(const std::vector<int>& order) const {
+        double taken = 0;
+        for (int p = 0; p < blocks; p++) {
+            int b = order[p];
+            int next = p + 1 < blocks ? order[p + 1] : EXIT;
+            if (fall[b] == -2) {
+                if (target[b] != next) taken += targetWeight[b];
+            }
+            else if (target[b] == -2) {
+                if (fall[b] != next) taken += fallWeight[b];
+            }
+            else if (fall[b] == next) taken += targetWeight[b];
+            else if (target[b] == next) taken += fallWeight[b];
+            else taken += fallWeight[b] + targetWeight[b];  // 两侧各经过一次转移
+        }
+        return static_cast<long long>(taken + 0.5);
+    }
+
+    // 按新的顺序输出各块并改写块末的跳转。四元式先用原下标作编号，
+    // 补上的跳转编号从 n 起，出口为 2n，最后由 relabel_quads 重新连续编号。
+    // 删去的跳转若是块中唯一的四元式，跳到它的跳转改跳它的目标
+    void emit(const std::vector<int>& order) {
+        int base = quads[0].label;
+        int exitId = 2 * n;
+        int added = n;
+        auto id = [&](int block) { return block == EXIT ? exitId : cfg.first_quad(block); };
+        auto jump = [&](int block) { return Quadruple{ added++, "j", "", "", std::to_string(id(block)) }; };
+
+        std::vector<int> alias(2 * n + 1, -1);
+        std::vector<Quadruple> result;
+        result.reserve(quads.size() + blocks);
+        for (int p = 0; p < blocks; p++) {
+            int b = order[p];
+            int next = p + 1 < blocks ? order[p + 1] : EXIT;
+            int last = cfg.last_quad(b);
+            for (int i = cfg.first_quad(b); i < last; i++) {
+                result.push_back(quads[i]);
+                result.back().label = i;
+            }
+            Quadruple end = quads[last];
+            end.label = last;
+            if (is_jump(end.op)) end.result = std::to_string(id(target[b]));
+
+            if (fall[b] == -2) {
+                // 无条件跳转到下一块时删去
+                if (target[b] == next) {
+                    alias[last] = id(target[b]);
+                    stats.removed++;
+                }
+                else result.push_back(end);
+            }
+            else if (target[b] == -2) {
+                result.push_back(end);
+                if (fall[b] != next) {
+                    result.push_back(jump(fall[b]));
+                    stats.added++;
+                }
+            }
+            else if (fall[b] == next) {
+                result.push_back(end);
+            }
+            else if (target[b] == next) {
+                end.op = invert_relop(end.op);
+                end.result = std::to_string(id(fall[b]));
+                result.push_back(end);
+                stats.inverted++;
+            }
+            else {
+                int other = fall[b];
+                if (invertWithJump(b)) {
+                    end.op = invert_relop(end.op);
+                    end.result = std::to_string(id(fall[b]));
+                    other = target[b];
+                    stats.inverted++;
+                }
+                result.push_back(end);
+                result.push_back(jump(other));
+                stats.added++;
+            }
+        }
+        for (auto& quad : result) {
+            if (!is_jump(quad.op)) continue;
+            int to = std::stoi(quad.result);
+            while (alias[to] >= 0) to = alias[to];
+            quad.result = std::to_string(to);
+        }
+        relabel_quads(result, base, exitId);
+        quads = std::move(result);
+    }
+};
+
+}
+
+LayoutStats layout_blocks(std::vector<Quadruple>& quads, const BlockProfile* profile) {
+    LayoutStats stats;
+    if (quads.empty()) return stats;
+    Layout(quads, profile, stats).run();
+    return stats;
+}
@@ -0,0 +1,510 @@
+#include "cfg.h"
+#include <algorithm>
+#include <stdexcept>
+
+// 判断是否为跳转四元式（j 或 j<rop>）
+bool is_jump(const std::string& op) {
+    return !op.empty() && op[0] == 'j';
+}
+
+// 判断是否为条件跳转四元式（j>、j>=、j=、j<、j<=、j<>）
+bool is_cond_jump(const std::string& op) {
+    return op.size() > 1 && op[0] == 'j';
+}
+
+int jump_target(const Quadruple& quad) {
+    return std::stoi(quad.result);
+}
+
+int switch_entries(const Quadruple& quad) {
+    return quad.op == "switch" ? std::stoi(quad.arg2) : 0;
+}
+
+std::string mirror_relop(const std::string& op) {
+    if (op == "j<") return "j>";
+    if (op == "j>") return "j<";
+    if (op == "j<=") return "j>=";
+    if (op == "j>=") return "j<=";
+    return op;
+}
+
+std::string invert_relop(const std::string& op) {
+    if (op == "j<") return "j>=";
+    if (op == "j>=") return "j<";
+    if (op == "j>") return "j<=";
+    if (op == "j<=") return "j>";
+    if (op == "j=") return "j<>";
+    if (op == "j<>") return "j=";
+    throw std::runtime_error("不是关系跳转：" + op);
+}
+
+void remove_quads(std::vector<Quadruple>& quads, const std::vector<char>& removed) {
+    int n = static_cast<int>(quads.size());
+    if (n == 0) return;
+    int base = quads[0].label;
+    // new_index[i]：原第i条四元式（或其后第一条保留的四元式）的新下标，new_index[n] 为新出口
+    std::vector<int> new_index(n + 1, 0);
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        new_index[i] = kept;
+        if (!removed[i]) kept++;
+    }
+    new_index[n] = kept;
+    int out = 0;
+    for (int i = 0; i < n; i++) {
+        if (removed[i]) continue;
+        Quadruple quad = std::move(quads[i]);
+        quad.label = base + out;
+        if (is_jump(quad.op)) {
+            int target = jump_target(quad) - base;
+            if (target >= 0 && target <= n) {
+                quad.result = std::to_string(base + new_index[target]);
+            }
+        }
+        quads[out++] = std::move(quad);
+    }
+    quads.resize(out);
+}
+
+void relabel_quads(std::vector<Quadruple>& quads, int base_label, int exit_id) {
+    int max_id = exit_id;
+    for (const auto& quad : quads) max_id = std::max(max_id, quad.label);
+    std::vector<int> position(max_id + 1, -1);
+    for (size_t i = 0; i < quads.size(); i++) position[quads[i].label] = static_cast<int>(i);
+    position[exit_id] = static_cast<int>(quads.size());
+    for (size_t i = 0; i < quads.size(); i++) {
+        Quadruple& quad = quads[i];
+        quad.label = base_label + static_cast<int>(i);
+        if (!is_jump(quad.op)) continue;
+        int target = position[std::stoi(quad.result)];
+        if (target < 0) throw std::runtime_error("跳转目标已不存在：" + quad.result);
+        quad.result = std::to_string(base_label + target);
+    }
+}
+
+bool QuadEdits::empty() const {
+    for (size_t i = 0; i < removed.size(); i++) {
+        if (removed[i] || !before[i].empty() || !after[i].empty()) return false;
+    }
+    return true;
+}
+
+void apply_edits(std::vector<Quadruple>& quads, QuadEdits& edits) {
+    int n = static_cast<int>(quads.size());
+    if (n == 0) return;
+    int base = quads[0].label;
+    // 编号：原四元式为下标，n 表示跳出程序，插入的四元式依次编号 n+1…
+    std::vector<int> firstBefore(n), firstAfter(n);
+    int nextId = n + 1;
+    for (int i = 0; i < n; i++) {
+        firstBefore[i] = nextId;
+        nextId += static_cast<int>(edits.before[i].size());
+        firstAfter[i] = nextId;
+        nextId += static_cast<int>(edits.after[i].size());
+    }
+    std::vector<int> landing(n + 1, n);
+    for (int i = n - 1; i >= 0; i--) {
+        if (!edits.removed[i]) landing[i] = i;
+        else if (!edits.after[i].empty()) landing[i] = firstAfter[i];
+        else if (i + 1 < n && !edits.before[i + 1].empty()) landing[i] = firstBefore[i + 1];
+        else landing[i] = landing[i + 1];
+    }
+    std::vector<char> redirect(n, 0);
+    for (int i : edits.redirected) redirect[i] = 1;
+
+    // 插入序列 list 的第一条编号为 first、之后顺序执行到 follow 时，把它放入结果
+    std::vector<Quadruple> result;
+    result.reserve(n + n / 4);
+    auto emit = [&](std::vector<Quadruple>& list, int first, int follow) {
+        int id = first;
+        for (auto& quad : list) {
+            quad.label = id++;
+            int target = is_jump(quad.op) ? jump_target(quad) : n;
+            if (target < 0) {
+                int p = -1 - target;
+                quad.result = std::to_string(p < static_cast<int>(list.size()) ? first + p : follow);
+            }
+            else if (target < n) {
+                quad.result = std::to_string(landing[target]);
+            }
+            result.push_back(std::move(quad));
+        }
+    };
+    for (int i = 0; i < n; i++) {
+        emit(edits.before[i], firstBefore[i], landing[i]);
+        if (!edits.removed[i]) {
+            Quadruple quad = std::move(quads[i]);
+            quad.label = i;
+            if (is_jump(quad.op)) {
+                int target = jump_target(quad) - base;
+                bool toBefore = redirect[i] && target < n && !edits.before[target].empty();
+                quad.result = std::to_string(toBefore ? firstBefore[target] : landing[target]);
+            }
+            result.push_back(std::move(quad));
+        }
+        int follow = n;
+        if (i + 1 < n) follow = edits.before[i + 1].empty() ? landing[i + 1] : firstBefore[i + 1];
+        emit(edits.after[i], firstAfter[i], follow);
+    }
+    relabel_quads(result, base, n);
+    quads.swap(result);
+}
+
+std::function<std::string()> temp_allocator(const std::vector<Quadruple>& quads) {
+    int next = 0;
+    for (const auto& quad : quads) {
+        for (const std::string* name : { &quad.arg1, &quad.arg2, &quad.result }) {
+            if (is_temp(*name) && name->size() > 1) next = std::max(next, std::stoi(name->substr(1)));
+        }
+    }
+    return [next]() mutable { return "T" + std::to_string(++next); };
+}
+
+Quadruple clone_quad(const Quadruple& quad, int base_label, const std::unordered_map<std::string, std::string>& rename,
+    const std::function<int(int)>& retarget) {
+    Quadruple copy = quad;
+    bool jump = is_jump(quad.op);
+    for (std::string* name : { &copy.arg1, &copy.arg2, &copy.result }) {
+        if (jump && name == &copy.result) continue;
+        auto it = rename.find(*name);
+        if (it != rename.end()) *name = it->second;
+    }
+    if (jump) copy.result = std::to_string(retarget(jump_target(quad) - base_label));
+    return copy;
+}
+
+BlockWork block_work(const std::vector<Quadruple>& quads, const CFG& cfg, int block) {
+    BlockWork work;
+    work.block = block;
+    work.quads.assign(quads.begin() + cfg.first_quad(block), quads.begin() + cfg.last_quad(block) + 1);
+    work.removed.assign(work.quads.size(), 0);
+    return work;
+}
+
+void merge_block_work(std::vector<Quadruple>& quads, const std::vector<BlockWork>& works) {
+    std::vector<char> removed(quads.size(), 0);
+    std::unordered_map<std::string, std::string> rename;
+    bool any = false;
+    size_t at = 0;
+    for (const auto& work : works) {
+        for (size_t k = 0; k < work.quads.size(); k++, at++) {
+            quads[at] = work.quads[k];
+            removed[at] = work.removed[k];
+            any = any || removed[at];
+        }
+        for (const auto& entry : work.renames) rename.insert(entry);
+    }
+    if (at != quads.size()) throw std::runtime_error("基本块工作单元未覆盖全部四元式");
+    if (!rename.empty()) {
+        // 一个块中删去的临时变量可能改名为另一个块中也被删去的临时变量，改名沿链找到终点
+        for (auto& entry : rename) {
+            auto it = rename.find(entry.second);
+            while (it != rename.end()) {
+                entry.second = it->second;
+                it = rename.find(entry.second);
+            }
+        }
+        for (auto& quad : quads) {
+            for (std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                auto it = rename.find(*arg);
+                if (it != rename.end()) *arg = it->second;
+            }
+        }
+    }
+    if (any) remove_quads(quads, removed);
+}
+
+int NameCounts::defs_of(const std::string& name) const {
+    auto it = defs.find(name);
+    return it == defs.end() ? 0 : it->second;
+}
+
+int NameCounts::uses_of(const std::string& name) const {
+    auto it = uses.find(name);
+    return it == uses.end() ? 0 : it->second;
+}
+
+NameCounts count_names(const std::vector<Quadruple>& quads) {
+    NameCounts counts;
+    for (const auto& quad : quads) {
+        for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+            if (!arg->empty() && !is_number(*arg)) counts.uses[*arg]++;
+        }
+        if (!is_jump(quad.op) && !quad.result.empty()) counts.defs[quad.result]++;
+    }
+    return counts;
+}
+
+// 按源块把边表整理成压缩数组
+static void build_csr(int num_blocks, const std::vector<std::pair<int, int>>& edges,
+    std::vector<int>& offset, std::vector<int>& list) {
+    offset.assign(num_blocks + 1, 0);
+    for (const auto& edge : edges) {
+        offset[edge.first + 1]++;
+    }
+    for (int i = 0; i < num_blocks; i++) {
+        offset[i + 1] += offset[i];
+    }
+    list.assign(edges.size(), 0);
+    std::vector<int> fill(offset.begin(), offset.end() - 1);
+    for (const auto& edge : edges) {
+        list[fill[edge.first]++] = edge.second;
+    }
+}
+
+// 由四元式序列划分基本块并建立控制流图
+CFG build_cfg(const std::vector<Quadruple>& quads) {
+    CFG cfg;
+    int n = static_cast<int>(quads.size());
+    cfg.base_label = n > 0 ? quads[0].label : 100;
+    for (int i = 0; i < n; i++) {
+        if (quads[i].label != cfg.base_label + i) {
+            throw std::runtime_error("四元式标号不连续：" + std::to_string(quads[i].label));
+        }
+    }
+
+    // 1. 找入口语句：第一条四元式、跳转目标、跳转与跳转表之后的一条
+    std::vector<char> leader(n + 1, 0);
+    if (n > 0) leader[0] = 1;
+    for (int i = 0; i < n; i++) {
+        if (switch_entries(quads[i]) > 0) leader[i + 1] = 1;
+        if (!is_jump(quads[i].op)) continue;
+        int target = jump_target(quads[i]) - cfg.base_label;
+        if (target >= 0 && target < n) leader[target] = 1;
+        leader[i + 1] = 1;
+    }
+
+    // 2. 划分基本块
+    cfg.block_of_quad.assign(n, 0);
+    for (int i = 0; i < n; i++) {
+        if (leader[i]) cfg.block_start.push_back(i);
+        cfg.block_of_quad[i] = static_cast<int>(cfg.block_start.size()) - 1;
+    }
+    cfg.block_start.push_back(n);
+    int num_blocks = cfg.num_blocks();
+
+    // 3. 建立边：块尾为无条件跳转时只有跳转边，条件跳转另有顺序边，跳转表到各表项，其余只有顺序边
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(num_blocks * 2);
+    for (int b = 0; b < num_blocks; b++) {
+        const Quadruple& last = quads[cfg.last_quad(b)];
+        if (int entries = switch_entries(last)) {
+            for (int k = 1; k <= entries && cfg.last_quad(b) + k < n; k++) {
+                edges.push_back({ b, cfg.block_of_quad[cfg.last_quad(b) + k] });
+            }
+            continue;
+        }
+        int fall = b + 1 < num_blocks ? b + 1 : -1;
+        int taken = -1;
+        bool exits = b + 1 == num_blocks;
+        if (is_jump(last.op)) {
+            int target = jump_target(last) - cfg.base_label;
+            if (target >= 0 && target < n) taken = cfg.block_of_quad[target];
+            else exits = true;
+            if (!is_cond_jump(last.op)) {
+                fall = -1;
+                if (taken >= 0 && b + 1 == num_blocks) exits = false;
+            }
+        }
+        if (exits) cfg.exits.push_back(b);
+        if (taken >= 0) edges.push_back({ b, taken });
+        if (fall >= 0 && fall != taken) edges.push_back({ b, fall });
+    }
+    build_csr(num_blocks, edges, cfg.succ_offset, cfg.succ);
+    for (auto& edge : edges) {
+        std::swap(edge.first, edge.second);
+    }
+    build_csr(num_blocks, edges, cfg.pred_offset, cfg.pred);
+    return cfg;
+}
+
+// Cooper-Harvey-Kennedy 迭代算法计算直接支配块
+void compute_dominators(CFG& cfg) {
+    int num_blocks = cfg.num_blocks();
+    cfg.rpo.clear();
+    cfg.rpo_index.assign(num_blocks, -1);
+    cfg.idom.assign(num_blocks, -1);
+    cfg.dom_pre.assign(num_blocks, -1);
+    cfg.dom_post.assign(num_blocks, -1);
+    if (num_blocks == 0) return;
+
+    // 1. 非递归深度优先遍历求后序，再反转得到逆后序
+    std::vector<int> postorder;
+    postorder.reserve(num_blocks);
+    std::vector<char> visited(num_blocks, 0);
+    std::vector<std::pair<int, int>> stack;  // (块, 下一个待访问的后继位置)
+    stack.push_back({ 0, cfg.succ_begin(0) });
+    visited[0] = 1;
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second < cfg.succ_end(top.first)) {
+            int next = cfg.succ[top.second++];
+            if (!visited[next]) {
+                visited[next] = 1;
+                stack.push_back({ next, cfg.succ_begin(next) });
+            }
+        }
+        else {
+            postorder.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+    cfg.rpo.assign(postorder.rbegin(), postorder.rend());
+    for (int i = 0; i < static_cast<int>(cfg.rpo.size()); i++) {
+        cfg.rpo_index[cfg.rpo[i]] = i;
+    }
+
+    // 2. 按逆后序迭代，直到直接支配块不再变化
+    //    两个块的公共支配者沿 idom 链向上求交，比较的是逆后序位置
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (cfg.rpo_index[a] > cfg.rpo_index[b]) a = cfg.idom[a];
+            while (cfg.rpo_index[b] > cfg.rpo_index[a]) b = cfg.idom[b];
+        }
+        return a;
+    };
+    int entry = cfg.rpo[0];
+    cfg.idom[entry] = entry;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < cfg.rpo.size(); i++) {
+            int b = cfg.rpo[i];
+            int new_idom = -1;
+            for (int p = cfg.pred_begin(b); p < cfg.pred_end(b); p++) {
+                int pred = cfg.pred[p];
+                if (cfg.idom[pred] < 0) continue;  // 尚未处理或不可达
+                new_idom = new_idom < 0 ? pred : intersect(pred, new_idom);
+            }
+            if (new_idom != cfg.idom[b]) {
+                cfg.idom[b] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    // 3. 支配树先序/后序编号
+    std::vector<int> child_offset(num_blocks + 1, 0), children;
+    for (int b : cfg.rpo) {
+        if (b != entry) child_offset[cfg.idom[b] + 1]++;
+    }
+    for (int i = 0; i < num_blocks; i++) child_offset[i + 1] += child_offset[i];
+    children.assign(cfg.rpo.size(), 0);
+    std::vector<int> fill(child_offset.begin(), child_offset.end() - 1);
+    for (int b : cfg.rpo) {
+        if (b != entry) children[fill[cfg.idom[b]]++] = b;
+    }
+    int pre = 0, post = 0;
+    std::vector<std::pair<int, int>> walk;
+    walk.push_back({ entry, child_offset[entry] });
+    cfg.dom_pre[entry] = pre++;
+    while (!walk.empty()) {
+        auto& top = walk.back();
+        if (top.second < child_offset[top.first + 1]) {
+            int child = children[top.second++];
+            cfg.dom_pre[child] = pre++;
+            walk.push_back({ child, child_offset[child] });
+        }
+        else {
+            cfg.dom_post[top.first] = post++;
+            walk.pop_back();
+        }
+    }
+}
+
+// 根据回边找出全部自然循环
+std::vector<Loop> find_loops(const CFG& cfg) {
+    int num_blocks = cfg.num_blocks();
+    std::vector<Loop> loops;
+    std::vector<int> loop_of_header(num_blocks, -1);
+
+    // 1. 回边 latch -> header：header 支配 latch
+    for (int b : cfg.rpo) {
+        for (int s = cfg.succ_begin(b); s < cfg.succ_end(b); s++) {
+            int header = cfg.succ[s];
+            if (!cfg.dominates(header, b)) continue;
+            if (loop_of_header[header] < 0) {
+                loop_of_header[header] = static_cast<int>(loops.size());
+                loops.push_back(Loop());
+                loops.back().header = header;
+            }
+            loops[loop_of_header[header]].latches.push_back(b);
+        }
+    }
+
+    // 2. 从回边源块沿前驱反向搜索到循环头，得到循环体
+    std::vector<int> mark(num_blocks, -1);
+    std::vector<int> worklist;
+    for (size_t l = 0; l < loops.size(); l++) {
+        Loop& loop = loops[l];
+        mark[loop.header] = static_cast<int>(l);
+        loop.blocks.push_back(loop.header);
+        for (int latch : loop.latches) {
+            if (mark[latch] != static_cast<int>(l)) {
+                mark[latch] = static_cast<int>(l);
+                loop.blocks.push_back(latch);
+                worklist.push_back(latch);
+            }
+        }
+        while (!worklist.empty()) {
+            int b = worklist.back();
+            worklist.pop_back();
+            for (int p = cfg.pred_begin(b); p < cfg.pred_end(b); p++) {
+                int pred = cfg.pred[p];
+                if (!cfg.reachable(pred) || mark[pred] == static_cast<int>(l)) continue;
+                mark[pred] = static_cast<int>(l);
+                loop.blocks.push_back(pred);
+                worklist.push_back(pred);
+            }
+        }
+        std::sort(loop.blocks.begin(), loop.blocks.end());
+    }
+
+    // 3. 按循环体大小排序后确定嵌套关系：依次把块归入最内层循环，
+    //    已属于更小循环的块沿外层链找到最外层，再把它挂到当前循环下
+    std::stable_sort(loops.begin(), loops.end(), [](const Loop& a, const Loop& b) {
+        return a.blocks.size() < b.blocks.size();
+    });
+    std::vector<int> innermost(num_blocks, -1);
+    for (size_t l = 0; l < loops.size(); l++) {
+        for (int b : loops[l].blocks) {
+            if (innermost[b] < 0) {
+                innermost[b] = static_cast<int>(l);
+                continue;
+            }
+            int outer = innermost[b];
+            while (loops[outer].parent >= 0) outer = loops[outer].parent;
+            if (outer != static_cast<int>(l)) loops[outer].parent = static_cast<int>(l);
+        }
+    }
+    for (size_t l = loops.size(); l-- > 0;) {
+        if (loops[l].parent >= 0) loops[l].depth = loops[loops[l].parent].depth + 1;
+    }
+    return loops;
+}
+
+// 打印基本块、支配树与循环信息
+void dump_cfg(const CFG& cfg, const std::vector<Loop>& loops, std::ostream& out) {
+    for (int b = 0; b < cfg.num_blocks(); b++) {
+        out << "B" << b << " [" << cfg.base_label + cfg.first_quad(b) << "-"
+            << cfg.base_label + cfg.last_quad(b) << "]";
+        if (!cfg.rpo_index.empty() && !cfg.reachable(b)) {
+            out << " 不可达";
+        }
+        else if (!cfg.idom.empty()) {
+            out << " idom=B" << cfg.idom[b];
+        }
+        out << " ->";
+        for (int s = cfg.succ_begin(b); s < cfg.succ_end(b); s++) {
+            out << " B" << cfg.succ[s];
+        }
+        out << "\n";
+    }
+    for (const auto& loop : loops) {
+        out << "循环 头=B" << loop.header << " 深度=" << loop.depth << " 回边来自";
+        for (int latch : loop.latches) out << " B" << latch;
+        out << " 循环体";
+        for (int b : loop.blocks) out << " B" << b;
+        out << "\n";
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+#ifndef CFG_H
+#define CFG_H
+
+#include "assembler.h"
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 四元式操作分类
+bool is_jump(const std::string& op);       // j 与 j<rop>
+bool is_cond_jump(const std::string& op);  // j<rop>
+int jump_target(const Quadruple& quad);    // 跳转四元式的目标标号
+// 跳转表 (switch, i, n, )：按 i 的值 0..n-1 转到其后第 i+1 条四元式，其后 n 条都是 j，即各表项。
+// 由 lower_switches 在其他优化遍之后生成，i 总在范围内（之前已做越界检查）。非跳转表返回0
+int switch_entries(const Quadruple& quad);
+std::string invert_relop(const std::string& op);  // j< <-> j>=，j> <-> j<=，j= <-> j<>
+std::string mirror_relop(const std::string& op);  // 交换两个运算对象：j< <-> j>，j<= <-> j>=
+
+// 删除 removed 中标记的四元式，并从第一条的标号起重新连续编号。
+// 跳转目标指向被删四元式时改指其后第一条保留的四元式，跳出程序的目标改为新的出口标号
+void remove_quads(std::vector<Quadruple>& quads, const std::vector<char>& removed);
+// 插入或重排四元式后重新编号。调用前每条四元式的 label 是互不相同的非负编号，
+// 跳转四元式的 result 是目标四元式的编号，exit_id 表示跳出程序；
+// 调用后按当前顺序从 base_label 起连续编号，跳转目标换成对应的标号
+void relabel_quads(std::vector<Quadruple>& quads, int base_label, int exit_id);
+// 对四元式序列的一组编辑：在某条之前或之后插入、删除某条、把某条跳转改跳到目标之前插入的第一条
+// （例如循环外跳到循环头的跳转改跳前置块）。apply_edits 按原顺序排列后重新编号；
+// 跳到被删四元式的跳转落到其后第一条留下或插入的四元式上。
+// 插入的跳转四元式的 result 写目标四元式在原序列中的下标（跳出程序为 n），不改跳到目标之前插入的
+// 四元式，目标被删时同样落到其后第一条留下或插入的四元式上；
+// 写负数 -1-p 时表示同一插入序列中的第 p 条，p 等于序列长度时表示该序列之后顺序执行到的四元式
+struct QuadEdits {
+    explicit QuadEdits(size_t n) : before(n), after(n), removed(n, 0) {}
+    std::vector<std::vector<Quadruple>> before, after;
+    std::vector<char> removed;
+    std::vector<int> redirected;  // 跳转四元式的下标
+    bool empty() const;
+};
+void apply_edits(std::vector<Quadruple>& quads, QuadEdits& edits);
+struct CFG;
+
+// 基本块内的遍处理的一个块：quads 是块内四元式的副本，遍就地改写运算并在 removed 中标记删除，
+// 不插入四元式，也不改动跳转与标号。被删临时变量在块外的引用由 renames 统一改名（只可改名
+// 只定值一次的临时变量，各块的改名互不冲突）。counts 是遍自定的分项统计，合并时按块相加
+struct BlockWork {
+    int block = 0;
+    std::vector<Quadruple> quads;
+    std::vector<char> removed;
+    std::vector<std::pair<std::string, std::string>> renames;
+    int counts[4] = { 0, 0, 0, 0 };
+};
+// 取出第 block 块的工作单元
+BlockWork block_work(const std::vector<Quadruple>& quads, const CFG& cfg, int block);
+// 按块的顺序把各块的结果写回四元式序列：改写的四元式放回原位，对全程序的运算对象做改名，
+// 再删除标记的四元式并重新编号。works 按块号排列并覆盖全部块
+void merge_block_work(std::vector<Quadruple>& quads, const std::vector<BlockWork>& works);
+// 每个名字在整个程序中被定值（跳转之外的结果）与引用（非常数的运算对象）的次数
+struct NameCounts {
+    std::unordered_map<std::string, int> defs, uses;
+    int defs_of(const std::string& name) const;
+    int uses_of(const std::string& name) const;
+};
+NameCounts count_names(const std::vector<Quadruple>& quads);
+// 程序中未使用过的临时变量名：返回的函数每次调用给出 T<n+1>、T<n+2>…（n 为现有最大编号）
+std::function<std::string()> temp_allocator(const std::vector<Quadruple>& quads);
+// 复制一段四元式（循环体等）中的一条，放入插入序列：运算对象与结果按 rename 换名，条件跳转的运算对象
+// 同样换名；跳转的 result 不换名，由 retarget 把目标四元式的原下标换成 apply_edits 约定的编号
+Quadruple clone_quad(const Quadruple& quad, int base_label, const std::unordered_map<std::string, std::string>& rename,
+    const std::function<int(int)>& retarget);
+
+// 四元式序列上的控制流图
+// 基本块、边都存放在紧凑数组中：块i包含四元式 [block_start[i], block_start[i+1])，
+// 后继为 succ[succ_offset[i] .. succ_offset[i+1])，前驱同理。
+// 跳到最后一条四元式之后（程序出口）的边不记入后继，这样的块记在 exits 中
+struct CFG {
+    int base_label = 0;                // 第一条四元式的标号
+    std::vector<int> block_start;      // 长度为块数+1，最后一项为四元式总数
+    std::vector<int> block_of_quad;    // 四元式下标 -> 所在块
+    std::vector<int> succ_offset, succ;
+    std::vector<int> pred_offset, pred;
+    std::vector<int> exits;            // 可能跳出程序或顺序执行到末尾的块
+
+    // 以下由 compute_dominators 填写；不可达块的 rpo_index 与 idom 为 -1
+    std::vector<int> rpo;              // 从入口块出发的逆后序
+    std::vector<int> rpo_index;        // 块 -> 在 rpo 中的位置
+    std::vector<int> idom;             // 直接支配块，入口块的 idom 为自身
+    std::vector<int> dom_pre, dom_post;  // 支配树先序/后序编号，用于 O(1) 判断支配关系
+
+    int num_blocks() const { return static_cast<int>(block_start.size()) - 1; }
+    int first_quad(int block) const { return block_start[block]; }
+    int last_quad(int block) const { return block_start[block + 1] - 1; }
+    int succ_begin(int block) const { return succ_offset[block]; }
+    int succ_end(int block) const { return succ_offset[block + 1]; }
+    int pred_begin(int block) const { return pred_offset[block]; }
+    int pred_end(int block) const { return pred_offset[block + 1]; }
+    bool reachable(int block) const { return rpo_index[block] >= 0; }
+    // a 是否支配 b（两者都须可达）
+    bool dominates(int a, int b) const {
+        return dom_pre[a] <= dom_pre[b] && dom_post[b] <= dom_post[a];
+    }
+};
+
+// 自然循环：由回边 latch -> header（header 支配 latch）确定，同一循环头的回边合并
+struct Loop {
+    int header;
+    std::vector<int> latches;  // 回边的源块
+    std::vector<int> blocks;   // 循环体内的块（含 header），按块号排序
+    int parent = -1;           // 直接外层循环，-1 表示最外层
+    int depth = 1;             // 嵌套深度，最外层为1
+};
+
+// 由四元式序列划分基本块并建立控制流图，要求四元式标号连续
+CFG build_cfg(const std::vector<Quadruple>& quads);
+// Cooper-Harvey-Kennedy 迭代算法计算直接支配块
+void compute_dominators(CFG& cfg);
+// 根据回边找出全部自然循环，结果按循环体大小从小到大排列（内层在前）
+std::vector<Loop> find_loops(const CFG& cfg);
+// 打印基本块、支配树与循环信息
+void dump_cfg(const CFG& cfg, const std::vector<Loop>& loops, std::ostream& out);
+
+#endif // CFG_H
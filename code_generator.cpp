@@ -1,125 +1,421 @@
 #include "code_generator.h"
+#include "cfg.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 
-CodeGenerator::CodeGenerator() : labelCounter(0), tempVarCounter(0) {}
+namespace {
 
-std::string CodeGenerator::newTemp() {
-    return "T" + std::to_string(++tempVarCounter);
+// 表达式求值用的寄存器，按求值深度依次使用；AX、DX 留给 imul
+const char* const REGISTERS[] = { "BX", "CX", "SI", "DI" };
+const int NUM_REGISTERS = 4;
+
+bool isLeaf(const Node* node) {
+    return node->children.empty();
+}
+
+// 两个运算对象可以交换：比较交换后换成镜像的关系运算符
+bool isCommutative(const Node* node) {
+    return node->type == "Condition" || node->value == "+" || node->value == "*";
+}
+
+// 叶子在汇编中的写法：变量名或十进制立即数
+std::string leafOperand(const Node* node) {
+    if (node->type == "Number") return std::to_string(static_cast<uint16_t>(std::stol(node->value))) + "D";
+    return node->value;
+}
+
+bool isImmediate(const std::string& operand) {
+    return !operand.empty() && std::isdigit(static_cast<unsigned char>(operand[0]));
+}
+
+bool isRegister(const std::string& operand) {
+    return std::find(std::begin(REGISTERS), std::end(REGISTERS), operand) != std::end(REGISTERS);
+}
+
+// 条件跳转四元式对应的有符号条件转移指令
+std::string jumpInstruction(const std::string& op) {
+    if (op == "j<") return "jl";
+    if (op == "j<=") return "jle";
+    if (op == "j>") return "jg";
+    if (op == "j>=") return "jge";
+    if (op == "j=") return "je";
+    if (op == "j<>") return "jne";
+    throw std::runtime_error("未知的关系运算符：" + op);
+}
+
+void collectVariables(const Node* node, std::set<std::string>& vars) {
+    if (node->type == "Identifier") vars.insert(node->value);
+    for (const Node* child : node->children) collectVariables(child, vars);
+}
+
+}
+
+CodeGenerator::CodeGenerator() : labelCounter(0), tempVarCounter(0), maxTemps(0), maxRegisters(0),
+spillCount(0), spillDepth(0), maxSpills(0), instructionCount(0) {}
+
+// 求值深度为 depth 的结果放在第 depth+1 个临时变量中
+std::string CodeGenerator::newTemp(int depth) {
+    tempVarCounter = depth + 1;
+    maxTemps = std::max(maxTemps, tempVarCounter);
+    return "T" + std::to_string(tempVarCounter);
 }
 
 std::string CodeGenerator::newLabel() {
     return "L" + std::to_string(++labelCounter);
 }
 
-std::vector<std::string> CodeGenerator::generateQuadruples(Node* ast) {
-    std::vector<std::string> quadruples;
+// 标出子树的 Sethi-Ullman 数：两个叶子需要1个寄存器；一侧是可作运算对象的叶子时与另一侧相同；
+// 否则两侧相同时加1，不同时取大者
+int CodeGenerator::label(const Node* node) {
+    if (isLeaf(node)) return 1;
+    auto it = needs.find(node);
+    if (it != needs.end()) return it->second;
+    const Node* left = node->children[0];
+    const Node* right = node->children[1];
+    int l = label(left), r = label(right);
+    int result;
+    if (isLeaf(left) && isLeaf(right)) result = 1;
+    else if (isLeaf(right)) result = l;
+    else if (isLeaf(left) && isCommutative(node)) result = r;
+    else result = l == r ? l + 1 : std::max(l, r);
+    needs[node] = result;
+    return result;
+}
+
+// 作左操作数的叶子要先装入寄存器，作右操作数的不用
+int CodeGenerator::need(const Node* node, bool left) const {
+    if (isLeaf(node)) return left ? 1 : 0;
+    return needs.at(node);
+}
+
+/******************** 四元式 ********************/
 
-    // ﷨Ԫʽ
+int CodeGenerator::emitQuad(const std::string& op, const std::string& arg1, const std::string& arg2,
+    const std::string& result) {
+    quadruples.push_back(Quad{ op, arg1, arg2, result });
+    return static_cast<int>(quadruples.size()) - 1;
+}
+
+std::vector<std::string> CodeGenerator::generateQuadruples(Node* ast) {
+    quadruples.clear();
+    needs.clear();
+    maxTemps = 0;
     processNode(ast);
 
-    return quadruples;
+    std::vector<std::string> lines;
+    for (size_t i = 0; i < quadruples.size(); i++) {
+        const Quad& quad = quadruples[i];
+        std::stringstream ss;
+        ss << 100 + i << " (" << quad.op << "," << quad.arg1 << ", " << quad.arg2 << ", " << quad.result << ")";
+        lines.push_back(ss.str());
+    }
+    return lines;
 }
 
 void CodeGenerator::processNode(Node* node) {
     if (node == nullptr) return;
 
-    if (node->type == "Expression") {
-        processExpression(node);
-    }
-    else if (node->type == "Statement") {
+    if (node->type == "Statement") {
         processStatement(node);
+        return;
     }
-
-    // ݹ鴦ӽڵ
+    // 程序与复合语句：依次处理各语句
     for (auto child : node->children) {
         processNode(child);
     }
 }
 
-void CodeGenerator::processExpression(Node* node) {
-    if (node->children.size() == 2) {  // Ԫ
-        std::string result = newTemp();
-        std::string op = node->value;
-        std::string arg1 = node->children[0]->value;
-        std::string arg2 = node->children[1]->value;
-
-        std::stringstream ss;
-        ss << "(" << op << ", " << arg1 << ", " << arg2 << ", " << result << ")";
-        quadruples.push_back(ss.str());
+// 返回表达式的值所在的名字：叶子是自身，内部节点是深度 depth 的临时变量。
+// 先算需要临时变量多的一侧，另一侧在更深一层求值
+std::string CodeGenerator::processExpression(Node* node, int depth) {
+    if (isLeaf(node)) return node->value;
+    Node* left = node->children[0];
+    Node* right = node->children[1];
+    std::string arg1, arg2;
+    if (isLeaf(left) || isLeaf(right) || need(left, true) >= need(right, true)) {
+        arg1 = processExpression(left, depth);
+        arg2 = processExpression(right, isLeaf(left) ? depth : depth + 1);
+    }
+    else {
+        arg2 = processExpression(right, depth);
+        arg1 = processExpression(left, depth + 1);
+    }
+    std::string result = newTemp(depth);
+    emitQuad(node->value, arg1, arg2, result);
+    return result;
+}
 
-        node->value = result;  // ½ڵֵΪʱ
+// 生成条件不成立时的跳转，返回其下标以便回填
+int CodeGenerator::processCondition(Node* node) {
+    label(node);
+    Node* left = node->children[0];
+    Node* right = node->children[1];
+    std::string arg1, arg2;
+    if (isLeaf(left) || isLeaf(right) || need(left, true) >= need(right, true)) {
+        arg1 = processExpression(left, 0);
+        arg2 = processExpression(right, isLeaf(left) ? 0 : 1);
     }
+    else {
+        arg2 = processExpression(right, 0);
+        arg1 = processExpression(left, 1);
+    }
+    return emitQuad(invert_relop("j" + node->value), arg1, arg2, "0");
 }
 
 void CodeGenerator::processStatement(Node* node) {
-    if (node->value == "if") {
-        std::string labelTrue = newLabel();
-        std::string labelEnd = newLabel();
-
-        // жϵԪʽ
-        std::stringstream ss;
-        ss << "(jnz, " << node->children[0]->value << ", , " << labelTrue << ")";
-        quadruples.push_back(ss.str());
-
-        // thenֵĴ
+    auto backPatch = [this](int jump) {
+        quadruples[jump].result = std::to_string(100 + quadruples.size());
+    };
+    if (node->value == ":=") {
+        label(node->children[1]);
+        std::string value = processExpression(node->children[1], 0);
+        emitQuad(":=", value, "", node->children[0]->value);
+    }
+    else if (node->value == "if") {
+        int falseJump = processCondition(node->children[0]);
         processNode(node->children[1]);
-
-        // תԪʽ
-        ss.str("");
-        ss << "(j, , , " << labelEnd << ")";
-        quadruples.push_back(ss.str());
-
-        // elseֵıǩ
-        ss.str("");
-        ss << labelTrue << ":";
-        quadruples.push_back(ss.str());
-
-        // elseֵĴ
         if (node->children.size() > 2) {
+            int skipElse = emitQuad("j", "", "", "0");
+            backPatch(falseJump);
             processNode(node->children[2]);
+            backPatch(skipElse);
+        }
+        else {
+            backPatch(falseJump);
         }
-
-        // ɽǩ
-        ss.str("");
-        ss << labelEnd << ":";
-        quadruples.push_back(ss.str());
     }
     else if (node->value == "while") {
-        std::string labelStart = newLabel();
-        std::string labelBody = newLabel();
-        std::string labelEnd = newLabel();
+        int start = 100 + static_cast<int>(quadruples.size());
+        int exitJump = processCondition(node->children[0]);
+        processNode(node->children[1]);
+        emitQuad("j", "", "", std::to_string(start));
+        backPatch(exitJump);
+    }
+}
 
-        // ѭʼǩ
-        std::stringstream ss;
-        ss << labelStart << ":";
-        quadruples.push_back(ss.str());
+/******************** 汇编 ********************/
 
-        // жϵԪʽ
-        ss.str("");
-        ss << "(jnz, " << node->children[0]->value << ", , " << labelBody << ")";
-        quadruples.push_back(ss.str());
+void CodeGenerator::emit(const std::string& op, const std::string& a, const std::string& b) {
+    std::string line = "    " + op;
+    if (!a.empty()) line += " " + a;
+    if (!b.empty()) line += ", " + b;
+    code.push_back(line);
+    instructionCount++;
+}
+
+std::vector<std::string> CodeGenerator::generateAssembly(Node* ast) {
+    code.clear();
+    needs.clear();
+    labelCounter = 0;
+    maxRegisters = 0;
+    spillCount = 0;
+    spillDepth = 0;
+    maxSpills = 0;
+    instructionCount = 0;
+    assembleNode(ast);
 
-        // תԪʽ
-        ss.str("");
-        ss << "(j, , , " << labelEnd << ")";
-        quadruples.push_back(ss.str());
+    std::set<std::string> vars;
+    if (ast) collectVariables(ast, vars);
+    std::vector<std::string> lines;
+    lines.push_back(";************************************");
+    lines.push_back(";*  由语法树生成的汇编文件           *");
+    lines.push_back(";************************************");
+    lines.push_back("");
+    lines.push_back("data segment   ");
+    for (const auto& var : vars) {
+        lines.push_back("    " + var + "           DW ?");
+    }
+    for (int slot = 1; slot <= maxSpills; slot++) {
+        lines.push_back("    _S" + std::to_string(slot) + "           DW ?");
+    }
+    lines.push_back("data ends      ");
+    lines.push_back("");
+    lines.push_back("code segment    ");
+    lines.push_back("main proc far   ");
+    lines.push_back("    assume cs:code,ds:data");
+    lines.push_back("");
+    lines.push_back("start:");
+    lines.push_back("    push ds");
+    lines.push_back("    sub bx,bx");
+    lines.push_back("    push bx");
+    lines.push_back("    mov bx,data");
+    lines.push_back("    mov ds,bx");
+    lines.insert(lines.end(), code.begin(), code.end());
+    lines.push_back("    ret");
+    lines.push_back("main endp");
+    lines.push_back("code ends");
+    lines.push_back("    end start");
+    return lines;
+}
 
-        // ѭǩ
-        ss.str("");
-        ss << labelBody << ":";
-        quadruples.push_back(ss.str());
+void CodeGenerator::assembleNode(Node* node) {
+    if (node == nullptr) return;
 
-        // ѭ
-        processNode(node->children[1]);
+    if (node->type == "Statement") {
+        assembleStatement(node);
+        return;
+    }
+    for (auto child : node->children) {
+        assembleNode(child);
+    }
+}
+
+// 把子树的值算到第 base 个寄存器中
+void CodeGenerator::assembleExpression(Node* node, int base) {
+    maxRegisters = std::max(maxRegisters, base + 1);
+    if (isLeaf(node)) {
+        emit("mov", REGISTERS[base], leafOperand(node));
+        return;
+    }
+    std::string left, right;
+    assembleOperands(node, base, left, right);
+    combine(node->value, base, left, right);
+}
+
+// 算出二元节点的两个运算对象，返回它们的写法（寄存器、变量或立即数）。
+// 两侧都不是叶子时，所需寄存器不超过剩余寄存器的一侧可以在另一侧之后用更深的寄存器求值；
+// 两侧都超过时先算右侧存入溢出单元，再用全部剩余寄存器算左侧
+void CodeGenerator::assembleOperands(Node* node, int base, std::string& left, std::string& right) {
+    Node* l = node->children[0];
+    Node* r = node->children[1];
+    if (isLeaf(l) && isLeaf(r)) {
+        left = leafOperand(l);
+        right = leafOperand(r);
+        return;
+    }
+    if (isLeaf(r)) {
+        assembleExpression(l, base);
+        left = REGISTERS[base];
+        right = leafOperand(r);
+        return;
+    }
+    if (isLeaf(l) && isCommutative(node)) {
+        assembleExpression(r, base);
+        left = leafOperand(l);
+        right = REGISTERS[base];
+        return;
+    }
+    int available = NUM_REGISTERS - base;
+    int leftNeed = need(l, true), rightNeed = need(r, true);
+    if (leftNeed >= available && rightNeed >= available) {
+        assembleExpression(r, base);
+        std::string slot = "_S" + std::to_string(++spillDepth);
+        maxSpills = std::max(maxSpills, spillDepth);
+        spillCount++;
+        emit("mov", slot, REGISTERS[base]);
+        assembleExpression(l, base);
+        spillDepth--;  // 溢出单元在随后的运算中读出后即可重用
+        left = REGISTERS[base];
+        right = slot;
+    }
+    else if (leftNeed >= rightNeed) {
+        assembleExpression(l, base);
+        assembleExpression(r, base + 1);
+        left = REGISTERS[base];
+        right = REGISTERS[base + 1];
+    }
+    else {
+        assembleExpression(r, base);
+        assembleExpression(l, base + 1);
+        left = REGISTERS[base + 1];
+        right = REGISTERS[base];
+    }
+}
 
-        // ѭʼԪʽ
-        ss.str("");
-        ss << "(j, , , " << labelStart << ")";
-        quadruples.push_back(ss.str());
+// 计算 left op right，结果放在第 base 个寄存器中
+void CodeGenerator::combine(const std::string& op, int base, const std::string& left, const std::string& right) {
+    std::string target = REGISTERS[base];
+    std::string dst = left, src = right;
+    if (right == target && left != target) {
+        if (op == "+" || op == "*") std::swap(dst, src);  // 不可交换时在左侧的寄存器中算，再移过来
+    }
+    else if (left != target) {
+        emit("mov", target, left);
+        dst = target;
+    }
+    if (op == "+") {
+        emit("add", dst, src);
+    }
+    else if (op == "-") {
+        emit("sub", dst, src);
+    }
+    else if (op == "*") {
+        // imul 只有单操作数形式：DX:AX = AX * r/m16
+        emit("mov", "AX", dst);
+        if (isImmediate(src)) {
+            emit("mov", "DX", src);
+            emit("imul", "DX");
+        }
+        else {
+            emit("imul", src);
+        }
+        emit("mov", dst, "AX");
+    }
+    else {
+        throw std::runtime_error("无法生成的运算：" + op);
+    }
+    if (dst != target) emit("mov", target, dst);
+}
 
-        // ɽǩ
-        ss.str("");
-        ss << labelEnd << ":";
-        quadruples.push_back(ss.str());
+// 比较条件的两侧，返回条件成立时应转移的关系（形如 j<，两侧交换过时是镜像关系）
+std::string CodeGenerator::assembleCondition(Node* node) {
+    label(node);
+    std::string left, right;
+    assembleOperands(node, 0, left, right);
+    std::string op = "j" + node->value;
+    if (isImmediate(left) && !isImmediate(right)) {
+        std::swap(left, right);
+        op = mirror_relop(op);
+    }
+    if (isImmediate(left) || (!isRegister(left) && !isRegister(right) && !isImmediate(right))) {
+        // cmp 不能以立即数作左操作数，也不能两侧都是内存字
+        maxRegisters = std::max(maxRegisters, 1);
+        emit("mov", REGISTERS[0], left);
+        left = REGISTERS[0];
     }
-}
\ No newline at end of file
+    emit("cmp", left, right);
+    return op;
+}
+
+void CodeGenerator::assembleStatement(Node* node) {
+    if (node->value == ":=") {
+        Node* value = node->children[1];
+        const std::string& name = node->children[0]->value;
+        label(value);
+        if (value->type == "Number") {
+            emit("mov", name, leafOperand(value));
+            return;
+        }
+        assembleExpression(value, 0);
+        emit("mov", name, REGISTERS[0]);
+    }
+    else if (node->value == "if") {
+        std::string elseLabel = newLabel();
+        std::string op = assembleCondition(node->children[0]);
+        emit(jumpInstruction(invert_relop(op)), elseLabel);
+        assembleNode(node->children[1]);
+        if (node->children.size() > 2) {
+            std::string endLabel = newLabel();
+            emit("jmp", endLabel);
+            code.push_back(elseLabel + ":");
+            assembleNode(node->children[2]);
+            code.push_back(endLabel + ":");
+        }
+        else {
+            code.push_back(elseLabel + ":");
+        }
+    }
+    else if (node->value == "while") {
+        std::string startLabel = newLabel(), endLabel = newLabel();
+        code.push_back(startLabel + ":");
+        std::string op = assembleCondition(node->children[0]);
+        emit(jumpInstruction(invert_relop(op)), endLabel);
+        assembleNode(node->children[1]);
+        emit("jmp", startLabel);
+        code.push_back(endLabel + ":");
+    }
+}
@@ -1,26 +1,65 @@
-#pragma once
-#include "node.h"
-#include <vector>
-#include <string>
-
-class CodeGenerator {
-public:
-    CodeGenerator();
-
-    // Ԫʽ
-    std::vector<std::string> generateQuadruples(Node* ast);
-
-    // ɻ루ѡ֣
-    std::vector<std::string> generateAssembly(const std::vector<std::string>& quadruples);
-
-private:
-    int labelCounter;
-    int tempVarCounter;
-    std::vector<std::string> quadruples;
-
-    std::string newTemp();
-    std::string newLabel();
-    void processNode(Node* node);
-    void processExpression(Node* node);
-    void processStatement(Node* node);
-};
+#pragma once
+#include "node.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 由语法树直接生成代码的后端，与“四元式→优化→汇编”的路径并行。
+// 表达式先按 Sethi-Ullman 方法为每棵子树标出求值所需的寄存器数，求值时先算需要多的一侧，
+// 使一个表达式同时占用的寄存器（生成四元式时为临时变量）最少。8086 的运算指令右操作数
+// 可以是内存字或立即数，叶子作右操作数时不占寄存器；+、* 与比较可交换，叶子在哪一侧都行
+class CodeGenerator {
+public:
+    CodeGenerator();
+
+    // 生成四元式，格式与语法分析器输出的相同，从100起编号，可由 parse_quads 读入。
+    // 临时变量按求值的深度编号 T1、T2…，各表达式重复使用
+    std::vector<std::string> generateQuadruples(Node* ast);
+
+    // 生成完整的8086汇编程序。表达式在 BX、CX、SI、DI 中求值，AX、DX 留给乘法；
+    // 所需寄存器多于剩余寄存器的两棵子树，先算右侧存入数据段的溢出单元 _S<k> 再算左侧
+    std::vector<std::string> generateAssembly(Node* ast);
+
+    int getTempCount() const { return maxTemps; }           // 四元式用到的临时变量个数
+    int getRegisterCount() const { return maxRegisters; }   // 汇编中表达式同时占用的寄存器数
+    int getSpillCount() const { return spillCount; }        // 存入溢出单元的次数
+    int getInstructionCount() const { return instructionCount; }  // 汇编指令条数（不含程序框架）
+
+private:
+    struct Quad {
+        std::string op, arg1, arg2, result;
+    };
+
+    int labelCounter;
+    int tempVarCounter;
+    int maxTemps;
+    int maxRegisters;
+    int spillCount;
+    int spillDepth;
+    int maxSpills;
+    int instructionCount;
+    std::vector<Quad> quadruples;
+    std::vector<std::string> code;
+    std::unordered_map<const Node*, int> needs;  // 内部节点 -> Sethi-Ullman 数
+
+    std::string newTemp(int depth);
+    std::string newLabel();
+    int label(const Node* node);
+    int need(const Node* node, bool left) const;
+
+    // 四元式
+    int emitQuad(const std::string& op, const std::string& arg1, const std::string& arg2, const std::string& result);
+    void processNode(Node* node);
+    std::string processExpression(Node* node, int depth);
+    int processCondition(Node* node);
+    void processStatement(Node* node);
+
+    // 汇编
+    void emit(const std::string& op, const std::string& a = "", const std::string& b = "");
+    void assembleNode(Node* node);
+    void assembleExpression(Node* node, int base);
+    void assembleOperands(Node* node, int base, std::string& left, std::string& right);
+    void combine(const std::string& op, int base, const std::string& left, const std::string& right);
+    std::string assembleCondition(Node* node);
+    void assembleStatement(Node* node);
+};
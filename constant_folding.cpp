@@ -0,0 +1,199 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <unordered_map>
+
+int16_t constant_value(const std::string& s) {
+    return static_cast<int16_t>(std::stol(s));
+}
+
+std::string constant_string(int16_t value) {
+    return std::to_string(static_cast<uint16_t>(value));
+}
+
+bool is_arith(const std::string& op) {
+    return op == "+" || op == "-" || op == "*" || op == "/";
+}
+
+bool evaluate_arith(const std::string& op, int16_t a, int16_t b, int16_t& result) {
+    if (op == "+") result = static_cast<int16_t>(a + b);
+    else if (op == "-") result = static_cast<int16_t>(a - b);
+    else if (op == "*") result = static_cast<int16_t>(a * b);
+    else if (op == "/") {
+        if (b == 0 || (a == INT16_MIN && b == -1)) return false;
+        result = static_cast<int16_t>(a / b);
+    }
+    else return false;
+    return true;
+}
+
+bool evaluate_relop(const std::string& op, int16_t a, int16_t b) {
+    if (op == "j<") return a < b;
+    if (op == "j<=") return a <= b;
+    if (op == "j>") return a > b;
+    if (op == "j>=") return a >= b;
+    if (op == "j=") return a == b;
+    if (op == "j<>") return a != b;
+    return false;
+}
+
+bool increment_step(const Quadruple& quad, const std::string& v, int& step) {
+    if (quad.op == "+" && quad.arg1 == v && is_number(quad.arg2)) step = constant_value(quad.arg2);
+    else if (quad.op == "+" && quad.arg2 == v && is_number(quad.arg1)) step = constant_value(quad.arg1);
+    else if (quad.op == "-" && quad.arg1 == v && is_number(quad.arg2)) step = -constant_value(quad.arg2);
+    else return false;
+    return true;
+}
+
+namespace {
+
+// 代数恒等式：能化简时把结果写入 value（一个运算对象或常数0）
+bool simplify(const Quadruple& quad, std::string& value) {
+    auto isConst = [](const std::string& s, int v) {
+        return is_number(s) && constant_value(s) == v;
+    };
+    const std::string& a = quad.arg1;
+    const std::string& b = quad.arg2;
+    if (quad.op == "+") {
+        if (isConst(b, 0)) value = a;
+        else if (isConst(a, 0)) value = b;
+        else return false;
+    }
+    else if (quad.op == "-") {
+        if (isConst(b, 0)) value = a;
+        else if (a == b) value = "0";
+        else return false;
+    }
+    else if (quad.op == "*") {
+        if (isConst(a, 0) || isConst(b, 0)) value = "0";
+        else if (isConst(b, 1)) value = a;
+        else if (isConst(a, 1)) value = b;
+        else return false;
+    }
+    else if (quad.op == "/") {
+        if (isConst(b, 1)) value = a;
+        else return false;
+    }
+    else return false;
+    return true;
+}
+
+}
+
+// 常量合并与代数化简
+// 块内记录已知为常数的名字，以及只赋值一次的临时变量复制自哪个名字，向后替换引用；
+// 只赋值一次且值为常数的临时变量在整个程序中替换为常数并删除其定值，
+// 复制临时变量只有在全部引用都已在块内替换时才删除
+FoldStats constant_folding(std::vector<Quadruple>& quads) {
+    FoldStats stats;
+    if (quads.empty()) return stats;
+
+    std::unordered_map<std::string, int> defCount, useCount;
+    for (const auto& quad : quads) {
+        if (!is_jump(quad.op) && !quad.result.empty()) defCount[quad.result]++;
+        if (is_temp(quad.arg1)) useCount[quad.arg1]++;
+        if (is_temp(quad.arg2)) useCount[quad.arg2]++;
+    }
+    auto singleTemp = [&](const std::string& name) {
+        return is_temp(name) && defCount[name] == 1;
+    };
+
+    CFG cfg = build_cfg(quads);
+    std::vector<char> removed(quads.size(), 0);
+    std::unordered_map<std::string, std::string> globalConst;  // 常数临时变量 -> 常数
+    std::unordered_map<std::string, int> replaced;             // 临时变量被替换掉的引用数
+    std::vector<std::pair<int, std::string>> copyDefs;         // 可能删除的复制临时变量定值
+
+    for (int b = 0; b < cfg.num_blocks(); b++) {
+        std::unordered_map<std::string, std::string> known;  // 名字 -> 常数或被复制的名字
+        std::unordered_map<std::string, std::vector<std::string>> copiesOf;
+        auto kill = [&](const std::string& name) {
+            known.erase(name);
+            auto it = copiesOf.find(name);
+            if (it == copiesOf.end()) return;
+            for (const auto& temp : it->second) {
+                auto k = known.find(temp);
+                if (k != known.end() && k->second == name) known.erase(k);
+            }
+            copiesOf.erase(it);
+        };
+        auto substitute = [&](std::string& arg) {
+            auto it = known.find(arg);
+            std::string value;
+            if (it != known.end()) value = it->second;
+            else {
+                auto g = globalConst.find(arg);
+                if (g == globalConst.end()) return;
+                value = g->second;
+            }
+            if (is_temp(arg)) replaced[arg]++;
+            arg = value;
+        };
+
+        for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+            Quadruple& quad = quads[i];
+            substitute(quad.arg1);
+            substitute(quad.arg2);
+
+            if (is_cond_jump(quad.op)) {
+                if (is_number(quad.arg1) && is_number(quad.arg2)) {
+                    if (evaluate_relop(quad.op, constant_value(quad.arg1), constant_value(quad.arg2))) {
+                        quad = Quadruple{ quad.label, "j", "", "", quad.result };
+                    }
+                    else {
+                        removed[i] = 1;
+                    }
+                    stats.jumps++;
+                }
+                continue;
+            }
+            if (is_jump(quad.op) || quad.result.empty()) continue;
+
+            if (is_arith(quad.op)) {
+                int16_t value;
+                std::string operand;
+                if (is_number(quad.arg1) && is_number(quad.arg2) &&
+                    evaluate_arith(quad.op, constant_value(quad.arg1), constant_value(quad.arg2), value)) {
+                    quad = Quadruple{ quad.label, ":=", constant_string(value), "", quad.result };
+                    stats.folded++;
+                }
+                else if (simplify(quad, operand)) {
+                    quad = Quadruple{ quad.label, ":=", operand, "", quad.result };
+                    stats.simplified++;
+                }
+            }
+
+            kill(quad.result);
+            if (quad.op != ":=") continue;
+            if (quad.arg1 == quad.result) {
+                removed[i] = 1;
+                continue;
+            }
+            if (is_number(quad.arg1)) {
+                known[quad.result] = quad.arg1;
+                if (singleTemp(quad.result)) {
+                    globalConst[quad.result] = quad.arg1;
+                    removed[i] = 1;
+                }
+            }
+            else if (singleTemp(quad.result)) {
+                known[quad.result] = quad.arg1;
+                copiesOf[quad.arg1].push_back(quad.result);
+                copyDefs.push_back({ i, quad.result });
+            }
+        }
+    }
+
+    // 循环回边上先于定值出现的常数临时变量引用
+    for (auto& quad : quads) {
+        for (std::string* arg : { &quad.arg1, &quad.arg2 }) {
+            auto g = globalConst.find(*arg);
+            if (g != globalConst.end()) *arg = g->second;
+        }
+    }
+    for (const auto& def : copyDefs) {
+        if (replaced[def.second] == useCount[def.second]) removed[def.first] = 1;
+    }
+    for (char r : removed) stats.removed += r;
+    if (stats.removed > 0) remove_quads(quads, removed);
+    return stats;
+}
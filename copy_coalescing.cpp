@@ -0,0 +1,70 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <unordered_map>
+
+// 复制传播与合并
+// 只处理整个程序中恰好定值一次、引用一次，且定值与引用在同一基本块内的临时变量：
+//   (op,x,y,T) … (:=,T,,v)  =>  (op,x,y,v)   中间的四元式不读写 v
+//   (:=,x,,T) … (…,T,…)     =>  (…,x,…)      中间的四元式不改写 x
+// 语句 a:=a+1 翻译成的 (+,a,1,T1) (:=,T1,,a) 因此合并为 (+,a,1,a)
+// 块内部分：counts[0] 为合并的运算数，counts[1] 为代入的复制数
+void coalesce_copies_in_block(BlockWork& work, const NameCounts& names) {
+    std::vector<Quadruple>& quads = work.quads;
+    std::vector<char>& removed = work.removed;
+    int n = static_cast<int>(quads.size());
+    std::unordered_map<std::string, int> defAt;
+    for (int i = 0; i < n; i++) {
+        if (!is_jump(quads[i].op) && is_temp(quads[i].result)) defAt[quads[i].result] = i;
+    }
+
+    // from 与 to 之间（不含两端）未删除的四元式是否引用或改写 name
+    auto touchedBetween = [&](int from, int to, const std::string& name, bool readsToo) {
+        for (int k = from + 1; k < to; k++) {
+            if (removed[k]) continue;
+            const Quadruple& quad = quads[k];
+            if (!is_jump(quad.op) && quad.result == name) return true;
+            if (readsToo && (quad.arg1 == name || quad.arg2 == name)) return true;
+        }
+        return false;
+    };
+    for (int j = 0; j < n; j++) {
+        Quadruple& use = quads[j];
+        for (std::string* arg : { &use.arg1, &use.arg2 }) {
+            if (!is_temp(*arg) || names.defs_of(*arg) != 1 || names.uses_of(*arg) != 1) continue;
+            auto at = defAt.find(*arg);
+            if (at == defAt.end()) continue;
+            int i = at->second;
+            if (i >= j || removed[i]) continue;
+            Quadruple& def = quads[i];
+            if (use.op == ":=" && arg == &use.arg1 && !touchedBetween(i, j, use.result, true)) {
+                def.result = use.result;
+                if (is_temp(def.result)) defAt[def.result] = i;
+                removed[j] = 1;
+                work.counts[0]++;
+                break;
+            }
+            if (def.op == ":=" && !touchedBetween(i, j, def.arg1, false)) {
+                *arg = def.arg1;
+                removed[i] = 1;
+                work.counts[1]++;
+            }
+        }
+    }
+}
+
+CoalesceStats coalesce_copies(std::vector<Quadruple>& quads) {
+    CoalesceStats stats;
+    if (quads.empty()) return stats;
+    NameCounts names = count_names(quads);
+    CFG cfg = build_cfg(quads);
+    std::vector<BlockWork> works;
+    for (int b = 0; b < cfg.num_blocks(); b++) {
+        works.push_back(block_work(quads, cfg, b));
+        coalesce_copies_in_block(works.back(), names);
+        stats.merged += works.back().counts[0];
+        stats.propagated += works.back().counts[1];
+    }
+    stats.removed = stats.merged + stats.propagated;
+    merge_block_work(quads, works);
+    return stats;
+}
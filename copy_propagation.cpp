@@ -0,0 +1,95 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include "ssa.h"
+#include <numeric>
+#include <unordered_map>
+
+// 全局复制传播（在SSA视图上）
+// 复制 x := y 定义的值与 y 的当前值相同，四元式中对 x 这个值的引用改为引用 y 的值。
+// 只传播整个程序中只有一个值的 y（只赋值一次或从不赋值的变量、只定值一次的临时变量）：
+// y 的值延长生存期后不会与 y 的其他值重叠，退出SSA时无需换名或补复制。
+// φ参数与程序出口仍引用 x 的值，复制本身在这些引用都不存在时由死代码删除去掉。
+// 另外，除自身外参数都是同一个值的φ函数在所有引用处用这个值代替
+CopyPropStats propagate_copies(std::vector<Quadruple>& quads) {
+    CopyPropStats stats;
+    if (quads.empty()) return stats;
+    CFG cfg = build_cfg(quads);
+    compute_dominators(cfg);
+    SSAForm ssa = build_ssa(quads, cfg);
+    int n = static_cast<int>(quads.size());
+    int num_values = ssa.num_values();
+
+    // 值 -> 代替它的值，带路径压缩；phiOf 只含φ函数的代替，copyOf 另含复制
+    auto find = [](std::vector<int>& replace, int v) {
+        int root = v;
+        while (replace[root] != root) root = replace[root];
+        while (replace[v] != root) {
+            int next = replace[v];
+            replace[v] = root;
+            v = next;
+        }
+        return root;
+    };
+    std::vector<int> phiOf(num_values);
+    std::iota(phiOf.begin(), phiOf.end(), 0);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& phi : ssa.phis) {
+            if (find(phiOf, phi.value) != phi.value) continue;
+            int same = -1;
+            bool trivial = true;
+            for (int arg : phi.args) {
+                if (arg < 0) continue;
+                arg = find(phiOf, arg);
+                if (arg == phi.value || arg == same) continue;
+                if (same >= 0) {
+                    trivial = false;
+                    break;
+                }
+                same = arg;
+            }
+            if (!trivial || same < 0) continue;
+            phiOf[phi.value] = same;
+            stats.phis++;
+            changed = true;
+        }
+    }
+
+    std::vector<int> valuesOfName(ssa.names.size(), 0);
+    for (const auto& value : ssa.values) valuesOfName[value.name]++;
+    std::unordered_map<std::string, int> uses;
+    for (const auto& quad : quads) {
+        for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+            if (is_temp(*arg)) uses[*arg]++;
+        }
+    }
+    std::vector<int> copyOf(num_values);
+    for (int v = 0; v < num_values; v++) copyOf[v] = find(phiOf, v);
+    for (int i = 0; i < n; i++) {
+        int from = ssa.def_value[i], to = ssa.use_value[2 * i];
+        // 只被这条复制引用的临时变量留给复制合并，把运算直接写入 x
+        if (quads[i].op != ":=" || from < 0 || to < 0 || (is_temp(quads[i].arg1) && uses[quads[i].arg1] == 1)) continue;
+        to = find(copyOf, to);
+        if (valuesOfName[ssa.values[to].name] != 1 || to == from) continue;
+        copyOf[from] = to;
+        stats.copies++;
+    }
+    if (stats.copies == 0 && stats.phis == 0) return stats;
+
+    for (int& value : ssa.use_value) {
+        if (value >= 0) value = find(copyOf, value);
+    }
+    for (auto& phi : ssa.phis) {
+        for (int& arg : phi.args) {
+            if (arg >= 0) arg = find(phiOf, arg);
+        }
+    }
+    for (int& value : ssa.exit_values) {
+        if (value >= 0) value = find(phiOf, value);
+    }
+    SSADestructStats destruct = destruct_ssa(quads, cfg, ssa);
+    stats.renamed = destruct.renamed;
+    stats.inserted = destruct.copies;
+    return stats;
+}
@@ -0,0 +1,158 @@
+#pragma once
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include "assembler.h"
+#include "cfg.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 定长位向量，按64位字存放
+class BitVector {
+public:
+    BitVector() {}
+    explicit BitVector(size_t bits) : size_(bits), words((bits + 63) / 64, 0) {}
+
+    size_t size() const { return size_; }
+    bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(size_t i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(size_t i) { words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    void clear() { std::fill(words.begin(), words.end(), 0); }
+
+    // 并入 other，返回是否有位发生变化
+    bool unite(const BitVector& other) {
+        uint64_t changed = 0;
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t next = words[w] | other.words[w];
+            changed |= next ^ words[w];
+            words[w] = next;
+        }
+        return changed != 0;
+    }
+    // 与 other 求交，返回是否有位发生变化
+    bool intersect(const BitVector& other) {
+        uint64_t changed = 0;
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t next = words[w] & other.words[w];
+            changed |= next ^ words[w];
+            words[w] = next;
+        }
+        return changed != 0;
+    }
+    // this = gen ∪ (in - kill)
+    void transfer(const BitVector& gen, const BitVector& in, const BitVector& kill) {
+        for (size_t w = 0; w < words.size(); w++) {
+            words[w] = gen.words[w] | (in.words[w] & ~kill.words[w]);
+        }
+    }
+    // 按位号从小到大对每个置位的位调用 f
+    template <class F>
+    void for_each(F f) const {
+        for (size_t w = 0; w < words.size(); w++) {
+            size_t bit = w * 64;
+            for (uint64_t word = words[w]; word != 0; word >>= 1, bit++) {
+                if (word & 1) f(bit);
+            }
+        }
+    }
+    bool operator==(const BitVector& other) const { return words == other.words; }
+    bool operator!=(const BitVector& other) const { return words != other.words; }
+
+private:
+    size_t size_ = 0;
+    std::vector<uint64_t> words;
+};
+
+// 通用数据流求解器。Problem 描述格与传递函数：
+//   using Value = ...;                          格元素类型（通常为 BitVector）
+//   static constexpr bool forward;              前向或后向问题
+//   Value top() const;                          除边界外各块的初值
+//   Value boundary() const;                     入口（前向）或出口（后向）处的值
+//   bool meet(Value& into, const Value& from) const;  into = into ∧ from，返回是否变化
+//   void transfer(int block, const Value& input, Value& output) const;
+// 只计算从入口可达的块。工作表按逆后序（后向问题按逆后序的反序）处理，
+// 使每个块尽量在其前驱（后向为后继）都处理之后才处理
+template <class Value>
+struct DataflowResult {
+    std::vector<Value> in, out;  // 块首、块尾的值
+    long long visits = 0;        // 传递函数的调用次数
+};
+
+template <class Problem>
+DataflowResult<typename Problem::Value> solve_dataflow(const CFG& cfg, const Problem& problem) {
+    using Value = typename Problem::Value;
+    int num_blocks = cfg.num_blocks();
+    DataflowResult<Value> result;
+    result.in.assign(num_blocks, problem.top());
+    result.out.assign(num_blocks, problem.top());
+    if (cfg.rpo.empty()) return result;
+
+    // order[k]：第k个处理的块；position：块 -> k
+    std::vector<int> order(cfg.rpo);
+    if (!Problem::forward) std::reverse(order.begin(), order.end());
+    std::vector<int> position(num_blocks, -1);
+    for (size_t k = 0; k < order.size(); k++) position[order[k]] = static_cast<int>(k);
+    std::vector<char> atBoundary(num_blocks, 0);
+    if (Problem::forward) atBoundary[cfg.rpo[0]] = 1;
+    else for (int b : cfg.exits) atBoundary[b] = 1;
+
+    // 工作表：pending[k] 标记待处理的块。每一轮按 k 从小到大扫描，处理过程中加入的
+    // 位置在当前位置之后的块本轮就会处理，之前的留到下一轮
+    std::vector<char> pending(order.size(), 1);
+    size_t remaining = order.size();
+    const Value top = problem.top();
+    const Value boundary = problem.boundary();
+    Value next = top;
+
+    while (remaining > 0) {
+        for (size_t k = 0; k < order.size() && remaining > 0; k++) {
+            if (!pending[k]) continue;
+            pending[k] = 0;
+            remaining--;
+            int b = order[k];
+            // 前向：in = ∧ out[前驱]，out = f(in)；后向：out = ∧ in[后继]，in = f(out)
+            Value& input = Problem::forward ? result.in[b] : result.out[b];
+            Value& output = Problem::forward ? result.out[b] : result.in[b];
+            input = atBoundary[b] ? boundary : top;
+            int begin = Problem::forward ? cfg.pred_begin(b) : cfg.succ_begin(b);
+            int end = Problem::forward ? cfg.pred_end(b) : cfg.succ_end(b);
+            const std::vector<int>& edges = Problem::forward ? cfg.pred : cfg.succ;
+            for (int e = begin; e < end; e++) {
+                int other = edges[e];
+                if (position[other] < 0) continue;
+                problem.meet(input, Problem::forward ? result.out[other] : result.in[other]);
+            }
+            problem.transfer(b, input, next);
+            result.visits++;
+            if (next == output) continue;
+            std::swap(output, next);
+            begin = Problem::forward ? cfg.succ_begin(b) : cfg.pred_begin(b);
+            end = Problem::forward ? cfg.succ_end(b) : cfg.pred_end(b);
+            const std::vector<int>& dependents = Problem::forward ? cfg.succ : cfg.pred;
+            for (int e = begin; e < end; e++) {
+                int other = position[dependents[e]];
+                if (other >= 0 && !pending[other]) {
+                    pending[other] = 1;
+                    remaining++;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// 活跃变量分析：程序出口处普通变量都活跃（其值即程序结果），临时变量不活跃。
+// 位向量只包含普通变量和跨块引用的临时变量，块内局部的临时变量在任何块边界上都不活跃
+struct Liveness {
+    std::vector<std::string> names;              // 位号 -> 名字
+    std::unordered_map<std::string, int> index;  // 名字 -> 位号
+    std::vector<BitVector> use, def;        // 每块：先引用后定值的名字、定值的名字
+    std::vector<BitVector> live_in, live_out;
+    long long visits = 0;
+};
+Liveness compute_liveness(const std::vector<Quadruple>& quads, const CFG& cfg);
+
+#endif // DATAFLOW_H
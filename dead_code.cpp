@@ -0,0 +1,48 @@
+#include "optimizer.h"
+#include "dataflow.h"
+#include <unordered_set>
+
+// 死代码删除
+// 在每个块内从块尾的活跃集合出发逆序扫描：结果不活跃的赋值与运算没有其他作用，直接删除；
+// 删除后引用它的四元式也可能变为死代码，跨块的连锁删除需要重新分析
+DCEStats eliminate_dead_code(std::vector<Quadruple>& quads) {
+    DCEStats stats;
+    while (!quads.empty()) {
+        CFG cfg = build_cfg(quads);
+        compute_dominators(cfg);
+        Liveness live = compute_liveness(quads, cfg);
+        stats.rounds++;
+
+        std::vector<char> removed(quads.size(), 0);
+        int count = 0;
+        std::unordered_set<std::string> local;  // 块内局部名字中当前活跃的
+        for (int b : cfg.rpo) {
+            BitVector current = live.live_out[b];
+            local.clear();
+            for (int i = cfg.last_quad(b); i >= cfg.first_quad(b); i--) {
+                const Quadruple& quad = quads[i];
+                if (!is_jump(quad.op) && !quad.result.empty()) {
+                    auto it = live.index.find(quad.result);
+                    bool alive = it != live.index.end() ? current.test(it->second) : local.count(quad.result) > 0;
+                    if (!alive) {
+                        removed[i] = 1;
+                        count++;
+                        continue;
+                    }
+                    if (it != live.index.end()) current.reset(it->second);
+                    else local.erase(quad.result);
+                }
+                for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                    if (arg->empty() || is_number(*arg)) continue;
+                    auto it = live.index.find(*arg);
+                    if (it != live.index.end()) current.set(it->second);
+                    else local.insert(*arg);
+                }
+            }
+        }
+        if (count == 0) break;
+        remove_quads(quads, removed);
+        stats.removed += count;
+    }
+    return stats;
+}
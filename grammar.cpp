@@ -0,0 +1,182 @@
+#include "grammar.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+Grammar::Grammar(const std::string& n, const std::vector<Production>& p)
+    : name(n), productions(p) {
+    for (const auto& prod : productions) {
+        nonTerminals.insert(prod.left);
+    }
+    for (const auto& prod : productions) {
+        for (const auto& symbol : prod.right) {
+            if (isTerminal(symbol)) {
+                terminals.insert(symbol);
+            }
+        }
+    }
+    if (!productions.empty() && !productions[0].right.empty()) {
+        start = productions[0].right[0];
+    }
+}
+
+Grammar Grammar::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("无法打开文法文件：" + filename);
+    }
+    std::string content((std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    return parse(content, filename);
+}
+
+namespace {
+
+std::runtime_error grammarError(int line, const std::string& message) {
+    return std::runtime_error("文法第" + std::to_string(line) + "行：" + message);
+}
+
+}
+
+Grammar Grammar::parse(const std::string& text, const std::string& defaultName) {
+    Grammar grammar;
+    grammar.name = defaultName;
+
+    // 先收集各条规则的右部，待声明全部读完后再检查符号
+    struct Alternative {
+        std::string left;
+        std::vector<std::string> right;
+        int line;
+    };
+    std::vector<Alternative> alternatives;
+    std::string currentLeft;  // 续行所属的左部
+    bool hasTerminals = false;
+
+    std::istringstream input(text);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(input, line)) {
+        lineNo++;
+        std::istringstream words(line);
+        std::vector<std::string> tokens;
+        std::string word;
+        while (words >> word) {
+            tokens.push_back(word);
+        }
+        if (tokens.empty() || tokens[0][0] == '#') continue;  // 空行或注释
+
+        // 声明行
+        if (tokens[0][0] == '%') {
+            const std::string& directive = tokens[0];
+            if (directive == "%grammar") {
+                grammar.name = line.substr(line.find(directive) + directive.size());
+                grammar.name.erase(0, grammar.name.find_first_not_of(" \t"));
+                grammar.name.erase(grammar.name.find_last_not_of(" \t\r") + 1);
+            }
+            else if (directive == "%terminals") {
+                grammar.terminals.insert(tokens.begin() + 1, tokens.end());
+                hasTerminals = true;
+            }
+            else if (directive == "%nonterminals") {
+                grammar.nonTerminals.insert(tokens.begin() + 1, tokens.end());
+            }
+            else if (directive == "%start") {
+                if (tokens.size() != 2) {
+                    throw grammarError(lineNo, "%start 需要且只需要一个符号");
+                }
+                grammar.start = tokens[1];
+            }
+            else {
+                throw grammarError(lineNo, "未知的声明 " + directive);
+            }
+            currentLeft.clear();
+            continue;
+        }
+
+        // 规则行：A -> α | β，或以|开头的续行
+        size_t pos = 0;
+        if (tokens[0] == "|") {
+            if (currentLeft.empty()) {
+                throw grammarError(lineNo, "续行之前没有规则");
+            }
+        }
+        else {
+            if (tokens.size() < 2 || tokens[1] != "->") {
+                throw grammarError(lineNo, "规则应形如 A -> α | β");
+            }
+            currentLeft = tokens[0];
+            pos = 1;
+        }
+
+        // 按|切分候选式
+        Alternative alternative{ currentLeft, {}, lineNo };
+        bool empty = true;  // 当前候选式是否还没有任何内容
+        for (size_t i = pos + 1; i <= tokens.size(); i++) {
+            if (i == tokens.size() || tokens[i] == "|") {
+                if (empty) {
+                    throw grammarError(lineNo, "候选式为空，空产生式请写作 %empty");
+                }
+                alternatives.push_back(alternative);
+                alternative.right.clear();
+                empty = true;
+            }
+            else if (tokens[i] == "%empty") {
+                empty = false;
+            }
+            else {
+                alternative.right.push_back(tokens[i]);
+                empty = false;
+            }
+        }
+    }
+
+    // 检查声明
+    if (!hasTerminals) {
+        throw std::runtime_error("文法缺少 %terminals 声明");
+    }
+    if (grammar.nonTerminals.empty()) {
+        throw std::runtime_error("文法缺少 %nonterminals 声明");
+    }
+    for (const auto& symbol : grammar.terminals) {
+        if (grammar.nonTerminals.count(symbol)) {
+            throw std::runtime_error("符号 " + symbol + " 同时被声明为终结符和非终结符");
+        }
+        if (symbol == "#") {
+            throw std::runtime_error("# 是保留的输入结束符，不能作为终结符");
+        }
+    }
+    if (grammar.start.empty()) {
+        throw std::runtime_error("文法缺少 %start 声明");
+    }
+    if (!grammar.nonTerminals.count(grammar.start)) {
+        throw std::runtime_error("开始符号 " + grammar.start + " 不是非终结符");
+    }
+
+    // 拓广文法：S'->开始符号，名字与已有符号冲突时继续加'
+    std::string augmented = "S'";
+    while (grammar.nonTerminals.count(augmented) || grammar.terminals.count(augmented)) {
+        augmented += "'";
+    }
+    grammar.productions.push_back(Production(augmented, { grammar.start }));
+
+    std::set<std::string> defined;  // 有产生式的非终结符
+    for (const auto& alternative : alternatives) {
+        if (!grammar.nonTerminals.count(alternative.left)) {
+            throw grammarError(alternative.line, alternative.left + " 未声明为非终结符");
+        }
+        for (const auto& symbol : alternative.right) {
+            if (!grammar.nonTerminals.count(symbol) && !grammar.terminals.count(symbol)) {
+                throw grammarError(alternative.line, "符号 " + symbol + " 未声明");
+            }
+        }
+        grammar.productions.push_back(Production(alternative.left, alternative.right));
+        defined.insert(alternative.left);
+    }
+    for (const auto& symbol : grammar.nonTerminals) {
+        if (!defined.count(symbol)) {
+            throw std::runtime_error("非终结符 " + symbol + " 没有产生式");
+        }
+    }
+    grammar.nonTerminals.insert(augmented);
+    return grammar;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "production.h"
+#include <string>
+#include <vector>
+#include <set>
+
+// 文法定义：每个SLRGenerator实例持有一份独立的文法，
+// 因此多个分析表可以在不同线程中同时生成
+struct Grammar {
+    std::string name;                     // 文法名称（打印用）
+    std::vector<Production> productions;  // 第0条为拓广产生式 S'->S
+    std::set<std::string> terminals;
+    std::set<std::string> nonTerminals;   // 含拓广开始符号
+    std::string start;                    // 拓广前的开始符号
+
+    Grammar() {}
+    // 内置文法：产生式左部即为全部非终结符，其余符号为终结符
+    Grammar(const std::string& n, const std::vector<Production>& p);
+
+    bool isTerminal(const std::string& symbol) const {
+        return nonTerminals.find(symbol) == nonTerminals.end();
+    }
+
+    // 从文法文件读取文法，格式错误时抛出std::runtime_error
+    static Grammar load(const std::string& filename);
+    // 解析文法文本，格式如下（#开头为注释）：
+    //   %grammar  算术表达式
+    //   %terminals + * ( ) i
+    //   %nonterminals E
+    //   %start E
+    //   E -> E + E | E * E
+    //      | ( E ) | i
+    // 以|开头的行续接上一条规则，%empty表示空产生式；
+    // 拓广产生式 S'->开始符号 自动加在最前面
+    static Grammar parse(const std::string& text, const std::string& name = "");
+};
@@ -0,0 +1,6 @@
+# 算术表达式文法 G[E]
+%grammar 算术表达式
+%terminals + * ( ) i
+%nonterminals E
+%start E
+E -> E + E | E * E | ( E ) | i
@@ -0,0 +1,10 @@
+# 布尔表达式文法 G[B]，A、O 分别表示 "B and"、"B or"
+%grammar 布尔表达式
+%terminals i rop ( ) not and or
+%nonterminals B A O
+%start B
+B -> i | i rop i | ( B ) | not B
+A -> B and
+B -> A B
+O -> B or
+B -> O B
@@ -0,0 +1,100 @@
+# Pascal 文法（ISO 7185 的主要部分，省略 goto/label 与变体记录）
+# 用于衡量分析表生成器在实际语言规模文法上的表现
+%grammar Pascal
+%terminals program id ( ) ; . , : = const type var procedure function
+%terminals begin end array [ ] of record set file packed ^ .. forward
+%terminals if then else while do repeat until for to downto case with
+%terminals := num string nil not + - * / div mod and or in
+%terminals < <= > >= <>
+%nonterminals Program ProgramHeading IdList Block ConstPart ConstDefs ConstDef Constant
+%nonterminals TypePart TypeDefs TypeDef Type SimpleType StructuredType UnpackedType
+%nonterminals IndexTypes FieldList FieldSection VarPart VarDecls VarDecl
+%nonterminals SubprogramPart SubprogramDecl ProcedureHeading FunctionHeading
+%nonterminals FormalParams FormalSections FormalSection
+%nonterminals CompoundStmt StmtList Stmt SimpleStmt StructuredStmt
+%nonterminals Variable Selectors Selector ExprList ProcCall
+%nonterminals IfStmt CaseStmt CaseList CaseItem WhileStmt RepeatStmt ForStmt WithStmt
+%nonterminals Expr SimpleExpr Term Factor RelOp AddOp MulOp Sign SetCtor SetElems SetElem
+%start Program
+
+Program        -> ProgramHeading ; Block .
+ProgramHeading -> program id | program id ( IdList )
+IdList         -> id | IdList , id
+
+Block          -> ConstPart TypePart VarPart SubprogramPart CompoundStmt
+
+ConstPart      -> %empty | const ConstDefs
+ConstDefs      -> ConstDef | ConstDefs ConstDef
+ConstDef       -> id = Constant ;
+Constant       -> num | Sign num | id | Sign id | string
+
+TypePart       -> %empty | type TypeDefs
+TypeDefs       -> TypeDef | TypeDefs TypeDef
+TypeDef        -> id = Type ;
+Type           -> SimpleType | StructuredType | ^ id
+SimpleType     -> id | ( IdList ) | Constant .. Constant
+StructuredType -> UnpackedType | packed UnpackedType
+UnpackedType   -> array [ IndexTypes ] of Type
+                | record FieldList end
+                | set of SimpleType
+                | file of Type
+IndexTypes     -> SimpleType | IndexTypes , SimpleType
+FieldList      -> FieldSection | FieldList ; FieldSection
+FieldSection   -> IdList : Type | %empty
+
+VarPart        -> %empty | var VarDecls
+VarDecls       -> VarDecl | VarDecls VarDecl
+VarDecl        -> IdList : Type ;
+
+SubprogramPart -> %empty | SubprogramPart SubprogramDecl
+SubprogramDecl -> ProcedureHeading ; Block ;
+                | FunctionHeading ; Block ;
+                | ProcedureHeading ; forward ;
+                | FunctionHeading ; forward ;
+ProcedureHeading -> procedure id | procedure id FormalParams
+FunctionHeading  -> function id : id | function id FormalParams : id
+FormalParams   -> ( FormalSections )
+FormalSections -> FormalSection | FormalSections ; FormalSection
+FormalSection  -> IdList : id
+                | var IdList : id
+                | ProcedureHeading
+                | FunctionHeading
+
+CompoundStmt   -> begin StmtList end
+StmtList       -> Stmt | StmtList ; Stmt
+Stmt           -> SimpleStmt | StructuredStmt
+SimpleStmt     -> %empty
+                | Variable := Expr
+                | ProcCall
+ProcCall       -> id ( ExprList )
+StructuredStmt -> CompoundStmt | IfStmt | CaseStmt | WhileStmt
+                | RepeatStmt | ForStmt | WithStmt
+
+Variable       -> id | id Selectors
+Selectors      -> Selector | Selectors Selector
+Selector       -> [ ExprList ] | . id | ^
+ExprList       -> Expr | ExprList , Expr
+
+IfStmt         -> if Expr then Stmt
+                | if Expr then Stmt else Stmt
+CaseStmt       -> case Expr of CaseList end
+CaseList       -> CaseItem | CaseList ; CaseItem
+CaseItem       -> ExprList : Stmt | %empty
+WhileStmt      -> while Expr do Stmt
+RepeatStmt     -> repeat StmtList until Expr
+ForStmt        -> for id := Expr to Expr do Stmt
+                | for id := Expr downto Expr do Stmt
+WithStmt       -> with ExprList do Stmt
+
+Expr           -> SimpleExpr | SimpleExpr RelOp SimpleExpr
+SimpleExpr     -> Term | Sign Term | SimpleExpr AddOp Term
+Term           -> Factor | Term MulOp Factor
+Factor         -> Variable | num | string | nil
+                | ProcCall | ( Expr ) | not Factor | SetCtor
+SetCtor        -> [ ] | [ SetElems ]
+SetElems       -> SetElem | SetElems , SetElem
+SetElem        -> Expr | Expr .. Expr
+RelOp          -> = | <> | < | <= | > | >= | in
+AddOp          -> + | - | or
+MulOp          -> * | / | div | mod | and
+Sign           -> + | -
@@ -0,0 +1,10 @@
+# 程序语句文法 G[S]，a 表示赋值句，e 表示布尔表达式
+%grammar 程序语句
+%terminals if then else while do begin end a e ;
+%nonterminals S L
+%start S
+S -> if e then S else S
+   | while e do S
+   | begin L end
+   | a
+L -> S | S ; L
@@ -0,0 +1,223 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+// 基本归纳变量 v：循环内对 v 的定值都是 v := v ± 常数，
+// 或者语法分析器生成的 (+,v,d,T) (:=,T,,v) 两条
+struct BasicIV {
+    std::vector<int> updates;  // 给 v 赋值的四元式
+    std::vector<int> steps;    // 对应的增量
+    std::vector<int> chains;   // 经临时变量递增时算出临时变量的四元式，否则为 -1
+};
+
+bool reduce_once(std::vector<Quadruple>& quads, IVStats& stats,
+    const std::function<std::string()>& newTemp) {
+    int n = static_cast<int>(quads.size());
+    int base = quads[0].label;
+    CFG cfg = build_cfg(quads);
+    compute_dominators(cfg);
+    std::vector<Loop> loops = find_loops(cfg);
+    Liveness live = compute_liveness(quads, cfg);
+
+    std::unordered_map<std::string, int> programDefs, programUses;
+    for (const auto& quad : quads) {
+        if (!is_jump(quad.op) && !quad.result.empty()) programDefs[quad.result]++;
+        for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+            if (!arg->empty() && !is_number(*arg)) programUses[*arg]++;
+        }
+    }
+    // 每块所属的最内层循环：find_loops 按大小升序给出，第一个包含它的即最内层
+    std::vector<int> innermost(cfg.num_blocks(), -1);
+    for (int l = 0; l < static_cast<int>(loops.size()); l++) {
+        for (int b : loops[l].blocks) {
+            if (innermost[b] < 0) innermost[b] = l;
+        }
+    }
+
+    QuadEdits edits(n);
+    std::vector<char> touched(n, 0);  // 本轮已被某个循环改写的四元式，外层循环不再处理
+    std::vector<int> member(cfg.num_blocks(), -1);
+    bool changed = false;
+
+    for (int l = 0; l < static_cast<int>(loops.size()); l++) {
+        const Loop& loop = loops[l];
+        for (int b : loop.blocks) member[b] = l;
+        auto inside = [&](int quadIndex) {
+            return quadIndex >= 0 && quadIndex < n && member[cfg.block_of_quad[quadIndex]] == l;
+        };
+        int h = cfg.first_quad(loop.header);
+        if (h > 0 && inside(h - 1) && quads[h - 1].op != "j") continue;  // 同 LICM，前置块不能落在回边上
+
+        // 1. 基本归纳变量
+        std::map<std::string, std::vector<int>> defs;
+        for (int b : loop.blocks) {
+            for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+                if (!is_jump(quads[i].op) && !quads[i].result.empty()) defs[quads[i].result].push_back(i);
+            }
+        }
+        std::map<std::string, BasicIV> basics;
+        for (const auto& entry : defs) {
+            const std::string& v = entry.first;
+            if (is_temp(v)) continue;
+            BasicIV iv;
+            bool ok = true;
+            for (int i : entry.second) {
+                const Quadruple& quad = quads[i];
+                int step = 0, chain = -1;
+                if (touched[i]) ok = false;
+                else if (increment_step(quad, v, step)) {}
+                else if (quad.op == ":=" && is_temp(quad.arg1) && programDefs[quad.arg1] == 1 && i > 0 &&
+                    quads[i - 1].result == quad.arg1 && cfg.block_of_quad[i - 1] == cfg.block_of_quad[i] &&
+                    !touched[i - 1] && increment_step(quads[i - 1], v, step)) {
+                    chain = i - 1;
+                }
+                else ok = false;
+                if (!ok) break;
+                iv.updates.push_back(i);
+                iv.steps.push_back(step);
+                iv.chains.push_back(chain);
+            }
+            if (ok) basics[v] = iv;
+        }
+        if (basics.empty()) continue;
+
+        // 2. 派生归纳变量 w := v * c：前置块中 S := v * c，v 每次递增 d 后 S := S + d*c，
+        //    循环内的乘法改为 w := S
+        std::map<std::pair<std::string, int>, std::string> reduced;  // (v, c) -> S
+        int reducedHere = 0;
+        for (int b : loop.blocks) {
+            for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+                Quadruple& quad = quads[i];
+                if (touched[i] || quad.op != "*") continue;
+                std::string v;
+                int c = 0;
+                if (basics.count(quad.arg1) && is_number(quad.arg2)) {
+                    v = quad.arg1;
+                    c = constant_value(quad.arg2);
+                }
+                else if (basics.count(quad.arg2) && is_number(quad.arg1)) {
+                    v = quad.arg2;
+                    c = constant_value(quad.arg1);
+                }
+                else continue;
+                std::string& s = reduced[{ v, c }];
+                if (s.empty()) {
+                    s = newTemp();
+                    edits.before[h].push_back(Quadruple{ 0, "*", v, constant_string(c), s });
+                    const BasicIV& iv = basics[v];
+                    for (size_t k = 0; k < iv.updates.size(); k++) {
+                        int16_t delta = static_cast<int16_t>(iv.steps[k] * c);
+                        if (delta != 0) edits.after[iv.updates[k]].push_back(Quadruple{ 0, "+", s, constant_string(delta), s });
+                    }
+                }
+                quad = Quadruple{ quad.label, ":=", s, "", quad.result };
+                touched[i] = 1;
+                reducedHere++;
+            }
+        }
+        if (reducedHere == 0) continue;
+        stats.basic += static_cast<int>(basics.size());
+        stats.reduced += reducedHere;
+        changed = true;
+        for (int p = cfg.pred_begin(loop.header); p < cfg.pred_end(loop.header); p++) {
+            int pred = cfg.pred[p];
+            if (member[pred] == l) continue;
+            int last = cfg.last_quad(pred);
+            if (is_jump(quads[last].op) && jump_target(quads[last]) == base + h) edits.redirected.push_back(last);
+        }
+
+        // 3. 线性函数测试替换：循环头末尾的 v 与常数 N 的比较改为 S 与 N*c 的比较。
+        //    要求 v 在循环内只递增一次、增量为正、进入循环时是已知常数，且继续循环的条件是 v<N 或 v<=N；
+        //    这时 v 在循环内的取值范围已知，乘 c 不溢出即可保证比较结果不变
+        int t = cfg.last_quad(loop.header);
+        Quadruple& test = quads[t];
+        if (!is_cond_jump(test.op) || touched[t]) continue;
+        bool vFirst = basics.count(test.arg1) && is_number(test.arg2);
+        bool vSecond = basics.count(test.arg2) && is_number(test.arg1);
+        if (!vFirst && !vSecond) continue;
+        const std::string v = vFirst ? test.arg1 : test.arg2;
+        int bound = constant_value(vFirst ? test.arg2 : test.arg1);
+        const BasicIV& iv = basics[v];
+        if (iv.updates.size() != 1 || iv.steps[0] <= 0) continue;
+        if (innermost[cfg.block_of_quad[iv.updates[0]]] != l) continue;
+        bool takenInside = inside(jump_target(test) - base);
+        if (takenInside == inside(t + 1)) continue;
+        std::string stay = vFirst ? test.op : mirror_relop(test.op);
+        if (!takenInside) stay = invert_relop(stay);
+        if (stay != "j<" && stay != "j<=") continue;
+        // 进入循环时 v 的值：唯一的循环外前驱是顺序执行到循环头的 (:=,常数,,v)
+        int outsidePreds = 0;
+        for (int p = cfg.pred_begin(loop.header); p < cfg.pred_end(loop.header); p++) {
+            outsidePreds += member[cfg.pred[p]] != l;
+        }
+        if (outsidePreds != 1 || h == 0 || inside(h - 1) || quads[h - 1].op != ":=" ||
+            quads[h - 1].result != v || !is_number(quads[h - 1].arg1)) continue;
+        int start = constant_value(quads[h - 1].arg1);
+        long long low = start;
+        long long high = std::max<long long>(start, (stay == "j<" ? bound - 1 : bound) + iv.steps[0]);
+        auto found = reduced.end();
+        for (auto it = reduced.begin(); it != reduced.end(); ++it) {
+            if (it->first.first == v && it->first.second > 0) {
+                found = it;
+                break;
+            }
+        }
+        if (found == reduced.end()) continue;
+        long long c = found->first.second;
+        auto fits = [](long long x) { return x >= -32768 && x <= 32767; };
+        if (!fits(high) || !fits(low * c) || !fits(high * c) || !fits(bound * c)) continue;
+        (vFirst ? test.arg1 : test.arg2) = found->second;
+        (vFirst ? test.arg2 : test.arg1) = constant_string(static_cast<int16_t>(bound * c));
+        touched[t] = 1;
+        stats.replaced++;
+
+        // 4. v 只剩自身的递增、且在各出口都不活跃时，删除递增
+        bool used = false;
+        int update = iv.updates[0], chain = iv.chains[0];
+        for (int b : loop.blocks) {
+            if (std::find(cfg.exits.begin(), cfg.exits.end(), b) != cfg.exits.end()) used = true;
+            for (int i = cfg.first_quad(b); i <= cfg.last_quad(b) && !used; i++) {
+                if (i == update || i == chain) continue;
+                used = quads[i].arg1 == v || quads[i].arg2 == v;
+            }
+            for (int s = cfg.succ_begin(b); s < cfg.succ_end(b) && !used; s++) {
+                int next = cfg.succ[s];
+                if (member[next] == l) continue;
+                auto it = live.index.find(v);
+                used = it != live.index.end() && live.live_in[next].test(it->second);
+            }
+        }
+        if (chain >= 0 && programUses[quads[chain].result] != 1) used = true;
+        if (used) continue;
+        edits.removed[update] = 1;
+        touched[update] = 1;
+        stats.removed++;
+        if (chain >= 0) {
+            edits.removed[chain] = 1;
+            touched[chain] = 1;
+            stats.removed++;
+        }
+    }
+    if (!changed) return false;
+    apply_edits(quads, edits);
+    return true;
+}
+
+}
+
+// 归纳变量强度削弱与线性函数测试替换
+// 内层循环前置块中的 v*c 在外层循环里又可能是派生归纳变量，因此反复进行直到不再变化
+IVStats reduce_induction_variables(std::vector<Quadruple>& quads) {
+    IVStats stats;
+    auto newTemp = temp_allocator(quads);
+    while (!quads.empty() && stats.rounds < 16) {
+        stats.rounds++;
+        if (!reduce_once(quads, stats, newTemp)) break;
+    }
+    return stats;
+}
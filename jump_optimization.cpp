@@ -0,0 +1,101 @@
+#include "optimizer.h"
+#include "cfg.h"
+
+namespace {
+
+// 一轮跳转优化，返回是否有改动
+bool optimize_once(std::vector<Quadruple>& quads, JumpStats& stats) {
+    int n = static_cast<int>(quads.size());
+    int base = quads[0].label;
+    auto indexOf = [&](const Quadruple& quad) { return jump_target(quad) - base; };
+    auto isGoto = [&](int i) { return i >= 0 && i < n && quads[i].op == "j"; };
+    bool changed = false;
+
+    // 1. 穿过无条件跳转：目标仍是 j 时继续向后找，遇到环则停在环上
+    for (int i = 0; i < n; i++) {
+        if (!is_jump(quads[i].op)) continue;
+        int target = indexOf(quads[i]);
+        int steps = 0;
+        while (isGoto(target) && target != i && steps++ < n) {
+            int next = indexOf(quads[target]);
+            if (next == target) break;
+            target = next;
+        }
+        if (target != indexOf(quads[i])) {
+            quads[i].result = std::to_string(base + target);
+            stats.threaded++;
+            changed = true;
+        }
+    }
+
+    std::vector<int> incoming(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        if (!is_jump(quads[i].op)) continue;
+        int target = indexOf(quads[i]);
+        if (target >= 0 && target <= n) incoming[target]++;
+    }
+    std::vector<char> removed(n, 0);
+
+    // 2. (jrop,a,b,L+2) (j,,,X)：条件取反后直接跳到X，删去中间的 j
+    //    只有这条 j 不是其他跳转的目标时才能删除
+    for (int i = 0; i + 1 < n; i++) {
+        if (!is_cond_jump(quads[i].op) || indexOf(quads[i]) != i + 2) continue;
+        if (!isGoto(i + 1) || incoming[i + 1] > 0 || removed[i + 1]) continue;
+        incoming[i + 2]--;
+        quads[i].op = invert_relop(quads[i].op);
+        quads[i].result = quads[i + 1].result;
+        removed[i + 1] = 1;
+        stats.inverted++;
+    }
+
+    // 3. 跳到下一条的跳转（中间被删的四元式不计）
+    for (int i = 0; i < n; i++) {
+        if (removed[i] || !is_jump(quads[i].op)) continue;
+        int next = i + 1;
+        while (next < n && removed[next]) next++;
+        if (indexOf(quads[i]) == next) {
+            removed[i] = 1;
+            stats.to_next++;
+        }
+    }
+
+    // 4. 不可达的四元式
+    int count = 0;
+    for (char r : removed) count += r;
+    if (count > 0) {
+        remove_quads(quads, removed);
+        changed = true;
+        stats.removed += count;
+        n = static_cast<int>(quads.size());
+        if (n == 0) return changed;
+    }
+    CFG cfg = build_cfg(quads);
+    compute_dominators(cfg);
+    removed.assign(n, 0);
+    count = 0;
+    for (int b = 0; b < cfg.num_blocks(); b++) {
+        if (cfg.reachable(b)) continue;
+        for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+            removed[i] = 1;
+            count++;
+        }
+    }
+    if (count > 0) {
+        remove_quads(quads, removed);
+        stats.unreachable += count;
+        stats.removed += count;
+        changed = true;
+    }
+    return changed;
+}
+
+}
+
+// 跳转优化
+// 各步会相互创造机会（删去不可达的 j 后又出现跳到下一条的跳转），反复进行直到不再变化
+JumpStats optimize_jumps(std::vector<Quadruple>& quads) {
+    JumpStats stats;
+    while (!quads.empty() && optimize_once(quads, stats)) {
+    }
+    return stats;
+}
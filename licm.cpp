@@ -0,0 +1,130 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+bool is_pure_arith(const std::string& op) {
+    return op == "+" || op == "-" || op == "*";  // 除法可能因除数为0而中断，不外提
+}
+
+// 一轮外提：外层循环先处理，已被外层外提的四元式不再参与内层循环；返回是否有改动
+bool hoist_once(std::vector<Quadruple>& quads, LICMStats& stats,
+    const std::function<std::string()>& newTemp) {
+    int n = static_cast<int>(quads.size());
+    int base = quads[0].label;
+    CFG cfg = build_cfg(quads);
+    compute_dominators(cfg);
+    std::vector<Loop> loops = find_loops(cfg);
+    Liveness live = compute_liveness(quads, cfg);
+
+    std::unordered_map<std::string, int> programDefs;
+    for (const auto& quad : quads) {
+        if (!is_jump(quad.op) && !quad.result.empty()) programDefs[quad.result]++;
+    }
+
+    QuadEdits edits(n);
+    std::vector<char>& hoisted = edits.removed;
+    std::vector<int> inLoop(cfg.num_blocks(), -1);
+    bool changed = false;
+
+    for (int l = static_cast<int>(loops.size()) - 1; l >= 0; l--) {
+        const Loop& loop = loops[l];
+        for (int b : loop.blocks) inLoop[b] = l;
+        int h = cfg.first_quad(loop.header);
+        // 循环内的块顺序执行进入循环头时，前置块会落在回边上，跳过这样的循环
+        if (h > 0 && inLoop[cfg.block_of_quad[h - 1]] == l && quads[h - 1].op != "j") continue;
+
+        std::unordered_map<std::string, int> loopDefs;
+        std::vector<int> exiting;
+        for (int b : loop.blocks) {
+            for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+                if (!hoisted[i] && !is_jump(quads[i].op) && !quads[i].result.empty()) loopDefs[quads[i].result]++;
+            }
+            bool exits = std::find(cfg.exits.begin(), cfg.exits.end(), b) != cfg.exits.end();
+            for (int s = cfg.succ_begin(b); s < cfg.succ_end(b); s++) {
+                exits = exits || inLoop[cfg.succ[s]] != l;
+            }
+            if (exits) exiting.push_back(b);
+        }
+        auto invariant = [&](const std::string& arg) {
+            if (arg.empty() || is_number(arg)) return true;
+            auto it = loopDefs.find(arg);
+            return it == loopDefs.end() || it->second == 0;
+        };
+        auto liveAtHeader = [&](const std::string& name) {
+            auto it = live.index.find(name);
+            return it != live.index.end() && live.live_in[loop.header].test(it->second);
+        };
+
+        std::vector<int> blocks(loop.blocks);
+        std::sort(blocks.begin(), blocks.end(), [&](int a, int b) {
+            return cfg.rpo_index[a] < cfg.rpo_index[b];
+        });
+        LoopHoist record;
+        record.header_label = base + h;
+        record.depth = loop.depth;
+        std::vector<Quadruple>& moved = edits.before[h];
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            for (int b : blocks) {
+                bool dominatesExits = true;
+                for (int e : exiting) dominatesExits = dominatesExits && cfg.dominates(b, e);
+                for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+                    Quadruple& quad = quads[i];
+                    if (hoisted[i] || !is_pure_arith(quad.op) || quad.result.empty()) continue;
+                    if (!invariant(quad.arg1) || !invariant(quad.arg2)) continue;
+                    const std::string& result = quad.result;
+                    bool sideEffectFree = is_temp(result) && programDefs[result] == 1;
+                    if (loopDefs[result] == 1 && (sideEffectFree || (dominatesExits && !liveAtHeader(result)))) {
+                        moved.push_back(quad);
+                        hoisted[i] = 1;
+                        loopDefs[result] = 0;
+                        record.hoisted++;
+                    }
+                    else {
+                        // 结果不能整条移出：在前置块中算入新临时变量，循环内只做复制
+                        std::string temp = newTemp();
+                        moved.push_back(Quadruple{ 0, quad.op, quad.arg1, quad.arg2, temp });
+                        quad = Quadruple{ quad.label, ":=", temp, "", result };
+                        record.rewritten++;
+                    }
+                    progress = true;
+                }
+            }
+        }
+        if (moved.empty()) continue;
+        stats.hoisted += record.hoisted;
+        stats.rewritten += record.rewritten;
+        stats.loops.push_back(record);
+        changed = true;
+
+        // 从循环外跳到循环头的跳转改跳前置块
+        for (int p = cfg.pred_begin(loop.header); p < cfg.pred_end(loop.header); p++) {
+            int pred = cfg.pred[p];
+            if (inLoop[pred] == l) continue;
+            int last = cfg.last_quad(pred);
+            if (is_jump(quads[last].op) && jump_target(quads[last]) == base + h) edits.redirected.push_back(last);
+        }
+    }
+    if (!changed) return false;
+    apply_edits(quads, edits);
+    return true;
+}
+
+}
+
+// 循环不变量外提
+// 内层前置块位于外层循环中，其中的运算可能对外层也是不变量，因此反复进行直到不再变化
+LICMStats hoist_loop_invariants(std::vector<Quadruple>& quads) {
+    LICMStats stats;
+    auto newTemp = temp_allocator(quads);
+    while (!quads.empty() && stats.rounds < 16) {
+        stats.rounds++;
+        if (!hoist_once(quads, stats, newTemp)) break;
+    }
+    return stats;
+}
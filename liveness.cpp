@@ -0,0 +1,94 @@
+#include "dataflow.h"
+#include <string_view>
+#include <unordered_set>
+
+namespace {
+
+// 活跃变量：后向问题，交汇为并集，in = use ∪ (out - def)
+struct LiveProblem {
+    using Value = BitVector;
+    static constexpr bool forward = false;
+
+    const Liveness& live;
+    BitVector exitLive;
+
+    Value top() const { return BitVector(live.names.size()); }
+    Value boundary() const { return exitLive; }
+    bool meet(Value& into, const Value& from) const { return into.unite(from); }
+    void transfer(int block, const Value& out, Value& in) const {
+        in.transfer(live.use[block], out, live.def[block]);
+    }
+};
+
+}
+
+Liveness compute_liveness(const std::vector<Quadruple>& quads, const CFG& cfg) {
+    Liveness live;
+    int num_blocks = cfg.num_blocks();
+
+    // 1. 只有在某个块中先引用后定值的名字才可能在块边界上活跃，普通变量在出口处活跃；
+    //    只在块内使用的临时变量不进入位向量，位向量的长度与程序规模无关
+    // 当前块内已定值的临时变量。块通常很短，线性查找；长块改用散列表
+    std::vector<const std::string*> defined;
+    std::unordered_set<std::string_view> definedSet;
+    auto addName = [&](const std::string& s) {
+        if (live.index.emplace(s, static_cast<int>(live.names.size())).second) live.names.push_back(s);
+    };
+    for (int b = 0; b < num_blocks; b++) {
+        defined.clear();
+        if (!definedSet.empty()) definedSet.clear();
+        for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+            const Quadruple& quad = quads[i];
+            for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                if (arg->empty() || is_number(*arg)) continue;
+                if (!is_temp(*arg)) {
+                    addName(*arg);
+                    continue;
+                }
+                bool local = false;
+                if (defined.size() > 16) local = definedSet.count(*arg) > 0;
+                else for (const std::string* name : defined) local = local || *name == *arg;
+                if (!local) addName(*arg);
+            }
+            if (is_jump(quad.op) || quad.result.empty()) continue;
+            if (is_temp(quad.result)) {
+                defined.push_back(&quad.result);
+                if (defined.size() == 17) {
+                    for (const std::string* name : defined) definedSet.insert(*name);
+                }
+                else if (defined.size() > 17) {
+                    definedSet.insert(quad.result);
+                }
+            }
+            else addName(quad.result);
+        }
+    }
+    size_t bits = live.names.size();
+
+    // 2. 每块的 use/def：顺序扫描，未在块内先定值的引用计入 use
+    live.use.assign(num_blocks, BitVector(bits));
+    live.def.assign(num_blocks, BitVector(bits));
+    for (int b = 0; b < num_blocks; b++) {
+        for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+            const Quadruple& quad = quads[i];
+            for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                auto it = live.index.find(*arg);
+                if (it != live.index.end() && !live.def[b].test(it->second)) live.use[b].set(it->second);
+            }
+            if (is_jump(quad.op)) continue;
+            auto it = live.index.find(quad.result);
+            if (it != live.index.end()) live.def[b].set(it->second);
+        }
+    }
+
+    // 3. 后向求解
+    LiveProblem problem{ live, BitVector(bits) };
+    for (size_t i = 0; i < bits; i++) {
+        if (!is_temp(live.names[i])) problem.exitLive.set(i);
+    }
+    DataflowResult<BitVector> result = solve_dataflow(cfg, problem);
+    live.live_in = std::move(result.in);
+    live.live_out = std::move(result.out);
+    live.visits = result.visits;
+    return live;
+}
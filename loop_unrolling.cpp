@@ -0,0 +1,261 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// 可以展开的计数循环（跳转优化之后 while 语句的形状）：
+//   h:        (jrop,v,N,出口)   循环头只有这一条比较，条件不成立时顺序执行进入循环体
+//   h+1…e-1:  循环体，其中的跳转只跳到循环体内或 e
+//   e:        (j,,,h)
+// v 在循环体中只被一次每轮必经的递增改变，继续循环的条件是 v stay N
+struct CountedLoop {
+    int head = 0, latch = 0;  // h、e
+    std::string v;
+    int step = 0;
+    std::string stay;         // v 在左边时继续循环的关系运算
+    int bound = 0;            // N
+    bool startKnown = false;  // 进入循环时 v 是否为已知常数
+    int start = 0;
+};
+
+class Unroller {
+public:
+    Unroller(std::vector<Quadruple>& quads, const UnrollOptions& options, UnrollStats& stats,
+        const std::function<std::string()>& newTemp, int& budget, bool fullOnly)
+        : quads(quads), options(options), stats(stats), newTemp(newTemp), budget(budget), fullOnly(fullOnly),
+          cfg(build_cfg(quads)), edits(quads.size()), touched(quads.size(), 0) {
+        compute_dominators(cfg);
+        loops = find_loops(cfg);
+        for (const auto& quad : quads) {
+            if (!is_jump(quad.op) && !quad.result.empty()) programDefs[quad.result]++;
+            for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                if (!arg->empty() && !is_number(*arg)) programUses[*arg]++;
+            }
+        }
+        innermost.assign(cfg.num_blocks(), -1);
+        for (int l = 0; l < static_cast<int>(loops.size()); l++) {
+            for (int b : loops[l].blocks) {
+                if (innermost[b] < 0) innermost[b] = l;
+            }
+        }
+    }
+
+    // 内层循环先展开；包含本轮已展开循环的外层循环留到下一轮
+    bool run() {
+        bool changed = false;
+        for (int l = 0; l < static_cast<int>(loops.size()); l++) {
+            CountedLoop counted;
+            if (!recognize(l, counted)) continue;
+            bool overlaps = false;
+            for (int i = counted.head; i <= counted.latch; i++) overlaps = overlaps || touched[i] != 0;
+            if (overlaps) continue;
+            if (transform(l, counted)) {
+                for (int i = counted.head; i <= counted.latch; i++) touched[i] = 1;
+                changed = true;
+            }
+        }
+        if (changed) apply_edits(quads, edits);
+        return changed;
+    }
+
+private:
+    std::vector<Quadruple>& quads;
+    const UnrollOptions& options;
+    UnrollStats& stats;
+    const std::function<std::string()>& newTemp;
+    int& budget;
+    bool fullOnly;  // 只做完全展开：部分展开后的循环与余数循环不再展开
+    CFG cfg;
+    QuadEdits edits;
+    std::vector<char> touched;  // 1：本轮展开的循环占用的四元式；2：本轮新增跳转的目标
+    std::vector<Loop> loops;
+    std::vector<int> innermost;
+    std::unordered_map<std::string, int> programDefs, programUses;
+
+    bool recognize(int l, CountedLoop& counted) {
+        const Loop& loop = loops[l];
+        int base = cfg.base_label;
+        int h = cfg.first_quad(loop.header);
+        int e = h, size = 0;
+        for (int b : loop.blocks) {
+            if (cfg.first_quad(b) < h) return false;
+            e = std::max(e, cfg.last_quad(b));
+            size += cfg.last_quad(b) - cfg.first_quad(b) + 1;
+        }
+        // 循环占据连续的四元式，循环头只有一条比较，最后一条跳回循环头
+        if (size != e - h + 1 || e < h + 2 || cfg.last_quad(loop.header) != h) return false;
+        const Quadruple& test = quads[h];
+        if (!is_cond_jump(test.op) || quads[e].op != "j" || jump_target(quads[e]) != base + h) return false;
+        int exit = jump_target(test) - base;
+        if (exit >= h && exit <= e) return false;
+        for (int i = h + 1; i < e; i++) {
+            if (!is_jump(quads[i].op)) continue;
+            int target = jump_target(quads[i]) - base;
+            if (target <= h || target > e) return false;
+        }
+
+        bool vFirst = !is_number(test.arg1) && is_number(test.arg2);
+        if (!vFirst && !(is_number(test.arg1) && !is_number(test.arg2))) return false;
+        counted.head = h;
+        counted.latch = e;
+        counted.v = vFirst ? test.arg1 : test.arg2;
+        counted.bound = constant_value(vFirst ? test.arg2 : test.arg1);
+        counted.stay = invert_relop(vFirst ? test.op : mirror_relop(test.op));
+
+        // v 的唯一定值是每轮必经、不在内层循环中的递增
+        int update = -1;
+        for (int i = h + 1; i < e; i++) {
+            if (is_jump(quads[i].op) || quads[i].result != counted.v) continue;
+            if (update >= 0) return false;
+            update = i;
+        }
+        if (update < 0) return false;
+        const Quadruple& quad = quads[update];
+        bool direct = increment_step(quad, counted.v, counted.step);
+        bool chain = !direct && quad.op == ":=" && is_temp(quad.arg1) && update > h + 1 &&
+            quads[update - 1].result == quad.arg1 && increment_step(quads[update - 1], counted.v, counted.step) &&
+            cfg.block_of_quad[update - 1] == cfg.block_of_quad[update];
+        if (!direct && !chain) return false;
+        int block = cfg.block_of_quad[update];
+        if (innermost[block] != l || !cfg.dominates(block, cfg.block_of_quad[e])) return false;
+        bool up = counted.stay == "j<" || counted.stay == "j<=";
+        bool down = counted.stay == "j>" || counted.stay == "j>=";
+        if (!((up && counted.step > 0) || (down && counted.step < 0))) return false;
+
+        // 进入循环时 v 的值：唯一的循环外前驱是顺序执行到循环头的 (:=,常数,,v)
+        int outsidePreds = 0;
+        for (int p = cfg.pred_begin(loop.header); p < cfg.pred_end(loop.header); p++) {
+            int pred = cfg.first_quad(cfg.pred[p]);
+            outsidePreds += pred < h || pred > e;
+        }
+        if (outsidePreds == 1 && h > 0 && quads[h - 1].op == ":=" && quads[h - 1].result == counted.v &&
+            is_number(quads[h - 1].arg1)) {
+            counted.startKnown = true;
+            counted.start = constant_value(quads[h - 1].arg1);
+        }
+        return true;
+    }
+
+    // 循环执行的轮数，超过 limit 时返回 -1
+    int tripCount(const CountedLoop& counted, int limit) const {
+        int16_t v = static_cast<int16_t>(counted.start);
+        int16_t bound = static_cast<int16_t>(counted.bound);
+        int trips = 0;
+        while (evaluate_relop(counted.stay, v, bound)) {
+            if (++trips > limit) return -1;
+            v = static_cast<int16_t>(v + counted.step);
+        }
+        return trips;
+    }
+
+    // 把循环体复制 copies 份接在 list 后面。第c份中跳到 e 的跳转改跳第c+1份的开头
+    //（最后一份之后的位置由调用者放置）；只在循环体内定值和引用的临时变量每份换用新名字
+    void copyBody(const CountedLoop& counted, int copies, bool keepFirstNames, std::vector<Quadruple>& list) {
+        int h = counted.head, e = counted.latch, base = cfg.base_label;
+        int length = e - h - 1;
+        std::unordered_map<std::string, int> bodyUses;
+        std::vector<std::string> local;  // 按定值顺序，使新名字的分配确定
+        for (int i = h + 1; i < e; i++) {
+            for (const std::string* arg : { &quads[i].arg1, &quads[i].arg2 }) {
+                if (is_temp(*arg)) bodyUses[*arg]++;
+            }
+        }
+        for (int i = h + 1; i < e; i++) {
+            const std::string& result = quads[i].result;
+            if (!is_jump(quads[i].op) && is_temp(result) && programDefs[result] == 1 &&
+                bodyUses[result] == programUses[result]) local.push_back(result);
+        }
+        int offset = static_cast<int>(list.size());
+        for (int c = 0; c < copies; c++) {
+            std::unordered_map<std::string, std::string> rename;
+            if (c > 0 || !keepFirstNames) {
+                for (const auto& name : local) rename[name] = newTemp();
+            }
+            for (int i = h + 1; i < e; i++) {
+                list.push_back(clone_quad(quads[i], base, rename, [&](int target) {
+                    return -1 - (offset + c * length + (target - h - 1));  // target == e 时恰为下一份的开头
+                }));
+            }
+        }
+    }
+
+    bool transform(int l, const CountedLoop& counted) {
+        int h = counted.head, e = counted.latch;
+        int length = e - h - 1;
+        std::vector<Quadruple>& list = edits.before[h];
+
+        // 轮数已知且展开后不长时完全展开：去掉比较与回跳，只留 trips 份循环体
+        int trips = counted.startKnown && length > 0 ? tripCount(counted, options.full_limit / length) : -1;
+        if (trips >= 0) {
+            // 出口不紧接在循环之后时最后一份循环体后跳到出口。出口处的四元式本轮须保持不动，
+            // 已被本轮展开的循环占用时留到下一轮
+            int exit = jump_target(quads[h]) - cfg.base_label;
+            bool exitJump = exit != e + 1;
+            if (exitJump && exit < static_cast<int>(quads.size()) && touched[exit] == 1) return false;
+            int growth = trips * length + (exitJump ? 1 : 0) - (length + 2);
+            if (growth > budget) {
+                stats.over_budget++;
+                return false;
+            }
+            copyBody(counted, trips, true, list);
+            if (exitJump) {
+                list.push_back(Quadruple{ 0, "j", "", "", std::to_string(exit) });
+                if (exit < static_cast<int>(quads.size())) touched[exit] = 2;
+            }
+            for (int i = h; i <= e; i++) edits.removed[i] = 1;
+            budget -= growth;
+            stats.added += growth;
+            stats.full++;
+        }
+        else if (!fullOnly) {
+            // 部分展开：U: 剩余轮数不足 k 时转到原循环（余数循环），否则连续执行 k 份循环体后跳回 U。
+            // v stay N-(k-1)d 时接下来的 k 轮都满足 v stay N，N-(k-1)d 须不溢出
+            int k = options.factor;
+            long long adjusted = counted.bound - static_cast<long long>(k - 1) * counted.step;
+            if (k < 2 || length > options.max_body || adjusted < -32768 || adjusted > 32767) return false;
+            int growth = k * length + 2;
+            if (growth > budget) {
+                stats.over_budget++;
+                return false;
+            }
+            list.push_back(Quadruple{ 0, invert_relop(counted.stay), counted.v,
+                constant_string(static_cast<int16_t>(adjusted)), std::to_string(h) });
+            copyBody(counted, k, false, list);
+            list.push_back(Quadruple{ 0, "j", "", "", "-1" });
+            budget -= growth;
+            stats.added += growth;
+            stats.partial++;
+        }
+        else {
+            return false;
+        }
+        // 循环外跳到循环头的跳转改跳展开后的代码
+        const Loop& loop = loops[l];
+        for (int p = cfg.pred_begin(loop.header); p < cfg.pred_end(loop.header); p++) {
+            int last = cfg.last_quad(cfg.pred[p]);
+            if (last >= h && last <= e) continue;
+            if (is_jump(quads[last].op) && jump_target(quads[last]) == cfg.base_label + h) edits.redirected.push_back(last);
+        }
+        return true;
+    }
+};
+
+}
+
+// 循环展开
+// 轮数已知的小循环完全展开，其余计数循环按 factor 展开并保留原循环处理余下的轮数。
+// 整个程序增加的四元式不超过原长度的 growth 倍（至少允许 full_limit 条）。
+// 外层循环在内层展开后的下一轮再考虑，此后各轮只做完全展开，避免把展开出的循环再展开
+UnrollStats unroll_loops(std::vector<Quadruple>& quads, const UnrollOptions& options) {
+    UnrollStats stats;
+    int budget = std::max(options.full_limit, static_cast<int>(quads.size() * options.growth));
+    auto newTemp = temp_allocator(quads);
+    while (!quads.empty() && stats.rounds < 8) {
+        stats.rounds++;
+        Unroller unroller(quads, options, stats, newTemp, budget, stats.rounds > 1);
+        if (!unroller.run()) break;
+    }
+    return stats;
+}
@@ -0,0 +1,204 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+class Unswitcher {
+public:
+    Unswitcher(std::vector<Quadruple>& quads, UnswitchStats& stats, const std::function<std::string()>& newTemp,
+        int& budget, const UnswitchOptions& options)
+        : quads(quads), stats(stats), newTemp(newTemp), budget(budget), options(options),
+          n(static_cast<int>(quads.size())), base(quads[0].label), cfg(build_cfg(quads)), edits(quads.size()),
+          touched(quads.size(), 0) {
+        compute_dominators(cfg);
+        loops = find_loops(cfg);
+        for (const auto& quad : quads) {
+            if (!is_jump(quad.op) && !quad.result.empty()) programDefs[quad.result]++;
+            for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                if (is_temp(*arg)) programUses[*arg]++;
+            }
+        }
+    }
+
+    // 外层循环先考虑：条件对外层循环不变时在外层展开收益最大。
+    // 与本轮已改写的循环重叠的循环留到下一轮，下一轮再处理两份副本中剩下的条件
+    bool run() {
+        bool changed = false;
+        for (int l = static_cast<int>(loops.size()) - 1; l >= 0; l--) {
+            int h = 0, e = 0;
+            if (!contiguous(l, h, e)) continue;
+            bool overlaps = false;
+            for (int i = h; i <= e && !overlaps; i++) overlaps = touched[i] != 0;
+            if (overlaps) continue;
+            int c = invariantCondition(l, h, e);
+            if (c < 0) continue;
+            if (transform(l, h, e, c)) {
+                for (int i = h; i <= e; i++) touched[i] = 1;
+                changed = true;
+            }
+        }
+        if (changed) apply_edits(quads, edits);
+        return changed;
+    }
+
+private:
+    std::vector<Quadruple>& quads;
+    UnswitchStats& stats;
+    const std::function<std::string()>& newTemp;
+    int& budget;
+    const UnswitchOptions& options;
+    int n, base;
+    CFG cfg;
+    QuadEdits edits;
+    std::vector<char> touched;
+    std::vector<Loop> loops;
+    std::unordered_map<std::string, int> programDefs, programUses;
+
+    // 循环占据连续的四元式 h…e，h 是循环头的第一条，e 是跳回 h 的无条件跳转
+    bool contiguous(int l, int& h, int& e) const {
+        const Loop& loop = loops[l];
+        h = cfg.first_quad(loop.header);
+        e = h;
+        int size = 0;
+        for (int b : loop.blocks) {
+            if (cfg.first_quad(b) < h) return false;
+            e = std::max(e, cfg.last_quad(b));
+            size += cfg.last_quad(b) - cfg.first_quad(b) + 1;
+        }
+        return size == e - h + 1 && quads[e].op == "j" && jump_target(quads[e]) == base + h;
+    }
+
+    // 循环头之外、运算对象在循环内都不被改写的第一条条件跳转
+    int invariantCondition(int l, int h, int e) const {
+        std::unordered_set<std::string> written;
+        for (int i = h; i <= e; i++) {
+            if (!is_jump(quads[i].op) && !quads[i].result.empty()) written.insert(quads[i].result);
+        }
+        auto invariant = [&](const std::string& arg) { return is_number(arg) || !written.count(arg); };
+        for (int i = cfg.last_quad(loops[l].header) + 1; i < e; i++) {
+            const Quadruple& quad = quads[i];
+            if (is_cond_jump(quad.op) && invariant(quad.arg1) && invariant(quad.arg2)) return i;
+        }
+        return -1;
+    }
+
+    // 条件 c 取定 taken 时，从 h 出发循环内可以执行到的四元式
+    std::vector<char> reachableWith(int h, int e, int c, bool taken) const {
+        std::vector<char> seen(e - h + 1, 0);
+        std::vector<int> work{ h };
+        seen[0] = 1;
+        auto visit = [&](int i) {
+            if (i >= h && i <= e && !seen[i - h]) {
+                seen[i - h] = 1;
+                work.push_back(i);
+            }
+        };
+        while (!work.empty()) {
+            int i = work.back();
+            work.pop_back();
+            const Quadruple& quad = quads[i];
+            if (i == c) {
+                visit(taken ? jump_target(quad) - base : i + 1);
+                continue;
+            }
+            if (is_jump(quad.op)) visit(jump_target(quad) - base);
+            if (quad.op != "j") visit(i + 1);
+        }
+        return seen;
+    }
+
+    // 原循环改为条件不成立的版本：删去 c 与由此执行不到的四元式。
+    // 条件成立的版本复制到前置块的测试之后：
+    //   (jrop,a,b,→成立版本) (j,,,h) 成立版本…
+    bool transform(int l, int h, int e, int c) {
+        std::vector<char> whenFalse = reachableWith(h, e, c, false);
+        std::vector<char> whenTrue = reachableWith(h, e, c, true);
+        int length = e - h + 1;
+        if (length > options.max_loop) return false;
+        int copied = 0;
+        for (char r : whenTrue) copied += r;
+        int kept = 0;
+        for (char r : whenFalse) kept += r;
+        int growth = copied + 2 - (length - kept);
+        if (growth > budget) {
+            stats.over_budget++;
+            return false;
+        }
+        // 循环外的跳转目标在本轮须保持不动
+        for (int i = h; i <= e; i++) {
+            if (!whenTrue[i - h] || !is_jump(quads[i].op) || i == c) continue;
+            int target = jump_target(quads[i]) - base;
+            if ((target < h || target > e) && target < n && edits.removed[target]) return false;
+        }
+
+        // 只在循环内定值和引用的临时变量在副本中换用新名字
+        std::unordered_map<std::string, int> loopUses;
+        for (int i = h; i <= e; i++) {
+            for (const std::string* arg : { &quads[i].arg1, &quads[i].arg2 }) {
+                if (is_temp(*arg)) loopUses[*arg]++;
+            }
+        }
+        std::unordered_map<std::string, std::string> rename;
+        for (int i = h; i <= e; i++) {
+            const std::string& result = quads[i].result;
+            if (!is_jump(quads[i].op) && is_temp(result) && programDefs[result] == 1 &&
+                loopUses[result] == programUses[result] && !rename.count(result)) rename[result] = newTemp();
+        }
+
+        std::vector<Quadruple>& list = edits.before[h];
+        const Quadruple& test = quads[c];
+        int testAt = static_cast<int>(list.size());
+        list.push_back(Quadruple{ 0, test.op, test.arg1, test.arg2, "" });
+        list.push_back(Quadruple{ 0, "j", "", "", std::to_string(h) });
+        std::vector<int> position(length, -1);
+        int offset = static_cast<int>(list.size());
+        list[testAt].result = std::to_string(-1 - offset);
+        for (int i = h, p = offset; i <= e; i++) {
+            if (whenTrue[i - h]) position[i - h] = p++;
+        }
+        auto retarget = [&](int target) { return target >= h && target <= e ? -1 - position[target - h] : target; };
+        for (int i = h; i <= e; i++) {
+            if (!whenTrue[i - h]) continue;
+            const Quadruple& quad = i == c ? Quadruple{ 0, "j", "", "", quads[i].result } : quads[i];
+            list.push_back(clone_quad(quad, base, rename, retarget));
+        }
+
+        for (int i = h; i <= e; i++) {
+            if (!whenFalse[i - h] || i == c) edits.removed[i] = 1;
+        }
+        // 循环外跳到循环头的跳转改跳前置块中的测试
+        const Loop& loop = loops[l];
+        for (int p = cfg.pred_begin(loop.header); p < cfg.pred_end(loop.header); p++) {
+            int last = cfg.last_quad(cfg.pred[p]);
+            if (last >= h && last <= e) continue;
+            if (is_jump(quads[last].op) && jump_target(quads[last]) == base + h) edits.redirected.push_back(last);
+        }
+        budget -= growth;
+        stats.added += growth;
+        stats.unswitched++;
+        return true;
+    }
+};
+
+}
+
+// 循环判断外提（unswitching）
+// 循环体中运算对象循环不变的条件跳转每轮都得到同样的结果。在前置块中测试一次，
+// 循环复制成条件成立、不成立两个版本，各自去掉这条跳转与执行不到的分支。
+// 整个程序增加的四元式不超过原长度的 growth 倍（至少允许 max_loop 条），超过 max_loop 条的循环不复制
+UnswitchStats unswitch_loops(std::vector<Quadruple>& quads, const UnswitchOptions& options) {
+    UnswitchStats stats;
+    int budget = std::max(options.max_loop, static_cast<int>(quads.size() * options.growth));
+    auto newTemp = temp_allocator(quads);
+    while (!quads.empty() && stats.rounds < 4) {
+        stats.rounds++;
+        Unswitcher unswitcher(quads, stats, newTemp, budget, options);
+        if (!unswitcher.run()) break;
+    }
+    // 删去条件后两个版本中留下的跳到跳转、跳到下一条的跳转交给跳转优化整理
+    if (stats.unswitched > 0) optimize_jumps(quads);
+    return stats;
+}
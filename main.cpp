@@ -1,16 +1,22 @@
 #include "lexer.h"
 #include "parser.h"
+#include "code_generator.h"
 #include "slr_generator.h"
 #include"assembler.h"
+#include "cfg.h"
+#include "optimizer.h"
+#include "pass_manager.h"
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <future>
 
-// ȡԴļ
+// 读取源文件内容
 std::string readFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
-        throw std::runtime_error("޷Դļ" + filename);
+        throw std::runtime_error("无法打开源文件：" + filename);
     }
 
     std::string content((std::istreambuf_iterator<char>(file)),
@@ -19,11 +25,11 @@ std::string readFile(const std::string& filename) {
     return content;
 }
 
-// Ԫʽ.medļ
+// 保存四元式到.med文件
 void saveMedFile(const std::vector<std::string>& quadruples, const std::string& filename) {
     std::ofstream file(filename);
     if (!file.is_open()) {
-        throw std::runtime_error("޷.medļ" + filename);
+        throw std::runtime_error("无法创建.med文件：" + filename);
     }
 
     for (const auto& quad : quadruples) {
@@ -34,54 +40,228 @@ void saveMedFile(const std::vector<std::string>& quadruples, const std::string&
 
 int main() {
     try {
-        // 1. SLR
-        SLRGenerator slrGen;
-        std::cout << "SLR..." << std::endl;
-        slrGen.generateArithmeticTable();//ʽSLR
-        slrGen.generateBooleanTable();//ɲʽSLR
-        slrGen.generateStatementTable();//ɹSLR
-
-        // 2. ȡԴļ
+        // 1. 生成SLR分析表
+        // 三个文法互相独立，分别在各自线程中生成，完成后按顺序打印
+        std::cout << "正在生成SLR分析表..." << std::endl;
+        std::vector<SLRGenerator> generators;
+        generators.emplace_back(SLRGenerator::arithmeticGrammar());//算术表达式SLR分析表
+        generators.emplace_back(SLRGenerator::booleanGrammar());//布尔表达式SLR分析表
+        generators.emplace_back(SLRGenerator::statementGrammar());//程序语句SLR分析表
+        std::vector<std::future<void>> tasks;
+        for (auto& generator : generators) {
+            tasks.push_back(std::async(std::launch::async,
+                [&generator]() { generator.generateParsingTable(); }));
+        }
+        for (size_t i = 0; i < generators.size(); i++) {
+            tasks[i].get();
+            std::cout << "生成" << generators[i].getGrammar().name << "SLR分析表..." << std::endl;
+            generators[i].printParsingTable();
+        }
+
+        // 2. 读取源文件
         std::string sourceCode = readFile("pas.dat");
-        std::cout << "\nȡԴ\n" << sourceCode << std::endl;
+        std::cout << "\n读取到的源程序：\n" << sourceCode << std::endl;
 
-        // 3. ʷ
+        // 3. 词法分析
         Lexer lexer;
         std::vector<Token> tokens = lexer.tokenize(sourceCode);
 
-        // ӡʷ
-        std::cout << "\nʷ" << std::endl;
+        // 打印词法分析结果
+        std::cout << "\n词法分析结果：" << std::endl;
         for (const auto& token : tokens) {
             std::cout << "Token: " << token.value
                 << " (Type: " << token.type
                 << ", Line: " << token.line << ")" << std::endl;
         }
 
-        // 4. ﷨м
+        // 4. 语法分析和中间代码生成
         Parser parser;
         if (parser.parse(tokens)) {
-            std::cout << "﷨ɹ" << std::endl;
+            std::cout << "语法分析成功！" << std::endl;
 
-            // 5. Ԫʽ.medļ
+            // 5. 保存四元式到.med文件
             std::vector<std::string> quadruples = parser.getQuadruples();
-            std::cout << "\nɵԪʽ" << std::endl;
+            std::cout << "\n生成的四元式：" << std::endl;
             for (const auto& quad : quadruples) {
                 std::cout << quad << std::endl;
             }
 
             saveMedFile(quadruples, "pas.med");
-            std::cout << "Ԫʽѱ浽pas.med" << std::endl;
+            std::cout << "四元式已保存到pas.med" << std::endl;
+
+            // 由语法树直接生成代码：表达式按 Sethi-Ullman 数排定求值次序
+            CodeGenerator generator;
+            std::vector<std::string> treeQuadruples = generator.generateQuadruples(parser.getAST());
+            std::cout << "\n由语法树生成的四元式（临时变量" << generator.getTempCount() << "个）：" << std::endl;
+            for (const auto& quad : treeQuadruples) {
+                std::cout << quad << std::endl;
+            }
+            saveMedFile(generator.generateAssembly(parser.getAST()), "pas_tree.asm");
+            std::cout << "由语法树生成汇编到pas_tree.asm：指令" << generator.getInstructionCount() << "条，寄存器"
+                << generator.getRegisterCount() << "个，溢出" << generator.getSpillCount() << "次" << std::endl;
         }
         else {
-            std::cout << "﷨ʧܣ﷨Ƿȷ" << std::endl;
+            std::cout << "语法分析失败！请检查输入程序的语法是否正确。" << std::endl;
         }
-        //5.Է
+        //5.汇编语言翻译
         std::vector<Quadruple> quads = parse_quads("pas.med");
+
+        // 6. 四元式优化：由遍管理器依次运行，局部值编号与复制合并按基本块并行
+        PassManager manager;
+        FoldStats fold;
+        SCCPStats sccp;
+        JumpStats jumps;
+        ReassocStats reassoc;
+        UnswitchStats unswitch;
+        UnrollStats unroll;
+        LICMStats licm;
+        IVStats iv;
+        CopyPropStats copyprop;
+        DCEStats dce;
+        TempStats temps;
+        LayoutStats layout;
+        SwitchStats switches;
+        manager.add_pass("fold", [&](std::vector<Quadruple>& q, const Analyses&) {
+            fold = constant_folding(q);
+            return fold.folded + fold.simplified + fold.jumps;
+        });
+        manager.add_pass("sccp", [&](std::vector<Quadruple>& q, const Analyses&) {
+            sccp = sparse_constant_propagation(q);
+            return sccp.constants + sccp.jumps;
+        });
+        manager.add_pass("jumps", [&](std::vector<Quadruple>& q, const Analyses&) {
+            jumps = optimize_jumps(q);
+            return jumps.threaded + jumps.inverted + jumps.to_next + jumps.unreachable;
+        });
+        manager.add_pass("reassoc", [&](std::vector<Quadruple>& q, const Analyses&) {
+            reassoc = reassociate_expressions(q);
+            return reassoc.chains;
+        });
+        manager.add_block_pass("lvn", [](BlockWork& work, const Analyses& analyses) {
+            number_values_in_block(work, analyses.names());
+        }, ANALYSIS_NAMES);
+        manager.add_pass("unswitch", [&](std::vector<Quadruple>& q, const Analyses&) {
+            unswitch = unswitch_loops(q);
+            return unswitch.unswitched;
+        });
+        manager.add_pass("unroll", [&](std::vector<Quadruple>& q, const Analyses&) {
+            unroll = unroll_loops(q);
+            return unroll.full + unroll.partial;
+        });
+        manager.add_pass("licm", [&](std::vector<Quadruple>& q, const Analyses&) {
+            licm = hoist_loop_invariants(q);
+            return licm.hoisted + licm.rewritten;
+        });
+        manager.add_pass("iv", [&](std::vector<Quadruple>& q, const Analyses&) {
+            iv = reduce_induction_variables(q);
+            return iv.reduced + iv.replaced + iv.removed;
+        });
+        manager.add_pass("copyprop", [&](std::vector<Quadruple>& q, const Analyses&) {
+            copyprop = propagate_copies(q);
+            return copyprop.copies + copyprop.phis;
+        });
+        manager.add_pass("dce", [&](std::vector<Quadruple>& q, const Analyses&) {
+            dce = eliminate_dead_code(q);
+            return dce.removed;
+        });
+        manager.add_block_pass("copies", [](BlockWork& work, const Analyses& analyses) {
+            coalesce_copies_in_block(work, analyses.names());
+        }, ANALYSIS_NAMES);
+        // 临时变量改名不影响控制流
+        manager.add_pass("temps", [&](std::vector<Quadruple>& q, const Analyses&) {
+            temps = recycle_temps(q);
+            return temps.renamed;
+        }, 0, ANALYSIS_CFG | ANALYSIS_LOOPS);
+        // 基本块布局：先插桩运行一次（变量初值为0）收集执行剖面，没有跑完时改用静态估计
+        manager.add_pass("layout", [&](std::vector<Quadruple>& q, const Analyses&) {
+            BlockProfile profile = profile_quads(q);
+            layout = layout_blocks(q, profile.finished ? &profile : nullptr);
+            return layout.moved + layout.inverted + layout.removed + layout.added;
+        });
+        // 多路分支：跳转表的表项必须紧接在 switch 之后，放在改变块顺序的布局之后
+        manager.add_pass("switch", [&](std::vector<Quadruple>& q, const Analyses&) {
+            switches = lower_switches(q);
+            return switches.chains;
+        });
+        std::vector<PassReport> reports = manager.run(quads);
+        auto reportOf = [&reports](const std::string& name) -> const PassReport& {
+            for (const auto& report : reports) {
+                if (report.name == name) return report;
+            }
+            throw std::runtime_error("没有名为" + name + "的优化遍");
+        };
+
+        std::cout << "\n常量合并：求值" << fold.folded << "条，化简" << fold.simplified
+            << "条，判定条件跳转" << fold.jumps << "条，删除四元式" << fold.removed << "条" << std::endl;
+        std::cout << "条件常量传播：改写常数引用" << sccp.constants << "处，判定条件跳转" << sccp.jumps
+            << "条，不可执行块" << sccp.dead_blocks << "个，删除四元式" << sccp.removed << "条" << std::endl;
+        std::cout << "跳转优化：穿过跳转" << jumps.threaded << "条，取反条件" << jumps.inverted
+            << "条，删除跳到下一条的跳转" << jumps.to_next << "条，不可达四元式" << jumps.unreachable
+            << "条" << std::endl;
+        std::cout << "重结合：重写运算树" << reassoc.chains << "棵，合并常数" << reassoc.folded
+            << "个，组合循环不变量" << reassoc.grouped << "处，树高" << reassoc.height_before << "降为"
+            << reassoc.height_after << std::endl;
+        const PassReport& lvn = reportOf("lvn");
+        std::cout << "局部值编号：删除" << lvn.counts[0] << "条四元式，改写为复制"
+            << lvn.counts[1] << "条" << std::endl;
+        std::cout << "循环判断外提：" << unswitch.unswitched << "个循环，超出预算" << unswitch.over_budget
+            << "个，增加四元式" << unswitch.added << "条" << std::endl;
+        std::cout << "循环展开：完全展开" << unroll.full << "个，部分展开" << unroll.partial
+            << "个，超出预算" << unroll.over_budget << "个，增加四元式" << unroll.added << "条" << std::endl;
+        std::cout << "循环不变量外提：移出" << licm.hoisted << "条运算，改为复制"
+            << licm.rewritten << "条" << std::endl;
+        for (const auto& loop : licm.loops) {
+            std::cout << "  循环 头=" << loop.header_label << " 深度=" << loop.depth
+                << " 移出" << loop.hoisted << " 改写" << loop.rewritten << std::endl;
+        }
+        std::cout << "归纳变量：削弱乘法" << iv.reduced << "条，替换循环测试" << iv.replaced
+            << "条，删除递增" << iv.removed << "条" << std::endl;
+        std::cout << "复制传播：传播复制" << copyprop.copies << "条，代替φ函数" << copyprop.phis
+            << "个，退出SSA换名" << copyprop.renamed << "个、插入复制" << copyprop.inserted << "条" << std::endl;
+        std::cout << "死代码删除：删除四元式" << dce.removed << "条" << std::endl;
+        const PassReport& coalesce = reportOf("copies");
+        std::cout << "复制合并：合并运算与复制" << coalesce.counts[0] << "对，代入复制" << coalesce.counts[1]
+            << "处，四元式" << coalesce.before << "条减为" << coalesce.after << "条" << std::endl;
+        std::cout << "临时变量重用：" << temps.before << "个临时变量改为" << temps.after << "个" << std::endl;
+        std::cout << "基本块布局（" << (layout.profiled ? "执行剖面" : "静态估计") << "）：顺序执行链" << layout.chains
+            << "条，移动块" << layout.moved << "个，冷块" << layout.cold << "个，取反条件" << layout.inverted
+            << "条，删除跳转" << layout.removed << "条，增加跳转" << layout.added << "条，估计转移"
+            << layout.taken_before << "次减为" << layout.taken_after << "次" << std::endl;
+        std::cout << "多路分支：比较链" << switches.chains << "条（" << switches.cases << "个常数），跳转表"
+            << switches.tables << "个（" << switches.entries << "项），二分比较" << switches.trees
+            << "个，增加四元式" << switches.added << "条" << std::endl;
+        std::cout << "\n优化遍报告（" << manager.threads() << "个线程）：" << std::endl;
+        print_pass_reports(reports, std::cout);
+        std::cout << "优化后的四元式：" << std::endl;
+        for (const auto& quad : quads) {
+            std::cout << quad.label << " (" << quad.op << "," << quad.arg1 << ", "
+                << quad.arg2 << ", " << quad.result << ")" << std::endl;
+        }
+
+        // 7. 控制流分析：划分基本块，计算支配树并找出自然循环
+        // 临时变量重用保持了控制流图，缓存中的分析仍然有效时直接使用
+        const Analyses& analyses = manager.analyses(quads, ANALYSIS_LOOPS);
+        std::cout << "\n控制流图：" << std::endl;
+        dump_cfg(analyses.cfg(), analyses.loops(), std::cout);
+
         std::set<std::string> vars = collect_vars(quads);
-        generate_assembly(quads, vars, "pas.asm");
+        AsmStats asmStats = generate_assembly(quads, vars, "pas.asm");
+        std::cout << "\n寄存器分配：生存区间" << asmStats.intervals << "个，溢出" << asmStats.spilled
+            << "个（槽位" << asmStats.spill_slots << "个）；指令" << asmStats.instructions << "条，访存"
+            << asmStats.memory_operands << "次（全部放在内存中时" << asmStats.naive_memory << "次）" << std::endl;
+        std::cout << "指令选择：估计" << asmStats.cycles << "个时钟周期，通用翻译" << asmStats.generic_cycles
+            << "个，节省" << asmStats.generic_cycles - asmStats.cycles << "个" << std::endl;
+        const PeepholeStats& peephole = asmStats.peephole;
+        std::cout << "窥孔优化：" << peephole.rounds << "轮，指令" << peephole.instructions_before << "条减为"
+            << peephole.instructions_after << "条，删除标号" << peephole.labels << "个；命中";
+        const std::vector<PeepholeRule>& rules = default_peephole_rules();
+        for (size_t r = 0; r < rules.size(); r++) {
+            std::cout << " " << rules[r].name << "=" << peephole.hits[r];
+        }
+        std::cout << std::endl;
     }
     catch (const std::exception& e) {
-        std::cerr << "" << e.what() << std::endl;
+        std::cerr << "错误：" << e.what() << std::endl;
         return 1;
     }
 
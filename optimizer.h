@@ -0,0 +1,217 @@
+#pragma once
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "assembler.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 四元式优化遍。每个遍直接修改四元式序列，删除四元式后重新连续编号，并返回统计信息。
+// 只在基本块内进行的遍另外提供处理单个块的函数（见 cfg.h 的 BlockWork），供遍管理器并行调用
+
+struct BlockWork;
+struct NameCounts;
+
+// 16位常数运算。常数在四元式中写作0..65535的无符号十进制数（与 is_number 一致），
+// 运算按补码回绕，比较按有符号数进行，与生成的 jg/jl 等指令一致
+int16_t constant_value(const std::string& s);
+std::string constant_string(int16_t value);
+bool is_arith(const std::string& op);  // + - * /
+// 计算 a op b，除数为0时不求值并返回false
+bool evaluate_arith(const std::string& op, int16_t a, int16_t b, int16_t& result);
+bool evaluate_relop(const std::string& op, int16_t a, int16_t b);  // op 为 j<rop>
+// quad 是否为 v 加减常数（v+d、d+v、v-d），是则把带符号的增量写入 step
+bool increment_step(const Quadruple& quad, const std::string& v, int& step);
+
+// 局部值编号：在基本块内消除重复计算
+struct LVNStats {
+    int removed = 0;  // 删除的四元式数（结果临时变量改用先前的结果）
+    int copies = 0;   // 改写为复制的四元式数（结果为普通变量，不能直接删除）
+};
+LVNStats local_value_numbering(std::vector<Quadruple>& quads);
+void number_values_in_block(BlockWork& work, const NameCounts& names);
+
+// 常量合并与代数化简：按16位回绕运算求常数表达式的值，化简 x+0、x*1、x*0 等，
+// 两个运算对象都是常数的条件跳转改为无条件跳转或删除
+struct FoldStats {
+    int folded = 0;      // 求值为常数的运算
+    int simplified = 0;  // 按代数恒等式化简的运算
+    int jumps = 0;       // 判定了结果的条件跳转
+    int removed = 0;     // 删除的四元式总数
+};
+FoldStats constant_folding(std::vector<Quadruple>& quads);
+
+// 稀疏条件常量传播：在SSA视图上沿可执行的控制流边传播常数，
+// 引用改写为常数，判定条件跳转，删除不可执行的基本块
+struct SCCPStats {
+    int constants = 0;    // 改写为常数的引用
+    int jumps = 0;        // 判定了结果的条件跳转
+    int dead_blocks = 0;  // 不可执行的基本块
+    int removed = 0;      // 删除的四元式总数
+};
+SCCPStats sparse_constant_propagation(std::vector<Quadruple>& quads);
+
+// 跳转优化：穿过无条件跳转直接跳到最终目标，条件跳转越过紧随的无条件跳转时取反条件，
+// 删除跳到下一条的跳转与不可达的四元式，重新连续编号
+struct JumpStats {
+    int threaded = 0;     // 改为直接跳到最终目标的跳转
+    int inverted = 0;     // 取反条件后删去的无条件跳转
+    int to_next = 0;      // 删除的跳到下一条的跳转
+    int unreachable = 0;  // 删除的不可达四元式
+    int removed = 0;      // 删除的四元式总数
+};
+JumpStats optimize_jumps(std::vector<Quadruple>& quads);
+
+// 死代码删除：根据活跃变量分析删除结果不再被引用的四元式，反复进行直到不再变化
+struct DCEStats {
+    int removed = 0;  // 删除的四元式数
+    int rounds = 0;   // 活跃变量分析的次数
+};
+DCEStats eliminate_dead_code(std::vector<Quadruple>& quads);
+
+// 循环不变量外提：在自然循环的循环头前建立前置块，把运算对象在循环内不被修改的
+// + - * 运算移入前置块。结果只在循环内定值一次且外提安全时整条移出，
+// 否则在前置块中算入新的临时变量，循环内的运算改为复制
+struct LoopHoist {
+    int header_label = 0;  // 循环头第一条四元式的标号（外提前）
+    int depth = 1;
+    int hoisted = 0;       // 整条移出的运算
+    int rewritten = 0;     // 改为复制的运算
+};
+struct LICMStats {
+    int hoisted = 0;
+    int rewritten = 0;
+    int rounds = 0;
+    std::vector<LoopHoist> loops;  // 有外提的循环，每轮依次追加
+};
+LICMStats hoist_loop_invariants(std::vector<Quadruple>& quads);
+
+// 归纳变量：基本归纳变量 v 在循环内只被 v := v ± 常数 改变，派生归纳变量 w := v * 常数
+// 改为在前置块中算出初值、随 v 的递增加上增量（强度削弱）；循环头对 v 的比较能换成对
+// 派生变量的比较时进行线性函数测试替换，v 因此不再被使用时删除其递增
+struct IVStats {
+    int basic = 0;     // 有乘法被削弱的循环中的基本归纳变量
+    int reduced = 0;   // 改为加法递推的乘法
+    int replaced = 0;  // 线性函数测试替换的条件跳转
+    int removed = 0;   // 删除的递增四元式
+    int rounds = 0;
+};
+IVStats reduce_induction_variables(std::vector<Quadruple>& quads);
+
+// 重结合：同一基本块内由只用一次的临时变量连成的 + 或 * 运算树，合并其中的常数，
+// 循环中把循环不变的运算对象先组合以便外提，并重排成平衡树降低依赖链长度
+struct ReassocStats {
+    int chains = 0;         // 重写的运算树
+    int folded = 0;         // 合并掉的常数
+    int grouped = 0;        // 把循环不变运算对象单独组合的运算树
+    int height_before = 0;  // 重写的运算树原来的高度之和
+    int height_after = 0;   // 重写后的高度之和
+};
+ReassocStats reassociate_expressions(std::vector<Quadruple>& quads);
+
+// 循环判断外提：循环体中运算对象在循环内不被改写的条件跳转提到循环前测试一次，
+// 循环按条件的两种结果复制成两个版本
+struct UnswitchOptions {
+    int max_loop = 64;    // 只复制不超过这么多条四元式的循环
+    double growth = 0.5;  // 整个程序最多增加原长度的这个比例
+};
+struct UnswitchStats {
+    int unswitched = 0;   // 外提了条件的循环
+    int over_budget = 0;  // 因超出代码增长预算而放弃的循环
+    int added = 0;        // 净增加的四元式
+    int rounds = 0;
+};
+UnswitchStats unswitch_loops(std::vector<Quadruple>& quads, const UnswitchOptions& options = UnswitchOptions());
+
+// 循环展开：识别循环头比较 v 与常数、循环体中 v 每轮递增一次常数的计数循环。
+// 轮数已知且展开后不长的循环完全展开，其余按 factor 展开，原循环留作余数循环
+struct UnrollOptions {
+    int factor = 4;        // 部分展开的份数，小于2时不做部分展开
+    int max_body = 16;     // 部分展开只考虑循环体不超过这么多条四元式的循环
+    int full_limit = 64;   // 完全展开后的循环体总长上限
+    double growth = 0.5;   // 整个程序最多增加原长度的这个比例
+};
+struct UnrollStats {
+    int full = 0;         // 完全展开的循环
+    int partial = 0;      // 部分展开的循环
+    int over_budget = 0;  // 因超出代码增长预算而放弃的循环
+    int added = 0;        // 净增加的四元式
+    int rounds = 0;
+};
+UnrollStats unroll_loops(std::vector<Quadruple>& quads, const UnrollOptions& options = UnrollOptions());
+
+// 全局复制传播：在SSA视图上把复制定义的值的引用改为引用源值，去掉参数都相同的φ函数，
+// 再退出SSA写回四元式。原来的复制变成无用定值，由死代码删除去掉
+struct CopyPropStats {
+    int copies = 0;    // 被传播的复制
+    int phis = 0;      // 被代替的φ函数
+    int renamed = 0;   // 退出SSA时因生存期重叠换名的值
+    int inserted = 0;  // 退出SSA时插入的复制
+};
+CopyPropStats propagate_copies(std::vector<Quadruple>& quads);
+
+// 复制传播与合并：运算结果先送临时变量再复制给变量时直接写入变量，
+// 复制到临时变量的值直接代入其唯一的引用
+struct CoalesceStats {
+    int merged = 0;      // 与后面的复制合并的运算
+    int propagated = 0;  // 代入引用处的复制
+    int removed = 0;
+};
+CoalesceStats coalesce_copies(std::vector<Quadruple>& quads);
+void coalesce_copies_in_block(BlockWork& work, const NameCounts& names);
+
+// 临时变量重用：按生存区间着色，生存期不重叠的临时变量共用名字，
+// 改名后的临时变量数等于同时活跃的最大个数。临时变量不再只赋值一次，应作为最后一遍
+struct TempStats {
+    int before = 0;   // 改名前不同的临时变量数
+    int after = 0;    // 改名后的临时变量数
+    int renamed = 0;  // 换了名字的临时变量
+};
+TempStats recycle_temps(std::vector<Quadruple>& quads);
+
+// 执行剖面：插桩运行时每条四元式执行的次数，以及跳转四元式跳转成立的次数
+struct BlockProfile {
+    std::vector<long long> executed;
+    std::vector<long long> taken;
+    bool finished = false;  // 是否在步数上限内跳出程序
+};
+// 解释执行四元式收集剖面。inputs 中没有的变量初值为0，运算语义与生成的8086代码相同
+BlockProfile profile_quads(const std::vector<Quadruple>& quads, const std::map<std::string, int16_t>& inputs = {},
+    long long max_steps = 10000000);
+
+// 基本块布局：按边的执行次数把最常走的后继接在块后顺序执行，条件跳转取反使可能的一侧不用转移，
+// 没有执行过的块移到程序末尾。没有剖面时按静态估计：回边与留在循环内的一侧多半成立
+struct LayoutStats {
+    bool profiled = false;
+    int chains = 0;    // 顺序执行链的条数
+    int moved = 0;     // 位置改变的块
+    int inverted = 0;  // 取反的条件跳转
+    int removed = 0;   // 删除的跳到下一块的无条件跳转
+    int added = 0;     // 补上的无条件跳转
+    int cold = 0;      // 冷块：剖面中没有执行过（静态估计时为不可达）的块
+    long long taken_before = 0;  // 按边的权重估计的转移次数（成立的条件跳转与无条件跳转）
+    long long taken_after = 0;
+};
+LayoutStats layout_blocks(std::vector<Quadruple>& quads, const BlockProfile* profile = nullptr);
+
+// 多路分支：把依次比较同一变量与互不相同的常数的 j=/j<> 链（if x=1 then … else if x=2 then …）
+// 改为一次分派。常数密集时先检查上下界，再按 x-lo 经跳转表转移（switch 四元式，见 cfg.h）；
+// 稀疏时按常数二分比较。生成的跳转表其他遍不认识，应在布局之后作为最后一遍运行
+struct SwitchOptions {
+    int min_cases = 4;          // 链中至少这么多个常数才改写
+    double min_density = 0.4;   // 常数个数与取值范围之比不低于此值时用跳转表
+    int max_table = 256;        // 跳转表的最大项数
+};
+struct SwitchStats {
+    int chains = 0;   // 改写的比较链
+    int tables = 0;   // 其中改为跳转表的
+    int trees = 0;    // 改为二分比较的
+    int cases = 0;    // 各链的常数个数之和
+    int entries = 0;  // 跳转表的项数之和
+    int added = 0;    // 净增加的四元式（跳转表的表项也算在内）
+};
+SwitchStats lower_switches(std::vector<Quadruple>& quads, const SwitchOptions& options = SwitchOptions());
+
+#endif // OPTIMIZER_H
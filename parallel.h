@@ -0,0 +1,215 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 取实际使用的线程数：0表示使用硬件线程数
+inline unsigned resolveThreadCount(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    return threadCount == 0 ? 1 : threadCount;
+}
+
+// 并行执行 f(0) ... f(n-1)
+// 各线程通过原子计数器按块领取下标；任务数较少时直接在当前线程执行
+// 任一任务抛出的异常会在所有线程结束后于调用线程重新抛出
+template <typename F>
+void parallelFor(size_t n, unsigned threadCount, F&& f) {
+    const size_t grain = 4;  // 每次领取的下标数
+    unsigned workers = resolveThreadCount(threadCount);
+    if (workers > (n + grain - 1) / grain) {
+        workers = static_cast<unsigned>((n + grain - 1) / grain);
+    }
+    if (workers <= 1) {
+        for (size_t i = 0; i < n; i++) {
+            f(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto run = [&]() {
+        try {
+            for (;;) {
+                size_t begin = next.fetch_add(grain);
+                if (begin >= n) break;
+                size_t end = std::min(n, begin + grain);
+                for (size_t i = begin; i < end; i++) {
+                    f(i);
+                }
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+            next.store(n);  // 让其余线程尽快退出
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < workers; t++) {
+        threads.emplace_back(run);
+    }
+    run();  // 当前线程也参与计算
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// 常驻的工作窃取线程池
+// 每个线程有自己的任务双端队列：一组任务按下标分段后连续地分给各线程，线程从自己队列的尾部
+// 取任务，自己的做完后从其他线程队列的头部窃取，任务耗时不均时仍能保持各线程忙碌。
+// 调用 parallelFor 的线程作为0号线程参与计算；一次只执行一组任务，任务中不能再调用 parallelFor
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount = 0) : workers(resolveThreadCount(threadCount)) {
+        for (unsigned t = 0; t < workers; t++) {
+            queues.emplace_back(new Queue);
+        }
+        for (unsigned t = 1; t < workers; t++) {
+            threads.emplace_back([this, t]() { workerLoop(t); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return workers; }
+
+    // 并行执行 f(0) ... f(n-1)，每 grain 个下标为一个任务；全部完成后返回，
+    // 任一任务抛出的异常在调用线程重新抛出
+    template <typename F>
+    void parallelFor(size_t n, size_t grain, F&& f) {
+        grain = std::max<size_t>(grain, 1);
+        if (workers == 1 || n <= grain) {
+            for (size_t i = 0; i < n; i++) {
+                f(i);
+            }
+            return;
+        }
+        std::function<void(size_t)> task = [&f](size_t i) { f(i); };
+        std::lock_guard<std::mutex> exclusive(runMutex);
+        size_t chunks = (n + grain - 1) / grain;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (unsigned t = 0; t < workers; t++) {
+                std::lock_guard<std::mutex> queueLock(queues[t]->mutex);
+                for (size_t c = chunks * t / workers; c < chunks * (t + 1) / workers; c++) {
+                    queues[t]->ranges.emplace_back(c * grain, std::min(n, (c + 1) * grain));
+                }
+            }
+            job = &task;
+            remaining = chunks;
+            error = nullptr;
+            generation++;
+        }
+        wake.notify_all();
+        work(0, task);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return remaining == 0 && busy == 0; });
+        job = nullptr;
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    using Range = std::pair<size_t, size_t>;
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    unsigned workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex runMutex;  // 保证一次只执行一组任务
+    std::mutex mutex;     // 保护以下各项
+    std::condition_variable wake, done;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t generation = 0;
+    size_t remaining = 0;  // 尚未完成的任务数
+    unsigned busy = 0;     // 正在处理本组任务的常驻线程数
+    bool stopping = false;
+    std::exception_ptr error;
+
+    // 先从自己队列的尾部取，再从其后的线程开始依次窃取队列头部的任务
+    bool take(unsigned self, Range& range) {
+        for (unsigned k = 0; k < workers; k++) {
+            Queue& queue = *queues[(self + k) % workers];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.ranges.empty()) continue;
+            if (k == 0) {
+                range = queue.ranges.back();
+                queue.ranges.pop_back();
+            }
+            else {
+                range = queue.ranges.front();
+                queue.ranges.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void work(unsigned self, const std::function<void(size_t)>& task) {
+        Range range;
+        while (take(self, range)) {
+            try {
+                for (size_t i = range.first; i < range.second; i++) {
+                    task(i);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0) done.notify_all();
+        }
+    }
+
+    void workerLoop(unsigned self) {
+        size_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                task = job;
+                if (!task) continue;  // 醒得太晚，这组任务已经结束
+                busy++;
+            }
+            work(self, *task);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0 && remaining == 0) done.notify_all();
+        }
+    }
+};
@@ -2,13 +2,13 @@
 #include <iostream>
 #include <sstream>
 
-// 캯ʼ״̬
+// 构造函数，初始化解析器状态
 Parser::Parser() : ast(nullptr), currentStatement(nullptr),
-tempVarCounter(1), quadIndex(100) {//Ԫʽʼ100
-    stateStack.push(0);  // ʼ״̬ѹջ
+tempVarCounter(1), quadIndex(100), expressionNode(nullptr) {//四元式索引初始100
+    stateStack.push(0);  // 初始状态压栈
 }
 
-// ASTڴ
+// 析构函数，清理AST内存
 Parser::~Parser() {
     if (ast) {
         delete ast;
@@ -16,19 +16,19 @@ Parser::~Parser() {
     }
 }
 
-// Ԫʽֵ
+// 生成四元式，赋值语句
 void Parser::generateQuadruple(const std::string& op,const std::string& arg1,const std::string& arg2,const std::string& result) {
     std::stringstream ss;
-    ss << quadIndex << " (";  // Ԫʽ
-    if (op == "+" || op == "*" || op == ":=") {  // ͸ֵ
+    ss << quadIndex << " (";  // 四元式编号
+    if (op == "+" || op == "*" || op == ":=") {  // 处理算术和赋值操作
         ss << op << "," << arg1 << ", " << arg2 << ", " << result;
     }
     ss << ")";
-    quadruples.push_back(ss.str());  // ӵԪʽб
-    quadIndex++;  // Ԫʽ
+    quadruples.push_back(ss.str());  // 添加到四元式列表
+    quadIndex++;  // 递增四元式索引
 }
 
-// תԪʽ
+// 生成跳转四元式
 void Parser::generateJump(const std::string& op, const std::string& arg1,const std::string& arg2,int target) {
     std::stringstream ss;
     ss << quadIndex << " (j" << op << ", " << arg1 << ", " << arg2 << ", " << target << ")";
@@ -36,152 +36,159 @@ void Parser::generateJump(const std::string& op, const std::string& arg1,const s
     quadIndex++;
 }
 
-// תַ
+// 回填跳转地址
 void Parser::backPatch(int jumpInstr, int target) {
-    if (jumpInstr >= 100 && jumpInstr < quadIndex) {  // תָǷЧ
+    if (jumpInstr >= 100 && jumpInstr < quadIndex) {  // 检查跳转指令是否有效
         std::stringstream ss;
         ss << jumpInstr << " (j, , , " << target << ")";
-        quadruples[jumpInstr - 100] = ss.str();  // תĿ
+        quadruples[jumpInstr - 100] = ss.str();  // 更新跳转目标
     }
 }
 
-// 
+// 由两个子树构造二元运算的表达式节点
+Node* Parser::makeBinary(const std::string& op, Node* left, Node* right) {
+    Node* node = new Node("Expression", op);
+    node->children.push_back(left);
+    node->children.push_back(right);
+    return node;
+}
+
+// 主解析函数
 bool Parser::parse(const std::vector<Token>& tokens) {
     size_t pos = 0;
+    // 语法树的根节点，各语句依次作为其子节点
+    delete ast;
+    ast = new Node("Program");
+    currentStatement = ast;
     try {
-        std::cout << "\nʼ﷨..." << std::endl;
-        //ѭtoken
+        std::cout << "\n开始语法分析..." << std::endl;
+        //循环处理token序列
         while (pos < tokens.size()) {
             const Token& token = tokens[pos];
-            std::cout << "ʷԪ: " << getTokenInfo(token) << std::endl;
-            //Token͵ӦĽ
+            std::cout << "处理词法单元: " << getTokenInfo(token) << std::endl;
+            //根据Token类型调用相应的解析函数
             switch (token.type) {
             case SY_BEGIN:
                 if (!parseCompoundStatement(tokens, pos)) {
-                    reportError("ʧ", token);
+                    reportError("复合语句解析失败", token);
                     return false;
                 }
                 break;
 
             case SY_WHILE:
                 if (!parseWhileStatement(tokens, pos)) {
-                    reportError("whileʧ", token);
+                    reportError("while语句解析失败", token);
                     return false;
                 }
                 break;
 
             case SY_IF:
                 if (!parseIfStatement(tokens, pos)) {
-                    reportError("ifʧ", token);
+                    reportError("if语句解析失败", token);
                     return false;
                 }
                 break;
 
             case IDENT:
                 if (!parseAssignmentStatement(tokens, pos)) {
-                    reportError("ֵʧ", token);
+                    reportError("赋值语句解析失败", token);
                     return false;
                 }
                 break;
 
             case JINGHAO:
-                //  "#~"
-                pos++; //  #
+                // 检查程序结束标记 "#~"
+                pos++; // 跳过 #
                 if (pos < tokens.size() && tokens[pos].value == "~") {
-                    std::cout << "ֳ #~" << std::endl;
-                    pos++; //  ~
-                    std::cout << "" << std::endl;
+                    std::cout << "发现程序结束标记 #~" << std::endl;
+                    pos++; // 跳过 ~
+                    std::cout << "程序解析完成" << std::endl;
                     return true;
                 }
-                reportError("ĳǣҪ #~", token);
+                reportError("不完整的程序结束标记，需要 #~", token);
                 return false;
 
             default:
-                reportError("ĴʷԪ", token);
+                reportError("意外的词法单元", token);
                 return false;
             }
         }
 
-        // ﵫû #~Ҳ
+        // 如果到达这里但没有遇到 #~，也报告错误
         Token invalidToken;
-        reportError("ȱٳ #~", invalidToken);
+        reportError("缺少程序结束标记 #~", invalidToken);
         return false;
     }
     catch (const std::exception& e) {
-        std::cerr << "̷쳣: " << e.what() << std::endl;
+        std::cerr << "解析过程发生异常: " << e.what() << std::endl;
         return false;
     }
 }
 
-// 
+// 解析复合语句
 bool Parser::parseCompoundStatement(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "俪ʼ" << std::endl;
+    std::cout << "解析复合语句开始" << std::endl;
 
-    // beginؼ
+    // 检查begin关键字
     if (tokens[pos].type != SY_BEGIN) {
-        reportError("ȱbeginؼ", tokens[pos]);
+        reportError("缺少begin关键字", tokens[pos]);
         return false;
     }
     pos++;
 
-    // ڵ
+    // 创建复合语句节点
     Node* compoundNode = new Node("Compound");
-    if (!currentStatement) {
-        ast = compoundNode;  // ǵһ䣬ΪASTڵ㣬ʾһ
-    }
-    else {
-        currentStatement->children.push_back(compoundNode);//½ڵΪǰڵӽڵ
-    }
-    Node* previousStatement = currentStatement;//л
-    currentStatement = compoundNode;//´ĸڵ
+    currentStatement->children.push_back(compoundNode);//新节点添加为当前节点的子节点
+    Node* previousStatement = currentStatement;//切换上下文
+    currentStatement = compoundNode;//换到新创建的复合语句节点
 
-    // Уֱend
+    // 解析语句序列，直到遇到end
     while (pos < tokens.size() && tokens[pos].type != SY_END) {
         switch (tokens[pos].type) {
         case SY_IF:
-            if (!parseIfStatement(tokens, pos)) return false;
+            if (!parseIfStatement(tokens, pos)) return abandonStatement(compoundNode, previousStatement);
             break;
         case SY_WHILE:
-            if (!parseWhileStatement(tokens, pos)) return false;
+            if (!parseWhileStatement(tokens, pos)) return abandonStatement(compoundNode, previousStatement);
             break;
         case IDENT:
-            if (!parseAssignmentStatement(tokens, pos)) return false;
+            if (!parseAssignmentStatement(tokens, pos)) return abandonStatement(compoundNode, previousStatement);
             break;
         case SEMICOLON:
             pos++;
             continue;
         default:
-            if (tokens[pos].type != SY_END) { // ҪendΪ
-                reportError("Ч俪ʼ", tokens[pos]);
-                return false;
+            if (tokens[pos].type != SY_END) { // 不要把end报告为错误
+                reportError("无效的语句开始", tokens[pos]);
+                return abandonStatement(compoundNode, previousStatement);
             }
         }
 
-        // ָ
+        // 处理语句分隔符
         if (pos < tokens.size() && tokens[pos].type == SEMICOLON) {
             pos++;
         }
     }
 
-    // endؼ
+    // 检查end关键字
     if (pos >= tokens.size() || tokens[pos].type != SY_END) {
-        reportError("ȱendؼ", tokens[pos]);
-        return false;
+        reportError("缺少end关键字", tokens[pos]);
+        return abandonStatement(compoundNode, previousStatement);
     }
     pos++;
 
-    currentStatement = previousStatement;  // ָǰָ
-    std::cout << "" << std::endl;
+    currentStatement = previousStatement;  // 恢复当前语句指针
+    std::cout << "复合语句解析完成" << std::endl;
     return true;
 }
 
-// ͨ
+// 解析通用语句
 bool Parser::parseStatement(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "俪ʼ" << std::endl;
+    std::cout << "解析语句开始" << std::endl;
 
     if (pos >= tokens.size()) {
         Token invalidToken;
-        reportError("", invalidToken);
+        reportError("意外的语句结束", invalidToken);
         return false;
     }
 
@@ -195,351 +202,401 @@ bool Parser::parseStatement(const std::vector<Token>& tokens, size_t& pos) {
     case IDENT:
         return parseAssignmentStatement(tokens, pos);
     default:
-        reportError("Ч", tokens[pos]);
+        reportError("无效的语句", tokens[pos]);
         return false;
     }
 }
 
-// if
+// 解析if语句
 bool Parser::parseIfStatement(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "if俪ʼ" << std::endl;
+    std::cout << "解析if语句开始" << std::endl;
+
+    pos++; // 跳过if
 
-    pos++; // if
+    // if节点的子节点依次为条件、then部分与else部分
+    Node* ifNode = new Node("Statement", "if");
+    currentStatement->children.push_back(ifNode);
+    Node* previousStatement = currentStatement;
+    currentStatement = ifNode;
 
-    // ʽ
+    // 解析布尔表达式
     if (!parseBooleanExpression(tokens, pos)) {
-        return false;
+        return abandonStatement(ifNode, previousStatement);
     }
 
-    // תתelse
+    // 生成条件跳转，跳转到else部分
     int falseJump = quadIndex;
-    generateJump("", "", "", 0);  // ֱת0ռλ
+    generateJump("", "", "", 0);  // 直接跳转，0先占位，后面回填
 
-    // thenؼ
+    // 检查then关键字
     if (pos >= tokens.size() || tokens[pos].type != SY_THEN) {
-        reportError("ȱthenؼ", tokens[pos]);
-        return false;
+        reportError("缺少then关键字", tokens[pos]);
+        return abandonStatement(ifNode, previousStatement);
     }
     pos++;
 
-    // then
+    // 解析then部分
     if (!parseStatement(tokens, pos)) {
-        return false;
+        return abandonStatement(ifNode, previousStatement);
     }
 
-    // elseֵת
+    // 跳过else部分的跳转
     int skipElseJump = quadIndex;
-    generateJump("", "", "", 0);  // ռλ
+    generateJump("", "", "", 0);  // 先占位，后面回填
 
-    // Ϊʱתַ
+    // 回填条件为假时的跳转地址
     backPatch(falseJump, quadIndex);
 
-    // elseؼ
+    // 检查else关键字
     if (pos < tokens.size() && tokens[pos].type == SY_ELSE) {
         pos++;
         if (!parseStatement(tokens, pos)) {
-            return false;
+            return abandonStatement(ifNode, previousStatement);
         }
     }
 
-    // elseֵתַ
+    // 回填跳过else部分的跳转地址
     backPatch(skipElseJump, quadIndex);
 
+    currentStatement = previousStatement;
     return true;
 }
 
-// while
+// 解析while语句
 bool Parser::parseWhileStatement(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "while俪ʼ" << std::endl;
+    std::cout << "解析while语句开始" << std::endl;
 
-    int startLabel = quadIndex;  // ѭʼλãںָ
-    pos++; // while
+    int startLabel = quadIndex;  // 循环开始位置，用于后续生成跳回指令
+    pos++; // 跳过while
 
-    // 
+    // while节点的子节点依次为条件与循环体
+    Node* whileNode = new Node("Statement", "while");
+    currentStatement->children.push_back(whileNode);
+    Node* previousStatement = currentStatement;
+    currentStatement = whileNode;
+
+    // 处理条件
     if (pos < tokens.size() && tokens[pos].type == LPARENT) {
-        pos++; // 
+        pos++; // 跳过左括号
     }
 
-    // ʽ
+    // 解析布尔表达式
     if (!parseBooleanExpression(tokens, pos)) {
-        return false;
+        return abandonStatement(whileNode, previousStatement);
     }
 
     if (pos < tokens.size() && tokens[pos].type == RPARENT) {
-        pos++; // 
+        pos++; // 跳过右括号
     }
 
-    // ת
-    int condJump = quadIndex;//¼תָλ(ں)
-    int elseLabel = quadIndex + 2;  // Ԥѭλ(ʵʿܲͬ)
+    // 生成条件跳转
+    int condJump = quadIndex;//记录条件跳转指令的位置(用于后续回填)
+    int elseLabel = quadIndex + 2;  // 预估的循环体结束位置(实际可能不同)
     generateJump("", "", "", elseLabel);
 
-    // doؼ
+    // 检查do关键字
     if (pos >= tokens.size() || tokens[pos].type != SY_DO) {
-        reportError("ȱdoؼ", tokens[pos]);
-        return false;
+        reportError("缺少do关键字", tokens[pos]);
+        return abandonStatement(whileNode, previousStatement);
     }
     pos++;
 
-    // ѭ
+    // 解析循环体
     if (!parseStatement(tokens, pos)) {
-        return false;
+        return abandonStatement(whileNode, previousStatement);
     }
 
-    // ѭתؿʼ
+    // 生成循环跳转回开始
     generateJump("", "", "", startLabel);
 
-    // ѭλ
+    // 设置循环结束的位置
     int endLabel = quadIndex;
 
-    // ֮ǰɵռλתָĿַΪendLabel
+    // 将之前生成的占位跳转指令的目标地址填充为endLabel
     backPatch(condJump, endLabel);
 
+    currentStatement = previousStatement;
     return true;
 }
 
-// ֵ
+// 解析赋值语句
 bool Parser::parseAssignmentStatement(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "ֵ俪ʼ" << std::endl;
+    std::cout << "解析赋值语句开始" << std::endl;
 
-    // 沢ʶ
+    // 保存并检查左侧标识符
     if (pos >= tokens.size() || tokens[pos].type != IDENT) {
-        reportError("ȱٱʶ", tokens[pos]);
+        reportError("缺少标识符", tokens[pos]);
         return false;
     }
     std::string identifier = tokens[pos].value;
     pos++;
 
-    // 鸳ֵ
+    // 检查赋值符号
     if (pos >= tokens.size() || tokens[pos].type != BECOMES) {
-        reportError("ȱٸֵ", tokens[pos]);
+        reportError("缺少赋值符号", tokens[pos]);
         return false;
     }
     pos++;
 
-    // Ҳʽ
+    // 解析右侧表达式
     if (!parseExpression(tokens, pos)) {
         return false;
     }
 
-    // ɸֵԪʽ
+    // 生成赋值四元式
     generateQuadruple(":=", expressionResult, "", identifier);
-    std::cout << "ֵ" << std::endl;
+    Node* assignNode = new Node("Statement", ":=");
+    assignNode->children.push_back(new Node("Identifier", identifier));
+    assignNode->children.push_back(expressionNode);
+    currentStatement->children.push_back(assignNode);
+    std::cout << "赋值语句解析完成" << std::endl;
     return true;
 }
 
-// ʽݹ½
+// 解析表达式，递归下降解析器
 bool Parser::parseExpression(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "ʽʼ" << std::endl;
+    std::cout << "解析表达式开始" << std::endl;
 
     if (!parseTerm(tokens, pos)) {
         return false;
     }
-    std::string leftOperand = expressionResult;//
+    std::string leftOperand = expressionResult;//保存左操作数
+    Node* leftNode = expressionNode;
 
-    // ӷ
+    // 处理加法运算
     while (pos < tokens.size() && tokens[pos].type == PLUS) {
-        pos++; // Ӻ
+        pos++; // 跳过加号
         //
-        if (!parseTerm(tokens, pos)) {//Ҳ
-            return false;
+        if (!parseTerm(tokens, pos)) {//解析右操作数
+            return discardExpression(leftNode);
         }
-        std::string rightOperand = expressionResult;//Ҳ
+        std::string rightOperand = expressionResult;//保存右操作数结果
 
-        // ʱ洢
+        // 生成临时变量存储结果
         std::string result = "T" + std::to_string(tempVarCounter++);
-        generateQuadruple("+", leftOperand, rightOperand, result);//Ԫʽ
-        expressionResult = result;//½
+        generateQuadruple("+", leftOperand, rightOperand, result);//生成四元式
+        expressionResult = result;//更新结果
+        expressionNode = makeBinary("+", leftNode, expressionNode);
         leftOperand = result;
+        leftNode = expressionNode;
     }
 
-    // ˷
+    // 处理乘法运算
     while (pos < tokens.size() && tokens[pos].type == TIMES) {
-        pos++; // ˺
+        pos++; // 跳过乘号
         std::string leftOperand = expressionResult;
+        Node* leftNode = expressionNode;
 
         if (!parseFactor(tokens, pos)) {
-            return false;
+            return discardExpression(leftNode);
         }
 
         std::string rightOperand = expressionResult;
         std::string result = "T" + std::to_string(tempVarCounter++);
         generateQuadruple("*", leftOperand, rightOperand, result);
         expressionResult = result;
+        expressionNode = makeBinary("*", leftNode, expressionNode);
     }
 
-    std::cout << "ʽ" << std::endl;
+    std::cout << "表达式解析完成" << std::endl;
     return true;
 }
 
-// 
+// 解析项
 bool Parser::parseTerm(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "ʼ" << std::endl;
+    std::cout << "解析项开始" << std::endl;
 
     if (!parseFactor(tokens, pos)) {
         return false;
     }
 
-    // ӷ
+    // 处理加法运算
     while (pos < tokens.size() && tokens[pos].type == PLUS) {
-        pos++; // Ӻ
-        std::string leftOperand = expressionResult;//
-        if (!parseTerm(tokens, pos)) {//Ҳ
-            return false;
+        pos++; // 跳过加号
+        std::string leftOperand = expressionResult;//保存左操作数
+        Node* leftNode = expressionNode;
+        if (!parseTerm(tokens, pos)) {//解析右操作数
+            return discardExpression(leftNode);
         }
-        std::string rightOperand = expressionResult;//Ҳ
+        std::string rightOperand = expressionResult;//保存右操作数
 
-        // ʱ洢
+        // 生成临时变量存储结果
         std::string result = "T" + std::to_string(tempVarCounter++);
-        generateQuadruple("+", leftOperand, rightOperand, result);//Ԫʽ
-        expressionResult = result;//½
-        leftOperand = result;//֧
+        generateQuadruple("+", leftOperand, rightOperand, result);//生成四元式
+        expressionResult = result;//更新结果
+        expressionNode = makeBinary("+", leftNode, expressionNode);
+        leftOperand = result;//以支持连续计算
     }
 
-    // ˷
+    // 处理乘法运算
     while (pos < tokens.size() && tokens[pos].type == TIMES) {
-        pos++; // ˺
+        pos++; // 跳过乘号
         std::string leftOperand = expressionResult;
+        Node* leftNode = expressionNode;
 
         if (!parseFactor(tokens, pos)) {
-            return false;
+            return discardExpression(leftNode);
         }
 
         std::string rightOperand = expressionResult;
         std::string result = "T" + std::to_string(tempVarCounter++);
         generateQuadruple("*", leftOperand, rightOperand, result);
         expressionResult = result;
+        expressionNode = makeBinary("*", leftNode, expressionNode);
     }
 
-    std::cout << "" << std::endl;
+    std::cout << "项解析完成" << std::endl;
     return true;
 }
 
-// 
+// 解析因子
 bool Parser::parseFactor(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "ӿʼ" << std::endl;
+    std::cout << "解析因子开始" << std::endl;
 
-    if (pos >= tokens.size()) {//жǷ񳬹tokenȣ+
+    if (pos >= tokens.size()) {//判断是否超过token长度，如+后无内容
         Token invalidToken;
-        reportError("ʽǷ", invalidToken);
+        reportError("表达式非法结束", invalidToken);
         return false;
     }
 
     const Token& token = tokens[pos];
     switch (token.type) {
-    case IDENT:  // ʶ
-    case INTCONST:  // ͳ
+    case IDENT:  // 标识符
+    case INTCONST:  // 整型常量
         expressionResult = token.value;
+        expressionNode = new Node(token.type == IDENT ? "Identifier" : "Number", token.value);
         pos++;
         break;
 
-    case LPARENT:  // űʽ
-        pos++; // 
-        if (!parseExpression(tokens, pos)) {//ʽ
+    case LPARENT:  // 括号表达式
+        pos++; // 跳过左括号
+        if (!parseExpression(tokens, pos)) {//解析表达式
             return false;
         }
         if (pos >= tokens.size() || tokens[pos].type != RPARENT) {
-            reportError("ȱ", tokens[pos]);
-            return false;
+            reportError("缺少右括号", tokens[pos]);
+            return discardExpression(expressionNode);
         }
-        pos++; // 
+        pos++; // 跳过右括号
         break;
 
     default:
-        reportError("Ƿ", token);
+        reportError("非法的因子", token);
         return false;
     }
 
-    std::cout << "ӽ" << std::endl;
+    std::cout << "因子解析完成" << std::endl;
     return true;
 }
 
-// ŵĲʽ
+// 解析带括号的布尔表达式
 bool Parser::parseParenBooleanExpression(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "ŵĲʽʼ" << std::endl;
+    std::cout << "解析带括号的布尔表达式开始" << std::endl;
 
-    // 
+    // 检查左括号
     if (pos >= tokens.size() || tokens[pos].type != LPARENT) {
-        reportError("ȱ", tokens[pos]);
+        reportError("缺少左括号", tokens[pos]);
         return false;
     }
-    pos++; // 
+    pos++; // 跳过左括号
 
-    // ʽ
+    // 解析布尔表达式内容
     if (!parseBooleanExpression(tokens, pos)) {
         return false;
     }
 
-    // 
+    // 检查右括号
     if (pos >= tokens.size() || tokens[pos].type != RPARENT) {
-        reportError("ȱ", tokens[pos]);
+        reportError("缺少右括号", tokens[pos]);
         return false;
     }
-    pos++; // 
+    pos++; // 跳过右括号
 
     return true;
 }
 
-// ʽ
+// 解析布尔表达式
 bool Parser::parseBooleanExpression(const std::vector<Token>& tokens, size_t& pos) {
-    std::cout << "ʽʼ" << std::endl;
+    std::cout << "解析布尔表达式开始" << std::endl;
 
-    // 
+    // 解析左操作数
     if (!parseExpression(tokens, pos)) {
         return false;
     }
-    std::string leftOperand = expressionResult;//
+    std::string leftOperand = expressionResult;//保存左操作数
+    Node* leftNode = expressionNode;
 
-    // ȡϵ
+    // 获取关系运算符
     if (pos >= tokens.size() || tokens[pos].type != ROP) {
-        reportError("ȱٹϵ", tokens[pos]);
-        return false;
+        reportError("缺少关系运算符", tokens[pos]);
+        return discardExpression(leftNode);
     }
     std::string op = tokens[pos].value;
     pos++;
 
-    // Ҳ
+    // 解析右操作数
     if (!parseExpression(tokens, pos)) {
-        return false;
+        return discardExpression(leftNode);
     }
-    std::string rightOperand = expressionResult;//Ҳ
+    std::string rightOperand = expressionResult;//保存右操作数
+
+    // 条件节点：值为关系运算符，子节点为两侧的表达式
+    Node* condition = new Node("Condition", op);
+    condition->children.push_back(leftNode);
+    condition->children.push_back(expressionNode);
+    currentStatement->children.push_back(condition);
 
-    // תָ
-    int nextQuad = quadIndex + 2;  // ŵת
+    // 生成条件跳转指令
+    int nextQuad = quadIndex + 2;  // 跳过紧跟着的无条件跳转
     generateJump(op, leftOperand, rightOperand, nextQuad);
 
     return true;
 }
 
-// ȡɵԪʽб
+// 语句解析失败：把未完成的语句节点从语法树中摘下释放，恢复当前语句指针
+bool Parser::abandonStatement(Node* statement, Node* previousStatement) {
+    previousStatement->children.pop_back();  // 内层语句失败时已摘下自己，这里总是最后一个子节点
+    delete statement;
+    currentStatement = previousStatement;
+    return false;
+}
+
+// 表达式解析失败：释放已建好的部分子树
+bool Parser::discardExpression(Node* partial) {
+    delete partial;
+    expressionNode = nullptr;
+    return false;
+}
+
+// 获取生成的四元式列表
 std::vector<std::string> Parser::getQuadruples() const {
     return quadruples;
 }
 
-// ȡ﷨
+// 获取抽象语法树
 Node* Parser::getAST() const {
     return ast;
 }
 
-// ȡʷԪϢַ
+// 获取词法单元信息字符串
 std::string Parser::getTokenInfo(const Token& token) {
     std::stringstream ss;
-    ss << ": " << tokenTypeToString(token.type)//תַ
-        << ", ֵ: " << token.value
-        << ", к: " << token.line;
+    ss << "类型: " << tokenTypeToString(token.type)//序号转成字符串
+        << ", 值: " << token.value
+        << ", 行号: " << token.line;
     return ss.str();
 }
 
-// Ϣ
+// 报告错误信息
 void Parser::reportError(const std::string& message, const Token& token) {
-    std::cerr << "﷨: " << message << " ";
+    std::cerr << "语法错误: " << message << " ";
     if (token.type != TokenType(-1)) {
-        std::cerr << " " << getTokenInfo(token);
+        std::cerr << "在 " << getTokenInfo(token);
     }
     std::cerr << std::endl;
 }
 
-// ʷԪתΪַʾ
+// 将词法单元类型转换为字符串表示
 std::string Parser::tokenTypeToString(TokenType type) {
     switch (type) {
     case SY_IF: return "IF";
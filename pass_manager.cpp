@@ -0,0 +1,215 @@
+#include "pass_manager.h"
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+
+const unsigned NEEDS_CFG = ANALYSIS_LOOPS | ANALYSIS_LIVENESS | ANALYSIS_SSA;
+
+// 四元式序列的 FNV-1a 指纹，用来判断遍是否改动了四元式
+uint64_t fingerprint(const std::vector<Quadruple>& quads) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::string& s) {
+        for (unsigned char c : s) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        hash = (hash ^ 0x1f) * 1099511628211ull;
+    };
+    for (const auto& quad : quads) {
+        mix(std::to_string(quad.label));
+        mix(quad.op);
+        mix(quad.arg1);
+        mix(quad.arg2);
+        mix(quad.result);
+    }
+    return hash;
+}
+
+bool same_quad(const Quadruple& a, const Quadruple& b) {
+    return a.label == b.label && a.op == b.op && a.arg1 == b.arg1 && a.arg2 == b.arg2 && a.result == b.result;
+}
+
+double milliseconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string analysis_names(unsigned kinds) {
+    static const std::pair<unsigned, const char*> names[] = {
+        { ANALYSIS_CFG, "cfg" }, { ANALYSIS_LOOPS, "loops" }, { ANALYSIS_LIVENESS, "live" },
+        { ANALYSIS_SSA, "ssa" }, { ANALYSIS_NAMES, "names" },
+    };
+    std::string text;
+    for (const auto& entry : names) {
+        if (!(kinds & entry.first)) continue;
+        if (!text.empty()) text += ",";
+        text += entry.second;
+    }
+    return text.empty() ? "-" : text;
+}
+
+}
+
+void Analyses::require(unsigned kind) const {
+    if (!(validMask & kind)) {
+        throw std::runtime_error("分析结果未计算或已失效：" + analysis_names(kind));
+    }
+}
+
+const CFG& Analyses::cfg() const {
+    require(ANALYSIS_CFG);
+    return cfgData;
+}
+
+const std::vector<Loop>& Analyses::loops() const {
+    require(ANALYSIS_LOOPS);
+    return loopData;
+}
+
+const Liveness& Analyses::liveness() const {
+    require(ANALYSIS_LIVENESS);
+    return livenessData;
+}
+
+const SSAForm& Analyses::ssa() const {
+    require(ANALYSIS_SSA);
+    return ssaData;
+}
+
+const NameCounts& Analyses::names() const {
+    require(ANALYSIS_NAMES);
+    return nameData;
+}
+
+PassManager::PassManager(unsigned threadCount) : pool(threadCount) {}
+
+void PassManager::add_pass(const std::string& name, FunctionPass run, unsigned needs, unsigned preserves) {
+    Pass pass;
+    pass.name = name;
+    pass.function = std::move(run);
+    pass.needs = needs;
+    pass.preserves = preserves;
+    passes.push_back(std::move(pass));
+}
+
+void PassManager::add_block_pass(const std::string& name, BlockPass run, unsigned needs) {
+    Pass pass;
+    pass.name = name;
+    pass.block = std::move(run);
+    pass.needs = needs | ANALYSIS_CFG;
+    passes.push_back(std::move(pass));
+}
+
+void PassManager::set_observer(Observer observer) {
+    this->observer = std::move(observer);
+}
+
+// 补算缺少的分析：第一层是控制流图与名字计数，第二层是依赖控制流图的循环、活跃变量与SSA，
+// 同一层的分析各写各的结果，在线程池中同时计算
+unsigned PassManager::prepare(const std::vector<Quadruple>& quads, unsigned needs) {
+    if (needs & NEEDS_CFG) needs |= ANALYSIS_CFG;
+    unsigned missing = needs & ~cache.validMask;
+    if (missing == 0) return 0;
+    std::vector<std::function<void()>> first, second;
+    if (missing & ANALYSIS_CFG) {
+        first.push_back([&]() {
+            cache.cfgData = build_cfg(quads);
+            compute_dominators(cache.cfgData);
+        });
+    }
+    if (missing & ANALYSIS_NAMES) {
+        first.push_back([&]() { cache.nameData = count_names(quads); });
+    }
+    if (missing & ANALYSIS_LOOPS) {
+        second.push_back([&]() { cache.loopData = find_loops(cache.cfgData); });
+    }
+    if (missing & ANALYSIS_LIVENESS) {
+        second.push_back([&]() { cache.livenessData = compute_liveness(quads, cache.cfgData); });
+    }
+    if (missing & ANALYSIS_SSA) {
+        second.push_back([&]() { cache.ssaData = build_ssa(quads, cache.cfgData); });
+    }
+    for (auto* level : { &first, &second }) {
+        pool.parallelFor(level->size(), 1, [level](size_t k) { (*level)[k](); });
+    }
+    cache.validMask |= missing;
+    return missing;
+}
+
+// 四元式有变化时只保留 preserves 中的分析
+void PassManager::invalidate(const std::vector<Quadruple>& quads, unsigned preserves) {
+    uint64_t current = fingerprint(quads);
+    if (current == cache.fingerprint) return;
+    cache.validMask &= preserves;
+    cache.fingerprint = current;
+}
+
+const Analyses& PassManager::analyses(const std::vector<Quadruple>& quads, unsigned needs) {
+    invalidate(quads, 0);
+    prepare(quads, needs);
+    return cache;
+}
+
+void PassManager::runBlockPass(const Pass& pass, std::vector<Quadruple>& quads, PassReport& report) {
+    const CFG& cfg = cache.cfgData;
+    int blocks = cfg.num_blocks();
+    std::vector<BlockWork> works(blocks);
+    std::vector<int> changed(blocks, 0);
+    pool.parallelFor(blocks, 16, [&](size_t b) {
+        BlockWork& work = works[b];
+        work = block_work(quads, cfg, static_cast<int>(b));
+        pass.block(work, cache);
+        for (size_t k = 0; k < work.quads.size(); k++) {
+            changed[b] += work.removed[k] || !same_quad(work.quads[k], quads[cfg.first_quad(static_cast<int>(b)) + k]);
+        }
+    });
+    bool removed = false;
+    for (int b = 0; b < blocks; b++) {
+        report.changes += changed[b];
+        for (int c = 0; c < 4; c++) report.counts[c] += works[b].counts[c];
+        for (char r : works[b].removed) removed = removed || r;
+    }
+    merge_block_work(quads, works);
+    invalidate(quads, removed ? 0 : ANALYSIS_CFG | ANALYSIS_LOOPS);
+}
+
+std::vector<PassReport> PassManager::run(std::vector<Quadruple>& quads) {
+    std::vector<PassReport> reports;
+    invalidate(quads, 0);
+    for (const auto& pass : passes) {
+        PassReport report;
+        report.name = pass.name;
+        report.block_local = static_cast<bool>(pass.block);
+        report.before = static_cast<int>(quads.size());
+        auto start = std::chrono::steady_clock::now();
+        report.computed = prepare(quads, pass.needs);
+        report.analysis_ms = milliseconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        if (report.block_local) {
+            if (!quads.empty()) runBlockPass(pass, quads, report);
+        }
+        else {
+            report.changes = pass.function(quads, cache);
+            invalidate(quads, pass.preserves);
+        }
+        report.ms = milliseconds_since(start);
+        report.after = static_cast<int>(quads.size());
+        if (observer) observer(report, quads);
+        reports.push_back(report);
+    }
+    return reports;
+}
+
+void print_pass_reports(const std::vector<PassReport>& reports, std::ostream& out) {
+    out << std::left << std::setw(12) << "遍" << std::setw(6) << "方式" << std::right
+        << std::setw(10) << "分析(ms)" << std::setw(10) << "耗时(ms)" << std::setw(8) << "改动"
+        << std::setw(8) << "优化前" << std::setw(8) << "优化后" << "  补算的分析" << std::endl;
+    for (const auto& report : reports) {
+        out << std::left << std::setw(12) << report.name << std::setw(6) << (report.block_local ? "块内" : "整体")
+            << std::right << std::fixed << std::setprecision(2) << std::setw(10) << report.analysis_ms
+            << std::setw(10) << report.ms << std::setw(8) << report.changes << std::setw(8) << report.before
+            << std::setw(8) << report.after << "  " << analysis_names(report.computed) << std::endl;
+    }
+    out.unsetf(std::ios::floatfield);
+}
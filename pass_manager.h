@@ -0,0 +1,110 @@
+#pragma once
+#ifndef PASS_MANAGER_H
+#define PASS_MANAGER_H
+
+#include "assembler.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "parallel.h"
+#include "ssa.h"
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 遍管理器缓存的整体分析，按位组合。循环、活跃变量与SSA依赖控制流图（含支配树）
+enum AnalysisKind : unsigned {
+    ANALYSIS_CFG = 1,       // 控制流图与支配树
+    ANALYSIS_LOOPS = 2,     // 自然循环
+    ANALYSIS_LIVENESS = 4,  // 活跃变量
+    ANALYSIS_SSA = 8,       // SSA视图
+    ANALYSIS_NAMES = 16,    // 各名字的定值、引用次数
+};
+
+// 对当前四元式序列有效的分析结果；取用未计算或已失效的分析时抛出异常
+class Analyses {
+public:
+    unsigned valid() const { return validMask; }
+    const CFG& cfg() const;
+    const std::vector<Loop>& loops() const;
+    const Liveness& liveness() const;
+    const SSAForm& ssa() const;
+    const NameCounts& names() const;
+
+private:
+    friend class PassManager;
+    unsigned validMask = 0;
+    uint64_t fingerprint = 0;  // 计算时四元式序列的指纹
+    CFG cfgData;
+    std::vector<Loop> loopData;
+    Liveness livenessData;
+    SSAForm ssaData;
+    NameCounts nameData;
+
+    void require(unsigned kind) const;
+};
+
+// 一遍的运行报告
+struct PassReport {
+    std::string name;
+    bool block_local = false;
+    unsigned computed = 0;    // 运行前补算的分析
+    double analysis_ms = 0;   // 补算分析的耗时
+    double ms = 0;            // 遍本身的耗时（块内遍含合并）
+    int changes = 0;          // 整体遍：遍报告的改动数；块内遍：改写或删除的四元式数
+    int counts[4] = { 0, 0, 0, 0 };  // 块内遍各块 counts 之和
+    int before = 0, after = 0;       // 运行前后的四元式数
+};
+
+// 优化遍管理器
+// 按加入的顺序运行各遍。遍声明需要的整体分析，缺少的在运行前补算，互不依赖的分析在线程池中
+// 同时计算；分析结果一直缓存到某一遍改动了四元式且不声明保持它为止。
+// 块内遍的各块在工作窃取线程池中并行处理，每块只读共享的分析、写自己的工作单元，
+// 结果按块的顺序合并，因此与单线程运行的结果逐位相同
+class PassManager {
+public:
+    // 整体遍：返回改动数
+    using FunctionPass = std::function<int(std::vector<Quadruple>&, const Analyses&)>;
+    // 块内遍：处理一个块（见 cfg.h 的 BlockWork），可能在任一线程中调用
+    using BlockPass = std::function<void(BlockWork&, const Analyses&)>;
+    using Observer = std::function<void(const PassReport&, const std::vector<Quadruple>&)>;
+
+    // threadCount为0时使用全部硬件线程
+    explicit PassManager(unsigned threadCount = 0);
+
+    // 整体遍改动了四元式时，除 preserves 之外的分析失效
+    void add_pass(const std::string& name, FunctionPass run, unsigned needs = 0, unsigned preserves = 0);
+    // 块内遍总是需要控制流图。它不改动跳转，没有删除四元式时控制流图与循环仍然有效
+    void add_block_pass(const std::string& name, BlockPass run, unsigned needs = 0);
+    // 每遍结束后在调用线程中调用，例如核对语义或打印统计
+    void set_observer(Observer observer);
+
+    // 依次运行全部遍，返回各遍的报告
+    std::vector<PassReport> run(std::vector<Quadruple>& quads);
+    // 对 quads 备齐 needs 中的分析，缓存中仍有效的直接使用
+    const Analyses& analyses(const std::vector<Quadruple>& quads, unsigned needs);
+    unsigned threads() const { return pool.size(); }
+
+private:
+    struct Pass {
+        std::string name;
+        FunctionPass function;
+        BlockPass block;
+        unsigned needs = 0;
+        unsigned preserves = 0;
+    };
+    ThreadPool pool;
+    std::vector<Pass> passes;
+    Observer observer;
+    Analyses cache;
+
+    unsigned prepare(const std::vector<Quadruple>& quads, unsigned needs);
+    void invalidate(const std::vector<Quadruple>& quads, unsigned preserves);
+    void runBlockPass(const Pass& pass, std::vector<Quadruple>& quads, PassReport& report);
+};
+
+// 打印各遍的报告
+void print_pass_reports(const std::vector<PassReport>& reports, std::ostream& out);
+
+#endif // PASS_MANAGER_H
@@ -0,0 +1,209 @@
+#include "peephole.h"
+#include <set>
+#include <utility>
+
+AsmInstruction label_line(const std::string& label) {
+    AsmInstruction line;
+    line.label = label;
+    return line;
+}
+
+std::string format_instruction(const AsmInstruction& line) {
+    if (!line.label.empty()) return line.label + ":";
+    std::string text = "    " + line.op;
+    if (!line.a.empty()) text += " " + line.a;
+    if (!line.b.empty()) text += ", " + line.b;
+    return text;
+}
+
+const AsmInstruction* PeepholeView::target(const std::string& label) const {
+    auto it = labels.find(label);
+    if (it == labels.end()) return nullptr;
+    for (size_t k = it->second; k < code.size(); k++) {
+        if (code[k].label.empty()) return &code[k];
+    }
+    return nullptr;
+}
+
+namespace {
+
+bool is_label(const AsmInstruction& line) { return !line.label.empty(); }
+// 经跳转表的 jmp word ptr T[r] 是间接转移，目标不是标号，不算作 is_jump
+bool is_indirect(const AsmInstruction& line) { return !is_label(line) && line.op == "jmp" && line.memory; }
+bool is_jump(const AsmInstruction& line) {
+    return is_label(line) || is_indirect(line) ? false : !line.op.empty() && line.op[0] == 'j';
+}
+bool is_goto(const AsmInstruction& line) { return is_jump(line) && line.op == "jmp"; }
+bool is_move(const AsmInstruction& line) { return !is_label(line) && line.op == "mov"; }
+
+// 条件转移指令取反
+std::string inverse_jump(const std::string& op) {
+    static const std::pair<const char*, const char*> pairs[] = {
+        { "jl", "jge" }, { "jle", "jg" }, { "je", "jne" }, { "jz", "jnz" },
+        { "jb", "jae" }, { "jbe", "ja" }, { "js", "jns" }, { "jo", "jno" },
+    };
+    for (const auto& pair : pairs) {
+        if (op == pair.first) return pair.second;
+        if (op == pair.second) return pair.first;
+    }
+    return "";
+}
+
+// i 之后紧接的一串标号行中是否有 label
+bool labels_follow(const PeepholeView& view, size_t i, const std::string& label) {
+    for (size_t k = i; k < view.code.size() && is_label(view.code[k]); k++) {
+        if (view.code[k].label == label) return true;
+    }
+    return false;
+}
+
+// mov r, r
+bool self_move(const PeepholeView& view, size_t i, std::vector<AsmInstruction>&) {
+    const AsmInstruction& line = view.code[i];
+    return is_move(line) && line.a == line.b;
+}
+
+// mov x, AX 之后的 mov AX, x（或 mov AX, x 之后的 mov x, AX）：两者已经相等
+bool redundant_load(const PeepholeView& view, size_t i, std::vector<AsmInstruction>& out) {
+    const AsmInstruction& first = view.code[i];
+    const AsmInstruction& second = view.code[i + 1];
+    if (!is_move(first) || !is_move(second) || second.a != first.b || second.b != first.a) return false;
+    out.push_back(first);
+    return true;
+}
+
+// 紧接着又被写入而中间没有读过的目的：前一条复制是死的
+bool overwritten_move(const PeepholeView& view, size_t i, std::vector<AsmInstruction>& out) {
+    const AsmInstruction& first = view.code[i];
+    const AsmInstruction& second = view.code[i + 1];
+    if (!is_move(first) || !is_move(second) || second.a != first.a || second.b == first.a) return false;
+    out.push_back(second);
+    return true;
+}
+
+// 跳到紧接着的标号
+bool jump_to_next(const PeepholeView& view, size_t i, std::vector<AsmInstruction>&) {
+    const AsmInstruction& line = view.code[i];
+    return is_jump(line) && labels_follow(view, i + 1, line.a);
+}
+
+// jcc L1; jmp L2; L1:  =>  jncc L2; L1:
+bool jump_over_jump(const PeepholeView& view, size_t i, std::vector<AsmInstruction>& out) {
+    const AsmInstruction& branch = view.code[i];
+    const AsmInstruction& jump = view.code[i + 1];
+    if (!is_jump(branch) || is_goto(branch) || !is_goto(jump) || !labels_follow(view, i + 2, branch.a)) return false;
+    std::string inverse = inverse_jump(branch.op);
+    if (inverse.empty()) return false;
+    AsmInstruction inverted = branch;
+    inverted.op = inverse;
+    inverted.a = jump.a;
+    out.push_back(inverted);
+    return true;
+}
+
+// 跳到只有一条 jmp M 的标号：直接跳到 M。沿链走到底，遇到环时不改
+bool jump_thread(const PeepholeView& view, size_t i, std::vector<AsmInstruction>& out) {
+    const AsmInstruction& line = view.code[i];
+    if (!is_jump(line)) return false;
+    std::string final = line.a;
+    std::set<std::string> seen = { final };
+    for (const AsmInstruction* next = view.target(final); next && is_goto(*next); next = view.target(final)) {
+        if (!seen.insert(next->a).second) return false;
+        final = next->a;
+    }
+    if (final == line.a) return false;
+    AsmInstruction threaded = line;
+    threaded.a = final;
+    out.push_back(threaded);
+    return true;
+}
+
+// jmp 之后、下一个标号之前的指令不可达
+bool unreachable(const PeepholeView& view, size_t i, std::vector<AsmInstruction>& out) {
+    const AsmInstruction& jump = view.code[i];
+    const AsmInstruction& next = view.code[i + 1];
+    if (!(is_goto(jump) || is_indirect(jump)) || is_label(next)) return false;
+    out.push_back(jump);
+    return true;
+}
+
+void count(const std::vector<AsmInstruction>& code, int& instructions, int& cycles, int& memory) {
+    instructions = cycles = memory = 0;
+    for (const auto& line : code) {
+        if (is_label(line)) continue;
+        instructions++;
+        cycles += line.cycles;
+        if (line.memory) memory++;
+    }
+}
+
+}
+
+const std::vector<PeepholeRule>& default_peephole_rules() {
+    static const std::vector<PeepholeRule> rules = {
+        { "self-move", 1, self_move },
+        { "redundant-load", 2, redundant_load },
+        { "overwritten-move", 2, overwritten_move },
+        { "jump-to-next", 1, jump_to_next },
+        { "jump-over-jump", 2, jump_over_jump },
+        { "jump-thread", 1, jump_thread },
+        { "unreachable", 2, unreachable },
+    };
+    return rules;
+}
+
+PeepholeStats peephole_optimize(std::vector<AsmInstruction>& code, const std::vector<std::string>& keep,
+    const std::vector<PeepholeRule>& rules) {
+    PeepholeStats stats;
+    stats.hits.assign(rules.size(), 0);
+    count(code, stats.instructions_before, stats.cycles_before, stats.memory_before);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        stats.rounds++;
+        PeepholeView view{ code, {} };
+        for (size_t i = 0; i < code.size(); i++) {
+            if (is_label(code[i])) view.labels.emplace(code[i].label, i);
+        }
+
+        std::vector<AsmInstruction> result;
+        result.reserve(code.size());
+        std::vector<AsmInstruction> replacement;
+        for (size_t i = 0; i < code.size();) {
+            bool hit = false;
+            for (size_t r = 0; r < rules.size() && !hit; r++) {
+                if (i + rules[r].window > code.size()) continue;
+                replacement.clear();
+                if (rules[r].rewrite(view, i, replacement)) {
+                    hit = true;
+                    stats.hits[r]++;
+                    result.insert(result.end(), replacement.begin(), replacement.end());
+                    i += rules[r].window;
+                }
+            }
+            if (!hit) result.push_back(code[i++]);
+            changed = changed || hit;
+        }
+
+        // 删除没有被引用的标号
+        std::set<std::string> referenced(keep.begin(), keep.end());
+        for (const auto& line : result) {
+            if (is_label(line)) continue;
+            if (!line.a.empty()) referenced.insert(line.a);
+            if (!line.b.empty()) referenced.insert(line.b);
+        }
+        code.clear();
+        for (auto& line : result) {
+            if (is_label(line) && !referenced.count(line.label)) {
+                stats.labels++;
+                changed = true;
+                continue;
+            }
+            code.push_back(std::move(line));
+        }
+    }
+
+    count(code, stats.instructions_after, stats.cycles_after, stats.memory_after);
+    return stats;
+}
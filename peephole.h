@@ -0,0 +1,58 @@
+#pragma once
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 汇编代码的一行：标号或一条指令。label 非空时为标号行，其余字段不用
+struct AsmInstruction {
+    std::string label;
+    std::string op;
+    std::string a, b;     // 运算对象的文本，没有时为空
+    int cycles = 0;       // 按代价表估计的周期，供统计
+    bool memory = false;  // 是否访问数据段或栈
+};
+
+AsmInstruction label_line(const std::string& label);
+// 输出的文本：标号行为 "L:"，指令行缩进4格，运算对象以 ", " 分隔
+std::string format_instruction(const AsmInstruction& line);
+
+// 规则看到的代码：当前一轮开始时的指令序列，以及标号到其所在行下标的映射
+struct PeepholeView {
+    const std::vector<AsmInstruction>& code;
+    std::unordered_map<std::string, size_t> labels;
+
+    // 从标号 label 处开始执行的第一条指令（跳过连续的标号行），没有时为 nullptr
+    const AsmInstruction* target(const std::string& label) const;
+};
+
+// 窥孔规则：窗口为从 i 开始的 window 行。匹配时把替换这几行的代码写入 out 并返回 true
+// （out 可以为空，即删去整个窗口），否则返回 false 且不改动 out
+struct PeepholeRule {
+    const char* name;
+    size_t window;
+    bool (*rewrite)(const PeepholeView& view, size_t i, std::vector<AsmInstruction>& out);
+};
+
+// 默认的规则表：删除冗余的装入与存储、自身复制与被覆盖的复制，删除跳到下一行的跳转、
+// 跳转后不可达的指令，条件转移越过无条件转移时取反条件，穿过只有一条 jmp 的标号
+const std::vector<PeepholeRule>& default_peephole_rules();
+
+struct PeepholeStats {
+    std::vector<int> hits;  // 按规则表顺序，各规则的命中次数
+    int labels = 0;         // 删除的未被引用的标号
+    int rounds = 0;         // 扫描的轮数
+    int instructions_before = 0, instructions_after = 0;
+    int cycles_before = 0, cycles_after = 0;
+    int memory_before = 0, memory_after = 0;
+};
+
+// 滑动窗口窥孔优化：每一轮从前往后扫描，在每个位置按规则表的顺序试各条规则，
+// 命中时用替换代码代替窗口并跳过窗口；一轮结束后删除没有被任何指令引用的标号
+// （keep 中的除外）。反复进行直到一轮中没有改变
+PeepholeStats peephole_optimize(std::vector<AsmInstruction>& code, const std::vector<std::string>& keep = {},
+    const std::vector<PeepholeRule>& rules = default_peephole_rules());
+
+#endif // PEEPHOLE_H
@@ -0,0 +1,228 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// 运算所属的可结合运算族：+ 与 *，(-,x,常数) 看作 x + (-常数)
+std::string family(const Quadruple& quad) {
+    if (quad.op == "+" || quad.op == "*") return quad.op;
+    if (quad.op == "-" && is_number(quad.arg2)) return "+";
+    return "";
+}
+
+// 平衡二叉树的高度
+int tree_height(int leaves) {
+    int height = 0;
+    while ((1 << height) < leaves) height++;
+    return height;
+}
+
+struct Leaf {
+    std::string name;
+    int rank;  // 0：在所在最内层循环中不被改写（或不在循环中），1：循环内被改写
+};
+
+class Reassociator {
+public:
+    Reassociator(std::vector<Quadruple>& quads, ReassocStats& stats)
+        : quads(quads), stats(stats), n(static_cast<int>(quads.size())), cfg(build_cfg(quads)), edits(quads.size()),
+          newTemp(temp_allocator(quads)) {
+        compute_dominators(cfg);
+        loops = find_loops(cfg);
+        innermost.assign(cfg.num_blocks(), -1);
+        for (int l = 0; l < static_cast<int>(loops.size()); l++) {
+            for (int b : loops[l].blocks) {
+                if (innermost[b] < 0) innermost[b] = l;
+            }
+        }
+        loopDefs.resize(loops.size());
+        for (int l = 0; l < static_cast<int>(loops.size()); l++) {
+            for (int b : loops[l].blocks) {
+                for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+                    if (!is_jump(quads[i].op) && !quads[i].result.empty()) loopDefs[l].insert(quads[i].result);
+                }
+            }
+        }
+        for (const auto& quad : quads) {
+            for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                if (is_temp(*arg)) uses[*arg]++;
+            }
+            if (!is_jump(quad.op) && is_temp(quad.result)) defs[quad.result]++;
+        }
+        parent.assign(n, -1);
+    }
+
+    void run() {
+        for (int b = 0; b < cfg.num_blocks(); b++) {
+            if (cfg.reachable(b)) reassociateBlock(b);
+        }
+        if (stats.chains > 0) apply_edits(quads, edits);
+    }
+
+private:
+    std::vector<Quadruple>& quads;
+    ReassocStats& stats;
+    int n;
+    CFG cfg;
+    QuadEdits edits;
+    std::function<std::string()> newTemp;
+    std::vector<Loop> loops;
+    std::vector<int> innermost;
+    std::vector<std::unordered_set<std::string>> loopDefs;
+    std::unordered_map<std::string, int> uses, defs;
+    std::vector<int> parent;  // 链内部节点 -> 引用它的同族运算
+    std::unordered_map<std::string, int> defAt;
+
+    // 链内部节点：结果是整个程序中只定值、引用各一次的临时变量，唯一的引用是本块后面的同族运算。
+    // 不是内部节点的同族运算是一棵表达式树的根
+    void reassociateBlock(int b) {
+        int first = cfg.first_quad(b), last = cfg.last_quad(b);
+        defAt.clear();
+        for (int j = first; j <= last; j++) {
+            const Quadruple& quad = quads[j];
+            std::string op = family(quad);
+            if (op.empty()) continue;
+            for (const std::string* arg : { &quad.arg1, &quad.arg2 }) {
+                auto it = defAt.find(*arg);
+                if (it != defAt.end() && family(quads[it->second]) == op) parent[it->second] = j;
+            }
+            if (is_temp(quad.result) && defs[quad.result] == 1 && uses[quad.result] == 1) defAt[quad.result] = j;
+        }
+        for (int root = first; root <= last; root++) {
+            if (parent[root] < 0 && !family(quads[root]).empty()) reassociate(b, root);
+        }
+    }
+
+    // 展开以 index 为根的树：叶子按原顺序收集，常数合并，返回原树高
+    int collect(int index, const std::string& op, int block, std::vector<Leaf>& leaves, int16_t& constant,
+        int& constants, std::vector<int>& members) {
+        const Quadruple& quad = quads[index];
+        members.push_back(index);
+        int height = 0;
+        const std::string* args[] = { &quad.arg1, &quad.arg2 };
+        for (int k = 0; k < 2; k++) {
+            const std::string& arg = *args[k];
+            auto it = defAt.find(arg);
+            if (it != defAt.end() && parent[it->second] == index) {
+                height = std::max(height, collect(it->second, op, block, leaves, constant, constants, members));
+            }
+            else if (is_number(arg)) {
+                int16_t value = constant_value(arg);
+                if (quad.op == "-" && k == 1) value = static_cast<int16_t>(-value);
+                constant = static_cast<int16_t>(op == "+" ? constant + value : constant * value);
+                constants++;
+            }
+            else {
+                int l = innermost[block];
+                leaves.push_back(Leaf{ arg, l >= 0 && loopDefs[l].count(arg) ? 1 : 0 });
+            }
+        }
+        return height + 1;
+    }
+
+    void reassociate(int block, int root) {
+        const Quadruple top = quads[root];
+        std::string op = family(top);
+        std::vector<Leaf> leaves;
+        std::vector<int> members;
+        int16_t constant = op == "+" ? 0 : 1;
+        int constants = 0;
+        int height = collect(root, op, block, leaves, constant, constants, members);
+        if (members.size() < 2) return;
+
+        // 叶子原来在树中各处读取，改到根之前集中读取，其间不能被改写
+        int start = *std::min_element(members.begin(), members.end());
+        std::unordered_set<std::string> names;
+        for (const auto& leaf : leaves) names.insert(leaf.name);
+        for (int i = start; i < root; i++) {
+            if (!is_jump(quads[i].op) && names.count(quads[i].result)) return;
+        }
+
+        // 循环不变的叶子排在前面单独组成子树，可以被循环不变量外提移出循环
+        std::stable_sort(leaves.begin(), leaves.end(), [](const Leaf& a, const Leaf& b) { return a.rank < b.rank; });
+        int count = static_cast<int>(leaves.size());
+        int invariant = 0;
+        for (const auto& leaf : leaves) invariant += leaf.rank == 0;
+        bool zero = op == "*" && constants > 0 && constant == 0;
+        bool identity = constants == 0 || constant == (op == "+" ? 0 : 1);
+        bool grouped = !zero && innermost[block] >= 0 && invariant >= 2 && invariant < count;
+        int newOps = 1, newHeight = 1;
+        if (!zero && count > 0) {
+            newOps = count - 1 + (identity ? 0 : 1);
+            newHeight = (grouped ? std::max(tree_height(invariant), tree_height(count - invariant)) + 1 : tree_height(count)) +
+                (identity ? 0 : 1);
+        }
+        if (!(newOps < static_cast<int>(members.size()) || newHeight < height || grouped)) return;
+
+        // 每组两两配对成平衡树，两组再合起来，最后加上（乘上）常数；最后一条写回根的结果
+        std::vector<Quadruple> code;
+        auto balance = [&](std::vector<Leaf>::const_iterator from, std::vector<Leaf>::const_iterator to) {
+            std::vector<std::string> level;
+            for (auto it = from; it != to; ++it) level.push_back(it->name);
+            while (level.size() > 1) {
+                std::vector<std::string> next;
+                for (size_t k = 0; k + 1 < level.size(); k += 2) {
+                    next.push_back(newTemp());
+                    code.push_back(Quadruple{ 0, op, level[k], level[k + 1], next.back() });
+                }
+                if (level.size() % 2) next.push_back(level.back());
+                level.swap(next);
+            }
+            return level[0];
+        };
+        Quadruple result{ top.label, ":=", "", "", top.result };
+        if (zero || count == 0) {
+            result.arg1 = constant_string(zero ? 0 : constant);
+        }
+        else {
+            std::string value;
+            if (grouped) {
+                std::string invariantPart = balance(leaves.begin(), leaves.begin() + invariant);
+                std::string variantPart = balance(leaves.begin() + invariant, leaves.end());
+                value = newTemp();
+                code.push_back(Quadruple{ 0, op, invariantPart, variantPart, value });
+            }
+            else {
+                value = balance(leaves.begin(), leaves.end());
+            }
+            if (!identity) code.push_back(Quadruple{ 0, op, value, constant_string(constant), "" });
+            if (code.empty()) {
+                result.arg1 = value;
+            }
+            else {
+                result = code.back();
+                result.label = top.label;
+                result.result = top.result;
+                code.pop_back();
+            }
+        }
+
+        for (int member : members) {
+            if (member != root) edits.removed[member] = 1;
+        }
+        edits.before[root] = std::move(code);
+        quads[root] = result;
+        stats.chains++;
+        stats.folded += std::max(0, constants - 1) + (zero ? count : 0);
+        stats.grouped += grouped;
+        stats.height_before += height;
+        stats.height_after += zero || count == 0 ? 0 : newHeight;
+    }
+};
+
+}
+
+// 重结合与树高降低
+// 16位回绕运算下 + 与 * 满足结合律与交换律，同一基本块内经只用一次的临时变量连成的同族运算树
+// 可以任意重排：常数合并成一个放在最后；循环内的树把循环不变的运算对象先组合，
+// 供循环不变量外提；其余运算对象两两配对，n 个运算对象的依赖链从 n-1 层降到 log2 n 层
+ReassocStats reassociate_expressions(std::vector<Quadruple>& quads) {
+    ReassocStats stats;
+    if (quads.empty()) return stats;
+    Reassociator reassociator(quads, stats);
+    reassociator.run();
+    return stats;
+}
@@ -0,0 +1,281 @@
+#include "register_allocator.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+// 分配时依次尝试的寄存器：AX、DX 留到最后，乘除与临时取用时多半空闲
+const int ALLOCATION_ORDER[] = { REG_BX, REG_CX, REG_SI, REG_DI, REG_DX, REG_AX };
+const unsigned MULDIV_REGISTERS = (1u << REG_AX) | (1u << REG_DX);
+
+class Allocator {
+public:
+    Allocator(const std::vector<Quadruple>& quads, RegisterAllocation& result)
+        : quads(quads), result(result), n(static_cast<int>(quads.size())), cfg(build_cfg(quads)) {
+        compute_dominators(cfg);
+        result.operand_interval.assign(3 * n, -1);
+        result.busy.assign(n, 0);
+    }
+
+    void run() {
+        buildTempIntervals();
+        buildVariableIntervals();
+        markClobbered();
+        linearScan();
+        assignSlots();
+    }
+
+private:
+    const std::vector<Quadruple>& quads;
+    RegisterAllocation& result;
+    int n;
+    CFG cfg;
+
+    // 临时变量的一段活跃范围：块内从定值（或块首）到最后一次引用（或块尾）
+    struct Run {
+        std::string name;
+        int start, end;
+    };
+    std::vector<Run> runs;
+    std::vector<int> runOf;  // 运算对象（3i+k）-> 活跃范围
+
+    int newRun(const std::string& name, int start, int end) {
+        runs.push_back(Run{ name, start, end });
+        return static_cast<int>(runs.size()) - 1;
+    }
+
+    // 逐块逆序扫描得到活跃范围；活跃离开前驱与活跃进入后继的范围是同一个值，用并查集连起来
+    void buildTempIntervals() {
+        Liveness live = compute_liveness(quads, cfg);
+        int blocks = cfg.num_blocks();
+        std::vector<std::unordered_map<std::string, int>> liveInRun(blocks), liveOutRun(blocks);
+        runOf.assign(3 * n, -1);
+        for (int b = 0; b < blocks; b++) {
+            int first = cfg.first_quad(b), last = cfg.last_quad(b);
+            std::unordered_map<std::string, int> open;
+            live.live_out[b].for_each([&](size_t bit) {
+                const std::string& name = live.names[bit];
+                if (!is_temp(name)) return;
+                int run = newRun(name, 2 * last + 1, 2 * last + 1);
+                open[name] = run;
+                liveOutRun[b][name] = run;
+            });
+            for (int i = last; i >= first; i--) {
+                const Quadruple& quad = quads[i];
+                if (!is_jump(quad.op) && is_temp(quad.result)) {
+                    auto it = open.find(quad.result);
+                    if (it != open.end()) {
+                        runs[it->second].start = 2 * i + 1;
+                        runOf[3 * i + 2] = it->second;
+                        open.erase(it);
+                    }
+                    else {
+                        runOf[3 * i + 2] = newRun(quad.result, 2 * i + 1, 2 * i + 1);  // 结果不再被引用
+                    }
+                }
+                const std::string* args[] = { &quad.arg1, &quad.arg2 };
+                for (int k = 0; k < 2; k++) {
+                    if (!is_temp(*args[k])) continue;
+                    auto it = open.find(*args[k]);
+                    if (it == open.end()) it = open.emplace(*args[k], newRun(*args[k], 2 * i, 2 * i)).first;
+                    runOf[3 * i + k] = it->second;
+                }
+            }
+            for (const auto& entry : open) {
+                runs[entry.second].start = 2 * first;
+                liveInRun[b][entry.first] = entry.second;
+            }
+        }
+
+        std::vector<int> parent(runs.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](int r) {
+            while (parent[r] != r) r = parent[r] = parent[parent[r]];
+            return r;
+        };
+        for (int b = 0; b < blocks; b++) {
+            for (int e = cfg.succ_begin(b); e < cfg.succ_end(b); e++) {
+                const auto& in = liveInRun[cfg.succ[e]];
+                for (const auto& entry : liveOutRun[b]) {
+                    auto it = in.find(entry.first);
+                    if (it != in.end()) parent[find(entry.second)] = find(it->second);
+                }
+            }
+        }
+
+        // 每个连通的整体是一个区间，按首次出现的顺序编号，使结果与散列表的遍历顺序无关
+        std::vector<int> intervalOf(runs.size(), -1);
+        for (int k = 0; k < 3 * n; k++) {
+            if (runOf[k] < 0) continue;
+            int root = find(runOf[k]);
+            if (intervalOf[root] < 0) {
+                intervalOf[root] = static_cast<int>(result.intervals.size());
+                LiveInterval interval;
+                interval.name = runs[root].name;
+                interval.start = runs[root].start;
+                interval.end = runs[root].end;
+                result.intervals.push_back(interval);
+            }
+            result.operand_interval[k] = intervalOf[root];
+            result.intervals[intervalOf[root]].occurrences++;
+        }
+        for (size_t r = 0; r < runs.size(); r++) {
+            int root = find(static_cast<int>(r));
+            if (intervalOf[root] < 0) continue;  // 只穿过块而块内没有出现
+            LiveInterval& interval = result.intervals[intervalOf[root]];
+            interval.start = std::min(interval.start, runs[r].start);
+            interval.end = std::max(interval.end, runs[r].end);
+        }
+    }
+
+    // 变量放进寄存器后的访存次数为装入与写回各至多一次，少于块内出现次数时才值得
+    void buildVariableIntervals() {
+        for (int b = 0; b < cfg.num_blocks(); b++) {
+            std::unordered_map<std::string, LiveInterval> inBlock;
+            std::vector<std::string> order;
+            for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+                const Quadruple& quad = quads[i];
+                auto touch = [&](const std::string& name, int position, bool def) {
+                    if (name.empty() || is_temp(name) || is_number(name)) return;
+                    auto it = inBlock.find(name);
+                    if (it == inBlock.end()) {
+                        LiveInterval interval;
+                        interval.name = name;
+                        interval.variable = true;
+                        interval.start = position;
+                        interval.load = !def;
+                        it = inBlock.emplace(name, interval).first;
+                        order.push_back(name);
+                    }
+                    it->second.end = position;
+                    it->second.occurrences++;
+                    if (def) it->second.last_def = i;
+                };
+                touch(quad.arg1, 2 * i, false);
+                touch(quad.arg2, 2 * i, false);
+                if (!is_jump(quad.op)) touch(quad.result, 2 * i + 1, true);
+            }
+            for (const auto& name : order) {
+                const LiveInterval& interval = inBlock[name];
+                int accesses = (interval.load ? 1 : 0) + (interval.last_def >= 0 ? 1 : 0);
+                if (interval.occurrences <= accesses) continue;
+                int index = static_cast<int>(result.intervals.size());
+                result.intervals.push_back(interval);
+                for (int i = interval.start / 2; i <= interval.end / 2; i++) {
+                    const Quadruple& quad = quads[i];
+                    if (quad.arg1 == name) result.operand_interval[3 * i] = index;
+                    if (quad.arg2 == name) result.operand_interval[3 * i + 1] = index;
+                    if (!is_jump(quad.op) && quad.result == name) result.operand_interval[3 * i + 2] = index;
+                }
+            }
+        }
+    }
+
+    // 乘除指令改写 AX、DX：在乘除之前已有值、之后仍要使用的区间不能放在这两个寄存器中
+    void markClobbered() {
+        std::vector<int> positions;
+        for (int i = 0; i < n; i++) {
+            if (quads[i].op == "*" || quads[i].op == "/") positions.push_back(2 * i + 1);
+        }
+        for (auto& interval : result.intervals) {
+            auto it = std::upper_bound(positions.begin(), positions.end(), interval.start);
+            if (it != positions.end() && *it < interval.end) interval.forbidden |= MULDIV_REGISTERS;
+        }
+    }
+
+    void linearScan() {
+        std::vector<int> order(result.intervals.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::vector<LiveInterval>& intervals = result.intervals;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return intervals[a].start < intervals[b].start; });
+        std::vector<int> active;  // 占用寄存器的区间
+        int holder[NUM_REGISTERS];
+        std::fill(holder, holder + NUM_REGISTERS, -1);
+        for (int current : order) {
+            LiveInterval& interval = intervals[current];
+            // 终点在当前起点之前的区间让出寄存器
+            for (size_t k = 0; k < active.size();) {
+                if (intervals[active[k]].end < interval.start) {
+                    holder[intervals[active[k]].reg] = -1;
+                    active[k] = active.back();
+                    active.pop_back();
+                }
+                else {
+                    k++;
+                }
+            }
+            for (int reg : ALLOCATION_ORDER) {
+                if (holder[reg] < 0 && !(interval.forbidden & (1u << reg))) {
+                    interval.reg = reg;
+                    break;
+                }
+            }
+            if (interval.reg < 0) {
+                // 溢出终点最远的区间；能让出寄存器的活跃区间终点都不比当前远时溢出当前区间
+                int victim = -1;
+                for (size_t k = 0; k < active.size(); k++) {
+                    const LiveInterval& other = intervals[active[k]];
+                    if (interval.forbidden & (1u << other.reg)) continue;
+                    if (victim < 0 || other.end > intervals[active[victim]].end) victim = static_cast<int>(k);
+                }
+                if (victim < 0 || intervals[active[victim]].end <= interval.end) {
+                    result.spilled++;
+                    continue;
+                }
+                LiveInterval& spilled = intervals[active[victim]];
+                interval.reg = spilled.reg;
+                spilled.reg = -1;
+                result.spilled++;
+                active.erase(active.begin() + victim);
+            }
+            holder[interval.reg] = current;
+            active.push_back(current);
+        }
+        for (const auto& interval : intervals) {
+            if (interval.reg < 0) continue;
+            for (int i = interval.start / 2; i <= interval.end / 2; i++) result.busy[i] |= 1u << interval.reg;
+        }
+    }
+
+    // 溢出的临时变量按起点依次取用编号最小的空闲槽位
+    void assignSlots() {
+        std::vector<int> order;
+        for (size_t k = 0; k < result.intervals.size(); k++) {
+            if (result.intervals[k].reg < 0 && !result.intervals[k].variable) order.push_back(static_cast<int>(k));
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return result.intervals[a].start < result.intervals[b].start;
+        });
+        std::vector<int> slotEnd;  // 槽位 -> 占用它的区间的终点
+        for (int k : order) {
+            LiveInterval& interval = result.intervals[k];
+            for (size_t s = 0; s < slotEnd.size() && interval.slot < 0; s++) {
+                if (slotEnd[s] < interval.start) interval.slot = static_cast<int>(s);
+            }
+            if (interval.slot < 0) {
+                interval.slot = static_cast<int>(slotEnd.size());
+                slotEnd.push_back(0);
+            }
+            slotEnd[interval.slot] = interval.end;
+        }
+        result.slots = static_cast<int>(slotEnd.size());
+    }
+};
+
+}
+
+const char* register_name(int reg) {
+    static const char* names[NUM_REGISTERS] = { "AX", "BX", "CX", "DX", "SI", "DI" };
+    return names[reg];
+}
+
+RegisterAllocation allocate_registers(const std::vector<Quadruple>& quads) {
+    RegisterAllocation result;
+    if (quads.empty()) return result;
+    Allocator allocator(quads, result);
+    allocator.run();
+    return result;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#ifndef REGISTER_ALLOCATOR_H
+#define REGISTER_ALLOCATOR_H
+
+#include "assembler.h"
+#include <string>
+#include <vector>
+
+// 8086 的通用寄存器。乘除指令隐含使用 AX、DX，分配时排在最后
+enum Register { REG_AX, REG_BX, REG_CX, REG_DX, REG_SI, REG_DI, NUM_REGISTERS };
+const char* register_name(int reg);
+
+// 生存区间：位置 2i 表示第i条四元式读运算对象，2i+1 表示写结果（与临时变量重用相同）。
+// 临时变量的活跃范围沿控制流边连成一个整体，区间取其首尾，可以跨块；
+// 普通变量在块边界上总在内存中，区间只在一个基本块内，从块内第一次出现到最后一次出现，
+// 放在寄存器中能减少访存时才建立：第一次出现是引用时在区间开始处装入，块内最后一次定值后写回
+struct LiveInterval {
+    std::string name;
+    bool variable = false;
+    int start = 0, end = 0;
+    int occurrences = 0;     // 区间内的引用与定值次数
+    bool load = false;       // 变量：区间开始处须从内存装入
+    int last_def = -1;       // 变量：区间内最后一次定值的四元式下标，其后写回内存
+    unsigned forbidden = 0;  // 不能使用的寄存器位集：区间跨过乘除四元式时不能用 AX、DX
+    int reg = -1;            // 分配的寄存器，-1 表示溢出（变量留在内存，临时变量放在槽位中）
+    int slot = -1;           // 溢出的临时变量占用的数据段槽位
+};
+
+struct RegisterAllocation {
+    std::vector<LiveInterval> intervals;
+    // 第i条四元式的 arg1、arg2、result 所属的区间为 operand_interval[3i..3i+2]，
+    // 常数、空项、跳转目标与不分配寄存器的变量为 -1
+    std::vector<int> operand_interval;
+    std::vector<unsigned> busy;  // 第i条四元式执行期间被区间占用的寄存器位集
+    int slots = 0;               // 溢出槽位数
+    int spilled = 0;             // 溢出的区间数
+};
+
+// 线性扫描寄存器分配（Poletto-Sarkar）：区间按起点排序依次分配空闲寄存器，
+// 没有空闲寄存器时溢出活跃区间中终点最远的一个；溢出的临时变量按区间不重叠共用槽位
+RegisterAllocation allocate_registers(const std::vector<Quadruple>& quads);
+
+#endif // REGISTER_ALLOCATOR_H
@@ -0,0 +1,249 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include "ssa.h"
+#include <unordered_map>
+
+namespace {
+
+// 格值：TOP（尚未确定）> 常数 > BOTTOM（不是常数）
+enum Level : char { TOP, CONSTANT, BOTTOM };
+
+struct Lattice {
+    Level level = TOP;
+    int16_t value = 0;
+};
+
+class Propagator {
+public:
+    Propagator(const std::vector<Quadruple>& quads, const CFG& cfg, const SSAForm& ssa)
+        : quads(quads), cfg(cfg), ssa(ssa), cells(ssa.num_values()),
+          executable(cfg.num_blocks(), 0), edgeExecutable(cfg.pred.size(), 0) {
+        // 程序入口处的变量初值是输入，不是常数
+        for (int v = 0; v < ssa.num_values(); v++) {
+            if (ssa.values[v].kind == SSAForm::ENTRY) cells[v].level = BOTTOM;
+        }
+    }
+
+    void run() {
+        if (cfg.num_blocks() == 0) return;
+        markBlock(cfg.rpo[0]);
+        while (!flowWork.empty() || !valueWork.empty()) {
+            while (!flowWork.empty()) {
+                auto edge = flowWork.back();
+                flowWork.pop_back();
+                followEdge(edge.first, edge.second);
+            }
+            while (!valueWork.empty()) {
+                int v = valueWork.back();
+                valueWork.pop_back();
+                for (int u = ssa.use_offset[v]; u < ssa.use_offset[v + 1]; u++) {
+                    int user = ssa.users[u];
+                    if (user & 1) {
+                        const auto& phi = ssa.phis[user >> 1];
+                        if (executable[phi.block]) evaluatePhi(user >> 1);
+                    }
+                    else if (executable[cfg.block_of_quad[user >> 1]]) {
+                        evaluateQuad(user >> 1);
+                    }
+                }
+            }
+        }
+    }
+
+    bool isExecutable(int block) const { return executable[block] != 0; }
+
+    // 四元式第k个运算对象的格值
+    Lattice operand(int quad, int k) const {
+        const std::string& arg = k == 0 ? quads[quad].arg1 : quads[quad].arg2;
+        Lattice cell;
+        if (is_number(arg)) {
+            cell.level = CONSTANT;
+            cell.value = constant_value(arg);
+        }
+        else if (ssa.use_value[2 * quad + k] >= 0) {
+            cell = cells[ssa.use_value[2 * quad + k]];
+        }
+        else {
+            cell.level = BOTTOM;
+        }
+        return cell;
+    }
+
+    const Lattice& cell(int value) const { return cells[value]; }
+
+private:
+    const std::vector<Quadruple>& quads;
+    const CFG& cfg;
+    const SSAForm& ssa;
+    std::vector<Lattice> cells;
+    std::vector<char> executable;
+    std::vector<char> edgeExecutable;  // 按前驱数组位置记录边是否可执行
+    std::vector<std::pair<int, int>> flowWork;
+    std::vector<int> valueWork;
+
+    void lower(int value, Lattice next) {
+        Lattice& cell = cells[value];
+        if (next.level < cell.level) return;  // 格值只下降
+        if (next.level == cell.level && (next.level != CONSTANT || next.value == cell.value)) return;
+        if (next.level == CONSTANT && cell.level == CONSTANT) next.level = BOTTOM;
+        cell = next;
+        valueWork.push_back(value);
+    }
+
+    void markBlock(int block) {
+        executable[block] = 1;
+        for (int p = ssa.phi_offset[block]; p < ssa.phi_offset[block + 1]; p++) evaluatePhi(p);
+        for (int i = cfg.first_quad(block); i <= cfg.last_quad(block); i++) evaluateQuad(i);
+    }
+
+    void followEdge(int from, int to) {
+        int slot = cfg.pred_begin(to);
+        while (cfg.pred[slot] != from) slot++;
+        if (edgeExecutable[slot]) return;
+        edgeExecutable[slot] = 1;
+        if (!executable[to]) {
+            markBlock(to);
+            return;
+        }
+        for (int p = ssa.phi_offset[to]; p < ssa.phi_offset[to + 1]; p++) evaluatePhi(p);
+    }
+
+    void addEdge(int from, int quadIndex) {
+        if (quadIndex < 0 || quadIndex >= static_cast<int>(quads.size())) return;  // 跳出程序
+        flowWork.push_back({ from, cfg.block_of_quad[quadIndex] });
+    }
+
+    void evaluatePhi(int p) {
+        const auto& phi = ssa.phis[p];
+        int preds = cfg.pred_end(phi.block) - cfg.pred_begin(phi.block);
+        Lattice result;
+        for (size_t k = 0; k < phi.args.size(); k++) {
+            // 入口块的最后一个参数来自程序开始，总是可执行
+            bool live = static_cast<int>(k) >= preds || edgeExecutable[cfg.pred_begin(phi.block) + k];
+            if (!live || phi.args[k] < 0) continue;
+            const Lattice& arg = cells[phi.args[k]];
+            if (arg.level == TOP) continue;
+            if (arg.level == BOTTOM || (result.level == CONSTANT && result.value != arg.value)) {
+                result.level = BOTTOM;
+                break;
+            }
+            result = arg;
+        }
+        lower(phi.value, result);
+    }
+
+    void evaluateQuad(int i) {
+        const Quadruple& quad = quads[i];
+        int block = cfg.block_of_quad[i];
+        bool last = i == cfg.last_quad(block);
+        int base = cfg.base_label;
+
+        if (quad.op == "j") {
+            addEdge(block, jump_target(quad) - base);
+            return;
+        }
+        if (is_cond_jump(quad.op)) {
+            Lattice a = operand(i, 0), b = operand(i, 1);
+            if (a.level == TOP || b.level == TOP) return;
+            if (a.level == CONSTANT && b.level == CONSTANT) {
+                if (evaluate_relop(quad.op, a.value, b.value)) addEdge(block, jump_target(quad) - base);
+                else addEdge(block, i + 1);
+                return;
+            }
+            addEdge(block, jump_target(quad) - base);
+            addEdge(block, i + 1);
+            return;
+        }
+        if (last) addEdge(block, i + 1);
+        if (ssa.def_value[i] < 0) return;
+
+        Lattice result;
+        if (quad.op == ":=") {
+            result = operand(i, 0);
+        }
+        else if (is_arith(quad.op)) {
+            Lattice a = operand(i, 0), b = operand(i, 1);
+            bool zero = quad.op == "*" && ((a.level == CONSTANT && a.value == 0) ||
+                (b.level == CONSTANT && b.value == 0));
+            if (zero) {
+                result.level = CONSTANT;
+                result.value = 0;
+            }
+            else if (a.level == BOTTOM || b.level == BOTTOM) {
+                result.level = BOTTOM;
+            }
+            else if (a.level == CONSTANT && b.level == CONSTANT) {
+                result.level = evaluate_arith(quad.op, a.value, b.value, result.value) ? CONSTANT : BOTTOM;
+            }
+        }
+        else {
+            result.level = BOTTOM;
+        }
+        lower(ssa.def_value[i], result);
+    }
+};
+
+}
+
+// 稀疏条件常量传播（Wegman-Zadeck）
+// 传播在SSA视图上进行，改写时回到原四元式：可执行块中值为常数的引用换成常数，
+// 值为常数的定值改为常数赋值，临时变量的引用全部被替换后删除其定值
+SCCPStats sparse_constant_propagation(std::vector<Quadruple>& quads) {
+    SCCPStats stats;
+    if (quads.empty()) return stats;
+
+    CFG cfg = build_cfg(quads);
+    compute_dominators(cfg);
+    SSAForm ssa = build_ssa(quads, cfg);
+    Propagator propagator(quads, cfg, ssa);
+    propagator.run();
+
+    int n = static_cast<int>(quads.size());
+    std::vector<char> removed(n, 0);
+    for (int b = 0; b < cfg.num_blocks(); b++) {
+        if (propagator.isExecutable(b)) continue;
+        stats.dead_blocks++;
+        for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) removed[i] = 1;
+    }
+
+    // 改写引用与条件跳转，同时统计临时变量剩余的引用
+    std::unordered_map<std::string, int> remainingUses;
+    for (int i = 0; i < n; i++) {
+        if (removed[i]) continue;
+        Quadruple& quad = quads[i];
+        Lattice a = propagator.operand(i, 0), b = propagator.operand(i, 1);
+        if (is_cond_jump(quad.op) && a.level == CONSTANT && b.level == CONSTANT) {
+            if (evaluate_relop(quad.op, a.value, b.value)) quad = Quadruple{ quad.label, "j", "", "", quad.result };
+            else removed[i] = 1;
+            stats.jumps++;
+            continue;
+        }
+        std::string* args[] = { &quad.arg1, &quad.arg2 };
+        Lattice cells[] = { a, b };
+        for (int k = 0; k < 2; k++) {
+            if (ssa.use_value[2 * i + k] < 0) continue;
+            if (cells[k].level == CONSTANT) {
+                *args[k] = constant_string(cells[k].value);
+                stats.constants++;
+            }
+            else if (is_temp(*args[k])) {
+                remainingUses[*args[k]]++;
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (removed[i] || ssa.def_value[i] < 0) continue;
+        const Lattice& cell = propagator.cell(ssa.def_value[i]);
+        if (cell.level != CONSTANT) continue;
+        Quadruple& quad = quads[i];
+        if (is_temp(quad.result) && remainingUses[quad.result] == 0) {
+            removed[i] = 1;
+        }
+        else if (quad.op != ":=" || quad.arg1 != constant_string(cell.value)) {
+            quad = Quadruple{ quad.label, ":=", constant_string(cell.value), "", quad.result };
+        }
+    }
+    for (char r : removed) stats.removed += r;
+    if (stats.removed > 0) remove_quads(quads, removed);
+    return stats;
+}
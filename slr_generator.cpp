@@ -1,299 +1,847 @@
 #include "slr_generator.h"
+#include "parallel.h"
 #include <iostream>
-#include <queue>
+#include <functional>
+#include <mutex>
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
 
-SLRGenerator::SLRGenerator() {
-    initArithmeticGrammar();
-    initBooleanGrammar();
-    initStatementGrammar();
+SLRGenerator::SLRGenerator(const Grammar& g, unsigned threads)
+    : grammar(g), threadCount(threads) {
+    for (size_t i = 0; i < grammar.productions.size(); i++) {
+        productionsByLeft[grammar.productions[i].left].push_back(i);
+    }
 }
 
-void SLRGenerator::initArithmeticGrammar() {
-    // ʽķ
-    // E  E+E | E*E | (E) | i
-    productions.clear();
-    productions.push_back(Production("S'", { "E" }));
-    productions.push_back(Production("E", { "E", "+", "E" }));
-    productions.push_back(Production("E", { "E", "*", "E" }));
-    productions.push_back(Production("E", { "(", "E", ")" }));
-    productions.push_back(Production("E", { "i" }));
+Grammar SLRGenerator::arithmeticGrammar() {
+    // 算术表达式文法
+    // E → E+E | E*E | (E) | i
+    return Grammar("算术表达式", {
+        Production("S'", { "E" }),
+        Production("E", { "E", "+", "E" }),
+        Production("E", { "E", "*", "E" }),
+        Production("E", { "(", "E", ")" }),
+        Production("E", { "i" }),
+    });
 }
 
-void SLRGenerator::initBooleanGrammar() {
-    // ʽķ
-    productions.clear();
-    productions.push_back(Production("S'", { "B" }));
-    productions.push_back(Production("B", { "i" }));
-    productions.push_back(Production("B", { "i", "rop", "i" }));
-    productions.push_back(Production("B", { "(", "B", ")" }));
-    productions.push_back(Production("B", { "not", "B" }));
-    productions.push_back(Production("A", { "B", "and" }));
-    productions.push_back(Production("B", { "A", "B" }));
-    productions.push_back(Production("O", { "B", "or" }));
-    productions.push_back(Production("B", { "O", "B" }));
+Grammar SLRGenerator::booleanGrammar() {
+    // 布尔表达式文法
+    return Grammar("布尔表达式", {
+        Production("S'", { "B" }),
+        Production("B", { "i" }),
+        Production("B", { "i", "rop", "i" }),
+        Production("B", { "(", "B", ")" }),
+        Production("B", { "not", "B" }),
+        Production("A", { "B", "and" }),
+        Production("B", { "A", "B" }),
+        Production("O", { "B", "or" }),
+        Production("B", { "O", "B" }),
+    });
 }
 
-void SLRGenerator::initStatementGrammar() {
-    // ķ
-    productions.clear();
-    productions.push_back(Production("S'", { "S" }));
-    productions.push_back(Production("S", { "if", "e", "then", "S", "else", "S" }));
-    productions.push_back(Production("S", { "while", "e", "do", "S" }));
-    productions.push_back(Production("S", { "begin", "L", "end" }));
-    productions.push_back(Production("S", { "a" }));
-    productions.push_back(Production("L", { "S" }));
-    productions.push_back(Production("L", { "S", ";", "L" }));
+Grammar SLRGenerator::statementGrammar() {
+    // 程序语句文法
+    return Grammar("程序语句", {
+        Production("S'", { "S" }),
+        Production("S", { "if", "e", "then", "S", "else", "S" }),
+        Production("S", { "while", "e", "do", "S" }),
+        Production("S", { "begin", "L", "end" }),
+        Production("S", { "a" }),
+        Production("L", { "S" }),
+        Production("L", { "S", ";", "L" }),
+    });
 }
 
-bool SLRGenerator::isTerminal(const std::string& symbol) {
-    static std::set<std::string> nonTerminals = {
-        "S'", "S", "E", "B", "A", "O", "L"
-    };
-    return nonTerminals.find(symbol) == nonTerminals.end();
+bool SLRGenerator::isTerminal(const std::string& symbol) const {
+    return grammar.isTerminal(symbol);
 }
 
-// зսFIRST
+// 计算符号串 symbols[from..] 的FIRST集（不含ε）并加入result，
+// 返回该符号串能否推出空串ε
+bool SLRGenerator::firstOfSequence(const std::vector<std::string>& symbols, size_t from,
+    std::set<std::string>& result) {
+    for (size_t i = from; i < symbols.size(); i++) {
+        if (isTerminal(symbols[i])) {
+            result.insert(symbols[i]);  // 终结符直接加入，之后的符号不再影响
+            return false;
+        }
+        const auto& symbolFirst = first[symbols[i]];
+        for (const auto& symbol : symbolFirst) {
+            if (symbol != "ε") {
+                result.insert(symbol);
+            }
+        }
+        if (!symbolFirst.count("ε")) {
+            return false;  // 该非终结符不能推出ε，后续符号不参与
+        }
+    }
+    return true;
+}
+
+// 计算所有非终结符的FIRST集合
 void SLRGenerator::computeFirstSets() {
-    bool changed;  // ǷFIRSTϱ
+    first.clear();
+    bool changed;  // 标记是否有FIRST集合被更新
     do {
-        changed = false;  // ÿֿʼǰñ
-        // ķевʽ
-        for (const auto& prod : productions) {
-            // ȡǰʽ󲿷սFIRST
+        changed = false;  // 每轮开始前重置标记
+        // 遍历文法中的所有产生式
+        for (const auto& prod : grammar.productions) {
+            // 获取当前产生式左部非终结符的FIRST集合引用
             std::set<std::string>& firstSet = first[prod.left];
-            size_t oldSize = firstSet.size();  // ¼ǰFIRSTϴС
-            // ղʽҲΪգ
-            if (prod.right.empty()) {
-                firstSet.insert("");  // մ
-                continue;  // 
-            }
-            // ʽҲĵһ
-            if (isTerminal(prod.right[0])) {
-                // սֱӼFIRST
-                firstSet.insert(prod.right[0]);
+            size_t oldSize = firstSet.size();  // 记录当前FIRST集合大小
+            // 右部依次加入各符号的FIRST集，直到遇到不能推出ε的符号；
+            // 右部为空或整个右部都能推出ε时加入空串ε
+            if (firstOfSequence(prod.right, 0, firstSet)) {
+                firstSet.insert("ε");
             }
-            else {
-                // ǷսFIRSTݼ뵱ǰFIRST
-                const auto& rightFirst = first[prod.right[0]];
-                firstSet.insert(rightFirst.begin(), rightFirst.end());
-            }
-            // FIRSTǷ仯
+            // 检查FIRST集合是否发生变化
             if (firstSet.size() > oldSize) {
-                changed = true;  // С仯Ҫ
+                changed = true;  // 如果大小变化，标记需要继续迭代
             }
         }
-    } while (changed);  // ûFIRSTϸʱֹͣѭ
+    } while (changed);  // 当没有FIRST集合更新时停止循环
 }
 
-// зսFOLLOW
+// 计算所有非终结符的FOLLOW集合
 void SLRGenerator::computeFollowSets() {
-    // ʼ#뵽ķʼŵFOLLOW
-    follow[productions[0].left].insert("#");
-    bool changed;  // ǷFOLLOWϱ
+    follow.clear();
+    // 初始化，将结束符#加入到文法开始符号的FOLLOW集中
+    follow[grammar.productions[0].left].insert("#");
+    bool changed;  // 标记是否有FOLLOW集合被更新
     do {
-        changed = false;  // ÿֿʼǰñ
-        // ķевʽ
-        for (const auto& prod : productions) {
-            // ʽҲÿ
+        changed = false;  // 每轮开始前重置标记
+        // 遍历文法中的所有产生式
+        for (const auto& prod : grammar.productions) {
+            // 遍历产生式右部的每个符号
             for (size_t i = 0; i < prod.right.size(); i++) {
-                // սֻս
+                // 跳过终结符，只处理非终结符
                 if (isTerminal(prod.right[i])) continue;
-                // ȡǰսFOLLOW
+                // 获取当前非终结符的FOLLOW集合引用
                 std::set<std::string>& followSet = follow[prod.right[i]];
-                size_t oldSize = followSet.size();  // ¼ǰFOLLOWϴС
-                // 1ǰŲǲʽһ
-                if (i < prod.right.size() - 1) {
-                    // 1.1һս
-                    if (isTerminal(prod.right[i + 1])) {
-                        followSet.insert(prod.right[i + 1]);  // ֱӼFOLLOW
-                    }
-                    // 1.2һǷս
-                    else {
-                        // һսFIRST뵱ǰFOLLOW
-                        const auto& nextFirst = first[prod.right[i + 1]];
-                        followSet.insert(nextFirst.begin(), nextFirst.end());
-                    }
-                }
-                // 2ǰǲʽһ
-                // һŵFIRST
-                else {
-                    // ʽ󲿷սFOLLOW뵱ǰFOLLOW
+                size_t oldSize = followSet.size();  // 记录当前FOLLOW集合大小
+                // 情况1：将其后符号串的FIRST集（除ε外）加入当前FOLLOW集
+                // 情况2：当前符号是产生式最后一个符号，
+                // 或者其后的符号串能推出ε，再加入左部的FOLLOW集
+                if (firstOfSequence(prod.right, i + 1, followSet)) {
                     const auto& leftFollow = follow[prod.left];
                     followSet.insert(leftFollow.begin(), leftFollow.end());
                 }
-                // FOLLOWǷ仯
+                // 检查FOLLOW集合是否发生变化
                 if (followSet.size() > oldSize) {
-                    changed = true;  // С仯Ҫ
+                    changed = true;  // 如果大小变化，标记需要继续迭代
                 }
             }
         }
-    } while (changed);  // ûFOLLOWϸʱֹͣѭ
+    } while (changed);  // 当没有FOLLOW集合更新时停止循环
 }
 
-void SLRGenerator::closure(std::set<LR0Item>& items) {
-    bool changed;
-    do {
-        changed = false;
-        std::set<LR0Item> newItems = items;
-
-        for (const auto& item : items) {
-            // źǷս
-            if (item.dotPos < item.prod.right.size() &&
-                !isTerminal(item.prod.right[item.dotPos])) {
-
-                std::string nextSymbol = item.prod.right[item.dotPos];
-
-                // Ը÷սΪ󲿵Ĳʽ
-                for (const auto& prod : productions) {
-                    if (prod.left == nextSymbol) {
-                        LR0Item newItem(prod, 0);
-                        if (newItems.insert(newItem).second) {//newItem
-                            changed = true;
-                        }
-                    }
-                }
+// 核心项目集 -> 状态编号 的并发映射
+// 按哈希分片加锁；同一层内多个线程发现同一核心时只保留最小的发现序号，
+// 该层结束后再按发现序号统一编号，因此状态编号与串行BFS完全一致。
+// 映射在两次构造之间保留，增量更新时旧表项记下上一轮的状态号以便复用
+class SLRGenerator::KernelMap {
+public:
+    // 查找或插入核心，isNew表示该核心是否在本轮构造中首次被到达
+    KernelEntry* findOrInsert(const std::set<LR0Item>& kernel, unsigned long long seen,
+        unsigned generation, bool& isNew) {
+        Shard& shard = shards[hashKernel(kernel) % kShardCount];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto result = shard.entries.emplace(kernel, KernelEntry());
+        KernelEntry& entry = result.first->second;
+        if (result.second) {
+            entry.kernel = &result.first->first;
+            entry.shard = &shard - shards;
+        }
+        claimLocked(entry, seen, generation, isNew);
+        return &entry;
+    }
+
+    // 已知表项（来自旧自动机的转移）在本轮构造中被再次到达
+    void claim(KernelEntry* entry, unsigned long long seen, unsigned generation, bool& isNew) {
+        std::lock_guard<std::mutex> lock(shards[entry->shard].mutex);
+        claimLocked(*entry, seen, generation, isNew);
+    }
+
+    // 删除本轮构造中没有到达的表项
+    void removeStale(unsigned generation) {
+        for (auto& shard : shards) {
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                if (it->second.generation != generation) it = shard.entries.erase(it);
+                else ++it;
+            }
+        }
+    }
+
+private:
+    static const size_t kShardCount = 64;
+    struct Shard {
+        std::mutex mutex;
+        std::map<std::set<LR0Item>, KernelEntry> entries;
+    };
+    Shard shards[kShardCount];
+
+    static void claimLocked(KernelEntry& entry, unsigned long long seen, unsigned generation,
+        bool& isNew) {
+        isNew = entry.generation != generation;
+        if (isNew) {
+            entry.previousNum = entry.generation == 0 ? -1 : entry.stateNum;
+            entry.stateNum = -1;
+            entry.generation = generation;
+            entry.firstSeen = seen;
+        }
+        else if (entry.stateNum < 0 && seen < entry.firstSeen) {
+            entry.firstSeen = seen;
+        }
+    }
+
+    static size_t hashKernel(const std::set<LR0Item>& kernel) {
+        std::hash<std::string> hashString;
+        size_t h = 0;
+        for (const auto& item : kernel) {
+            h = h * 31 + hashString(item.prod.left);
+            for (const auto& symbol : item.prod.right) {
+                h = h * 31 + hashString(symbol);
             }
+            h = h * 31 + item.dotPos;
         }
+        return h;
+    }
+};
 
-        items = std::move(newItems);
-    } while (changed);
+SLRGenerator::SLRGenerator(SLRGenerator&&) noexcept = default;
+SLRGenerator& SLRGenerator::operator=(SLRGenerator&&) noexcept = default;
+SLRGenerator::~SLRGenerator() = default;
+
+void SLRGenerator::closure(std::set<LR0Item>& items) const {
+    std::set<std::string> expanded;     // 已展开过的非终结符
+    std::vector<std::string> pending;   // 待展开的非终结符
+    for (const auto& item : items) {
+        // 如果点号后面是非终结符
+        if (item.dotPos < static_cast<int>(item.prod.right.size()) &&
+            !isTerminal(item.prod.right[item.dotPos]) &&
+            expanded.insert(item.prod.right[item.dotPos]).second) {
+            pending.push_back(item.prod.right[item.dotPos]);
+        }
+    }
+
+    while (!pending.empty()) {
+        std::string nextSymbol = pending.back();
+        pending.pop_back();
+
+        // 添加所有以该非终结符为左部的产生式
+        auto it = productionsByLeft.find(nextSymbol);
+        if (it == productionsByLeft.end()) continue;
+        for (size_t index : it->second) {
+            const Production& prod = grammar.productions[index];
+            items.insert(LR0Item(prod, 0));
+            if (!prod.right.empty() && !isTerminal(prod.right[0]) &&
+                expanded.insert(prod.right[0]).second) {
+                pending.push_back(prod.right[0]);
+            }
+        }
+    }
 }
 
-std::set<LR0Item> SLRGenerator::computeGoto(const std::set<LR0Item>& items,
-    const std::string& symbol) {
-    std::set<LR0Item> gotoSet;
+// 计算GOTO的核心部分（未求闭包）
+std::set<LR0Item> SLRGenerator::computeKernel(const std::set<LR0Item>& items,
+    const std::string& symbol) const {
+    std::set<LR0Item> kernel;
 
-    // ԵǰĿеÿĿ
+    // 对当前项目集中的每个项目
     for (const auto& item : items) {
-        // ûеĩβҵźķŵڸ
-        if (item.dotPos < item.prod.right.size() &&
+        // 如果点号没有到达末尾且点号后的符号等于给定符号
+        if (item.dotPos < static_cast<int>(item.prod.right.size()) &&
             item.prod.right[item.dotPos] == symbol) {
 
-            // Ŀƶһλ
-            LR0Item newItem(item.prod, item.dotPos + 1);
-            gotoSet.insert(newItem);
+            // 创建新项目，将点号向后移动一位
+            kernel.insert(LR0Item(item.prod, item.dotPos + 1));
         }
     }
+    return kernel;
+}
 
-    // ԽĿհ
+std::set<LR0Item> SLRGenerator::computeGoto(const std::set<LR0Item>& items,
+    const std::string& symbol) const {
+    std::set<LR0Item> gotoSet = computeKernel(items, symbol);
+    // 对结果项目集求闭包
     closure(gotoSet);
     return gotoSet;
 }
 
-// LR(0)ԶĿ״̬
-void SLRGenerator::constructLR0Items() {
-    states.clear();  // ״̬
-    std::map<std::set<LR0Item>, int> stateMap;  // ڼ¼Ŀ״̬ŵӳ
-    // 1. ʼĿķĵһʽ
-    std::set<LR0Item> initialItems;
-    initialItems.insert(LR0Item(productions[0], 0));  // ʼĿ: S' -> .S
-    closure(initialItems);  // ʼĿıհ
-    // 2. ʼ״̬״̬0
-    states.push_back(State(initialItems, 0));  // ʼĿ״̬
-    stateMap[initialItems] = 0;  // ¼Ŀ״̬ӳ
-    // 3. ʹöнйBFS״̬
-    std::queue<int> queue;  // BFS״̬
-    queue.push(0);  // ӳʼ״̬ʼ
-    while (!queue.empty()) {
-        int currentState = queue.front();  // ȡǰ״̬
-        queue.pop();  // ӶƳ
-        // 4. ռǰ״̬пܵתƷţԲķţ
-        std::set<std::string> symbols;
-        for (const auto& item : states[currentState].items) {
-            if (item.dotPos < item.prod.right.size()) {  // ԲǷڲʽĩβ
-                symbols.insert(item.prod.right[item.dotPos]);  // Բķ
-            }
-        }
-        // 5. ÿܵתƷżGOTOϣ״̬ I ͨ X תƵĿ״̬
-        for (const auto& symbol : symbols) {
-            // GOTO(I, symbol)
-            std::set<LR0Item> gotoSet = computeGoto(states[currentState].items, symbol);
-            if (!gotoSet.empty()) {  // GOTOϲΪ
-                // 6. Ƿ״̬
-                if (stateMap.find(gotoSet) == stateMap.end()) {
-                    // ״̬
-                    int newStateNum = states.size();  // ״̬
-                    states.push_back(State(gotoSet, newStateNum));  // ӵ״̬
-                    stateMap[gotoSet] = newStateNum;  // Ŀ״̬ӳ
-                    queue.push(newStateNum);  // ״̬봦
+// 构造LR(0)自动机的所有项目集（状态）
+// 按BFS层并行扩展：同一层的各状态并行计算转移核心，
+// 新状态按发现顺序编号后再并行求闭包。
+// 增量更新时传入旧自动机：与旧状态对应且闭包未受影响的状态
+// 直接沿用旧的项目集和转移，不再计算closure和GOTO
+void SLRGenerator::constructLR0Items(PreviousAutomaton* previous) {
+    states.clear();  // 清空现有状态集合
+    previousStateOf.clear();
+    stateEntries.clear();
+    if (!previous) {
+        kernelMap.reset(new KernelMap());  // 完整构造时丢弃旧的核心映射
+        generation = 0;
+    }
+    generation++;
+    // 1. 创建初始项目集（包含增广文法的第一个产生式）
+    std::set<LR0Item> initialKernel;
+    initialKernel.insert(LR0Item(grammar.productions[0], 0));  // 加入初始项目: S' -> .S
+    bool isNew;
+    KernelEntry* initialEntry = kernelMap->findOrInsert(initialKernel, 0, generation, isNew);
+    initialEntry->stateNum = 0;
+    // 2. 创建初始状态（状态0）
+    states.push_back(State(initialKernel, 0));
+    previousStateOf.push_back(initialEntry->previousNum);
+    stateEntries.push_back(initialEntry);
+    std::vector<int> frontier(1, 0);  // 当前层待扩展的状态
+    std::vector<int> fresh(1, 0);     // 当前层新建、尚未求闭包的状态
+
+    struct Edge {
+        std::string symbol;
+        KernelEntry* target;
+    };
+    while (!frontier.empty()) {
+        // 3. 并行求新状态的闭包（可复用的旧状态直接取用旧项目集）
+        parallelFor(fresh.size(), threadCount, [&](size_t k) {
+            int old = previousStateOf[fresh[k]];
+            if (old >= 0 && previous->clean[old]) {
+                states[fresh[k]].items = std::move(previous->states[old].items);
+            }
+            else {
+                closure(states[fresh[k]].items);
+            }
+        });
+
+        // 4. 并行计算当前层每个状态在每个符号上的GOTO核心
+        std::vector<std::vector<Edge>> edges(frontier.size());
+        std::vector<std::vector<KernelEntry*>> discovered(frontier.size());
+        parallelFor(frontier.size(), threadCount, [&](size_t i) {
+            const State& state = states[frontier[i]];
+            int old = previousStateOf[frontier[i]];
+            unsigned long long j = 0;
+            bool inserted;
+            if (old >= 0 && previous->clean[old]) {
+                // 未受影响的状态：转移与旧自动机相同，直接使用旧目标状态的表项
+                for (const auto& transition : previous->states[old].transitions) {
+                    // 发现序号与串行BFS的处理顺序一致：先按状态、再按符号
+                    unsigned long long seen = (static_cast<unsigned long long>(i) << 32) | j++;
+                    KernelEntry* entry = previous->entries[transition.second];
+                    kernelMap->claim(entry, seen, generation, inserted);
+                    if (inserted) {
+                        discovered[i].push_back(entry);
+                    }
+                    edges[i].push_back({ transition.first, entry });
                 }
-                // 7. ״̬תǰ״̬ͨsymbolתƵĿ״̬
-                states[currentState].transitions[symbol] = stateMap[gotoSet];
+                return;
             }
+            // 收集当前状态所有可能的转移符号（圆点后的符号）
+            std::set<std::string> symbols;
+            for (const auto& item : state.items) {
+                if (item.dotPos < static_cast<int>(item.prod.right.size())) {
+                    symbols.insert(item.prod.right[item.dotPos]);
+                }
+            }
+            for (const auto& symbol : symbols) {
+                std::set<LR0Item> kernel = computeKernel(state.items, symbol);
+                unsigned long long seen = (static_cast<unsigned long long>(i) << 32) | j++;
+                KernelEntry* entry = kernelMap->findOrInsert(kernel, seen, generation, inserted);
+                if (inserted) {
+                    discovered[i].push_back(entry);
+                }
+                edges[i].push_back({ symbol, entry });
+            }
+        });
+
+        // 5. 按最小发现序号为新状态编号
+        std::vector<KernelEntry*> newEntries;
+        for (const auto& list : discovered) {
+            newEntries.insert(newEntries.end(), list.begin(), list.end());
         }
+        std::sort(newEntries.begin(), newEntries.end(),
+            [](const KernelEntry* a, const KernelEntry* b) {
+                return a->firstSeen < b->firstSeen;
+            });
+        fresh.clear();
+        for (auto entry : newEntries) {
+            entry->stateNum = states.size();
+            fresh.push_back(entry->stateNum);
+            int old = entry->previousNum;
+            if (old >= 0 && previous->clean[old]) {
+                states.push_back(State(std::set<LR0Item>(), entry->stateNum));
+            }
+            else {
+                states.push_back(State(*entry->kernel, entry->stateNum));
+            }
+            previousStateOf.push_back(old);
+            stateEntries.push_back(entry);
+        }
+
+        // 6. 记录当前层的状态转换
+        for (size_t i = 0; i < frontier.size(); i++) {
+            for (const auto& edge : edges[i]) {
+                states[frontier[i]].transitions[edge.symbol] = edge.target->stateNum;
+            }
+        }
+        frontier = fresh;
     }
+    kernelMap->removeStale(generation);
 }
 
 void SLRGenerator::generateParsingTable() {
-    // FIRSTFOLLOW
+    lazy = false;
+    // 计算FIRST和FOLLOW集
     computeFirstSets();
+    phaseDone("FIRST");
     computeFollowSets();
+    phaseDone("FOLLOW");
 
-    // Ŀ淶
+    // 构造项目集规范族
     constructLR0Items();
+    phaseDone("LR0");
 
-    // ɷ
-    ActionTable actionTable;
-    GotoTable gotoTable;
-
+    // 生成分析表
+    actionTable.clear();
+    gotoTable.clear();
+    std::map<Production, int> productionIndex = indexProductions();
     for (const auto& state : states) {
-        for (const auto& item : state.items) {
-            // ĩβ
-            if (item.dotPos == item.prod.right.size()) {
-                // Լ
-                if (item.prod.left == "S'") {
-                    // 
-                    actionTable[state.stateNum]["#"] = "acc";
+        generateTableRow(state, productionIndex);
+    }
+    phaseDone("TABLE");
+}
+
+// 惰性模式：只计算FIRST/FOLLOW集和初始状态，
+// 其余状态与分析表行在分析过程中第一次用到时才构造并记住
+void SLRGenerator::prepareLazyTable() {
+    computeFirstSets();
+    phaseDone("FIRST");
+    computeFollowSets();
+    phaseDone("FOLLOW");
+
+    lazy = true;
+    states.clear();
+    actionTable.clear();
+    gotoTable.clear();
+    lazyKernels.clear();
+    lazyRowReady.clear();
+    lazyProductionIndex = indexProductions();
+    kernelMap.reset();  // 惰性构造的状态编号与完整构造不同，增量更新不复用
+    stateEntries.clear();
+
+    std::set<LR0Item> initialItems;
+    initialItems.insert(LR0Item(grammar.productions[0], 0));  // S' -> .S
+    lazyKernels[initialItems] = 0;
+    states.push_back(State(initialItems, 0));
+    lazyRowReady.push_back(0);
+}
+
+// 惰性模式下确保状态的转移与分析表行已经生成
+void SLRGenerator::ensureRow(int stateNum) {
+    if (!lazy || lazyRowReady[stateNum]) return;
+    // 新发现的状态只保存了核心项目，第一次用到时才求闭包
+    // 注意states可能在下面扩容，因此每次都按下标访问
+    closure(states[stateNum].items);
+    std::set<std::string> symbols;
+    for (const auto& item : states[stateNum].items) {
+        if (item.dotPos < static_cast<int>(item.prod.right.size())) {
+            symbols.insert(item.prod.right[item.dotPos]);
+        }
+    }
+    for (const auto& symbol : symbols) {
+        std::set<LR0Item> kernel = computeKernel(states[stateNum].items, symbol);
+        auto it = lazyKernels.find(kernel);
+        int target;
+        if (it == lazyKernels.end()) {
+            target = states.size();
+            lazyKernels.emplace(kernel, target);
+            states.push_back(State(kernel, target));
+            lazyRowReady.push_back(0);
+        }
+        else {
+            target = it->second;
+        }
+        states[stateNum].transitions[symbol] = target;
+    }
+    generateTableRow(states[stateNum], lazyProductionIndex);
+    lazyRowReady[stateNum] = 1;
+}
+
+std::string SLRGenerator::action(int stateNum, const std::string& symbol) {
+    ensureRow(stateNum);
+    auto row = actionTable.find(stateNum);
+    if (row == actionTable.end()) return "";
+    auto entry = row->second.find(symbol);
+    return entry == row->second.end() ? "" : entry->second;
+}
+
+int SLRGenerator::gotoState(int stateNum, const std::string& nonTerminal) {
+    ensureRow(stateNum);
+    auto row = gotoTable.find(stateNum);
+    if (row == gotoTable.end()) return -1;
+    auto entry = row->second.find(nonTerminal);
+    return entry == row->second.end() ? -1 : std::stoi(entry->second);
+}
+
+// SLR分析驱动程序：输入为终结符序列（不含结束符#），
+// 成功时返回true，并按规约顺序记录所用的产生式编号
+bool SLRGenerator::parse(const std::vector<std::string>& input, std::vector<int>* reductions) {
+    std::vector<int> stateStack(1, 0);
+    size_t pos = 0;
+    static const std::string endMarker = "#";
+    for (;;) {
+        const std::string& symbol = pos < input.size() ? input[pos] : endMarker;
+        std::string act = action(stateStack.back(), symbol);
+        if (act.empty()) {
+            return false;  // 出错
+        }
+        if (act == "acc") {
+            return pos >= input.size();
+        }
+        if (act[0] == 's') {
+            // 移进
+            stateStack.push_back(std::stoi(act.substr(1)));
+            pos++;
+            continue;
+        }
+        // 规约：弹出右部长度个状态，再按GOTO表转移
+        int prodIndex = std::stoi(act.substr(1));
+        const Production& prod = grammar.productions[prodIndex];
+        stateStack.resize(stateStack.size() - prod.right.size());
+        int next = gotoState(stateStack.back(), prod.left);
+        if (next < 0) {
+            return false;
+        }
+        stateStack.push_back(next);
+        if (reductions) {
+            reductions->push_back(prodIndex);
+        }
+    }
+}
+
+std::map<Production, int> SLRGenerator::indexProductions() const {
+    std::map<Production, int> productionIndex;
+    for (size_t i = 0; i < grammar.productions.size(); i++) {
+        productionIndex.emplace(grammar.productions[i], i);
+    }
+    return productionIndex;
+}
+
+// 生成一个状态的ACTION/GOTO行
+void SLRGenerator::generateTableRow(const State& state,
+    const std::map<Production, int>& productionIndex) {
+    for (const auto& item : state.items) {
+        // 如果点号在末尾
+        if (item.dotPos == static_cast<int>(item.prod.right.size())) {
+            // 规约
+            if (item.prod.left == grammar.productions[0].left) {
+                // 接受
+                actionTable[state.stateNum]["#"] = "acc";
+            }
+            else {
+                // 查找产生式编号
+                int prodIndex = productionIndex.at(item.prod);
+
+                // 对Follow集中的所有符号添加规约动作
+                for (const auto& symbol : follow[item.prod.left]) {
+                    actionTable[state.stateNum][symbol] = "r" + std::to_string(prodIndex);
+                }
+            }
+        }
+        else {
+            // 移进
+            std::string nextSymbol = item.prod.right[item.dotPos];
+            if (state.transitions.count(nextSymbol) > 0) {
+                if (isTerminal(nextSymbol)) {
+                    // 使用 at() 代替 []
+                    int nextState = state.transitions.at(nextSymbol);
+                    actionTable[state.stateNum][nextSymbol] =
+                        "s" + std::to_string(nextState);
                 }
                 else {
-                    // Ҳʽ
-                    int prodIndex = 0;
-                    for (size_t i = 0; i < productions.size(); i++) {
-                        if (productions[i] == item.prod) {
-                            prodIndex = i;
-                            break;
-                        }
-                    }
+                    // 使用 at() 代替 []
+                    int nextState = state.transitions.at(nextSymbol);
+                    gotoTable[state.stateNum][nextSymbol] =
+                        std::to_string(nextState);
+                }
+            }
+        }
+    }
+}
 
-                    // FollowезӹԼ
-                    for (const auto& symbol : follow[item.prod.left]) {
-                        actionTable[state.stateNum][symbol] = "r" + std::to_string(prodIndex);
-                    }
+// 增量更新FIRST集：只重算产生式变化的非终结符以及FIRST依赖于它们的非终结符，
+// 返回重算过的非终结符
+std::set<std::string> SLRGenerator::updateFirstSets(const std::set<std::string>& changed) {
+    // A的FIRST依赖于右部中第一个终结符之前出现的非终结符（保守估计，不考虑能否推出ε）
+    std::map<std::string, std::set<std::string>> dependents;
+    for (const auto& prod : grammar.productions) {
+        for (const auto& symbol : prod.right) {
+            if (isTerminal(symbol)) break;
+            dependents[symbol].insert(prod.left);
+        }
+    }
+    std::set<std::string> affected;
+    std::vector<std::string> pending(changed.begin(), changed.end());
+    while (!pending.empty()) {
+        std::string symbol = pending.back();
+        pending.pop_back();
+        if (!affected.insert(symbol).second) continue;
+        for (const auto& dependent : dependents[symbol]) {
+            pending.push_back(dependent);
+        }
+    }
+
+    // 受影响的FIRST集清空后，仅在其产生式上迭代到不动点，其余FIRST集保持不变
+    for (const auto& symbol : affected) {
+        first[symbol].clear();
+    }
+    bool changedInRound;
+    do {
+        changedInRound = false;
+        for (const auto& symbol : affected) {
+            auto it = productionsByLeft.find(symbol);
+            if (it == productionsByLeft.end()) continue;
+            std::set<std::string>& firstSet = first[symbol];
+            size_t oldSize = firstSet.size();
+            for (size_t index : it->second) {
+                if (firstOfSequence(grammar.productions[index].right, 0, firstSet)) {
+                    firstSet.insert("ε");
                 }
             }
-            else {
-                // ƽ
-                std::string nextSymbol = item.prod.right[item.dotPos];
-                if (state.transitions.count(nextSymbol) > 0) {
-                    if (isTerminal(nextSymbol)) {
-                        // ʹ at()  []
-                        int nextState = state.transitions.at(nextSymbol);
-                        actionTable[state.stateNum][nextSymbol] =
-                            "s" + std::to_string(nextState);
-                    }
-                    else {
-                        // ʹ at()  []
-                        int nextState = state.transitions.at(nextSymbol);
-                        gotoTable[state.stateNum][nextSymbol] =
-                            std::to_string(nextState);
-                    }
+            if (firstSet.size() > oldSize) {
+                changedInRound = true;
+            }
+        }
+    } while (changedInRound);
+    return affected;
+}
+
+// 增量更新FOLLOW集，返回重算过的非终结符
+// 受影响的是：出现在增删产生式右部的非终结符；其后符号串中含FIRST集变化的非终结符；
+// 以及经由“位于产生式末尾（后缀可推出ε）”从受影响非终结符传递到的非终结符
+std::set<std::string> SLRGenerator::updateFollowSets(const std::vector<Production>& delta,
+    const std::set<std::string>& firstChanged) {
+    std::set<std::string> affected;
+    for (const auto& prod : delta) {
+        for (const auto& symbol : prod.right) {
+            if (!isTerminal(symbol)) affected.insert(symbol);
+        }
+    }
+    for (const auto& prod : grammar.productions) {
+        bool suffixChanged = false;  // 当前位置之后是否出现FIRST变化的非终结符
+        for (size_t i = prod.right.size(); i-- > 0;) {
+            if (suffixChanged && !isTerminal(prod.right[i])) {
+                affected.insert(prod.right[i]);
+            }
+            if (firstChanged.count(prod.right[i])) {
+                suffixChanged = true;
+            }
+        }
+    }
+    bool grown;
+    do {
+        grown = false;
+        for (const auto& prod : grammar.productions) {
+            if (!affected.count(prod.left)) continue;
+            for (size_t i = prod.right.size(); i-- > 0;) {
+                if (isTerminal(prod.right[i])) break;
+                if (affected.insert(prod.right[i]).second) {
+                    grown = true;
+                }
+                if (!first[prod.right[i]].count("ε")) break;
+            }
+        }
+    } while (grown);
+
+    // 受影响的FOLLOW集清空后重新迭代，只向受影响的集合中添加符号
+    for (const auto& symbol : affected) {
+        follow[symbol].clear();
+    }
+    if (affected.count(grammar.productions[0].left)) {
+        follow[grammar.productions[0].left].insert("#");
+    }
+    bool changedInRound;
+    do {
+        changedInRound = false;
+        for (const auto& prod : grammar.productions) {
+            for (size_t i = 0; i < prod.right.size(); i++) {
+                if (isTerminal(prod.right[i]) || !affected.count(prod.right[i])) continue;
+                std::set<std::string>& followSet = follow[prod.right[i]];
+                size_t oldSize = followSet.size();
+                if (firstOfSequence(prod.right, i + 1, followSet)) {
+                    const auto& leftFollow = follow[prod.left];
+                    followSet.insert(leftFollow.begin(), leftFollow.end());
+                }
+                if (followSet.size() > oldSize) {
+                    changedInRound = true;
                 }
             }
         }
+    } while (changedInRound);
+    return affected;
+}
+
+SLRGenerator::UpdateStats SLRGenerator::updateProductions(const std::vector<Production>& added,
+    const std::vector<Production>& removed) {
+    UpdateStats stats;
+    std::vector<Production> oldProductions = grammar.productions;
+
+    // 1. 修改文法，记录产生式集合发生变化的非终结符
+    std::set<std::string> changed;
+    for (const auto& prod : removed) {
+        auto it = std::find(grammar.productions.begin(), grammar.productions.end(), prod);
+        if (it == grammar.productions.end()) {
+            throw std::runtime_error("要删除的产生式不存在：" + prod.left);
+        }
+        if (it == grammar.productions.begin()) {
+            throw std::runtime_error("不能删除拓广产生式");
+        }
+        grammar.productions.erase(it);
+        changed.insert(prod.left);
     }
+    bool symbolKindChanged = false;  // 是否有终结符变成了非终结符
+    for (const auto& prod : added) {
+        if (std::find(grammar.productions.begin(), grammar.productions.end(), prod) !=
+            grammar.productions.end()) {
+            throw std::runtime_error("要添加的产生式已存在：" + prod.left);
+        }
+        if (!grammar.nonTerminals.count(prod.left)) {
+            if (grammar.terminals.erase(prod.left)) {
+                symbolKindChanged = true;
+            }
+            grammar.nonTerminals.insert(prod.left);
+        }
+        for (const auto& symbol : prod.right) {
+            if (isTerminal(symbol)) {
+                grammar.terminals.insert(symbol);
+            }
+        }
+        grammar.productions.push_back(prod);
+        changed.insert(prod.left);
+    }
+    productionsByLeft.clear();
+    for (size_t i = 0; i < grammar.productions.size(); i++) {
+        productionsByLeft[grammar.productions[i].left].push_back(i);
+    }
+    if (lazy) {
+        // 惰性模式下尚未构造的部分本来就按需生成，直接重新开始
+        prepareLazyTable();
+        stats.fullRebuild = true;
+        return stats;
+    }
+    if (symbolKindChanged || states.empty()) {
+        // 符号种类变化会影响所有含该符号的项目，直接完整重建
+        generateParsingTable();
+        stats.fullRebuild = true;
+        stats.statesRebuilt = states.size();
+        stats.rowsRegenerated = states.size();
+        return stats;
+    }
+
+    // 2. 增量更新FIRST、FOLLOW集
+    std::set<std::string> firstChanged = updateFirstSets(changed);
+    phaseDone("FIRST");
+    std::vector<Production> delta = added;
+    delta.insert(delta.end(), removed.begin(), removed.end());
+    std::set<std::string> followChanged = updateFollowSets(delta, firstChanged);
+    phaseDone("FOLLOW");
+    stats.firstRecomputed = firstChanged.size();
+    stats.followRecomputed = followChanged.size();
 
-    // ӡ
-    std::cout << "\nSLR" << std::endl;
-    printParsingTable(actionTable, gotoTable);
+    // 3. 标记旧自动机中闭包会受影响的状态：闭包展开过产生式发生变化的非终结符，
+    // 即某项目点号后为该非终结符，此时该状态在这个非终结符上必有转移
+    PreviousAutomaton previous;
+    previous.states = std::move(states);
+    previous.entries = std::move(stateEntries);
+    previous.clean.assign(previous.states.size(), 1);
+    for (size_t s = 0; s < previous.states.size(); s++) {
+        for (const auto& symbol : changed) {
+            if (previous.states[s].transitions.count(symbol)) {
+                previous.clean[s] = 0;
+                break;
+            }
+        }
+    }
+    constructLR0Items(&previous);
+    for (size_t s = 0; s < states.size(); s++) {
+        int old = previousStateOf[s];
+        if (old >= 0 && previous.clean[old]) stats.statesReused++;
+        else stats.statesRebuilt++;
+    }
+    phaseDone("LR0");
+
+    // 4. 修补分析表：未受影响且规约项目的FOLLOW集未变的状态，
+    // 沿用旧行并把其中的状态号、产生式号换成新编号；其余状态重新生成该行
+    std::map<Production, int> productionIndex = indexProductions();
+    std::vector<int> productionRenumber(oldProductions.size(), -1);
+    for (size_t i = 0; i < oldProductions.size(); i++) {
+        auto it = productionIndex.find(oldProductions[i]);
+        if (it != productionIndex.end()) productionRenumber[i] = it->second;
+    }
+    std::vector<int> stateRenumber(previous.states.size(), -1);
+    for (size_t s = 0; s < states.size(); s++) {
+        if (previousStateOf[s] >= 0) stateRenumber[previousStateOf[s]] = s;
+    }
+    ActionTable oldAction;
+    GotoTable oldGoto;
+    oldAction.swap(actionTable);
+    oldGoto.swap(gotoTable);
+    for (const auto& state : states) {
+        int old = previousStateOf[state.stateNum];
+        bool reusable = old >= 0 && previous.clean[old];
+        for (const auto& item : state.items) {
+            if (!reusable) break;
+            if (item.dotPos == static_cast<int>(item.prod.right.size()) && followChanged.count(item.prod.left)) {
+                reusable = false;
+            }
+        }
+        if (!reusable) {
+            generateTableRow(state, productionIndex);
+            stats.rowsRegenerated++;
+            continue;
+        }
+        // 旧行整体移入，只改写编号发生变化的表项
+        auto actionRow = oldAction.find(old);
+        if (actionRow != oldAction.end()) {
+            auto& row = actionTable.emplace_hint(actionTable.end(), state.stateNum,
+                std::move(actionRow->second))->second;
+            for (auto& entry : row) {
+                std::string& action = entry.second;
+                if (action[0] != 's' && action[0] != 'r') continue;  // acc
+                int number = std::stoi(action.substr(1));
+                int renumbered = action[0] == 's' ? stateRenumber[number] : productionRenumber[number];
+                if (renumbered != number) {
+                    action = action[0] + std::to_string(renumbered);
+                }
+            }
+        }
+        auto gotoRow = oldGoto.find(old);
+        if (gotoRow != oldGoto.end()) {
+            auto& row = gotoTable.emplace_hint(gotoTable.end(), state.stateNum,
+                std::move(gotoRow->second))->second;
+            for (auto& entry : row) {
+                int number = std::stoi(entry.second);
+                if (stateRenumber[number] != number) {
+                    entry.second = std::to_string(stateRenumber[number]);
+                }
+            }
+        }
+        stats.rowsPatched++;
+    }
+    phaseDone("TABLE");
+    return stats;
+}
+
+void SLRGenerator::phaseDone(const std::string& phase) {
+    if (phaseCallback) {
+        phaseCallback(phase);
+    }
 }
 
-void SLRGenerator::printParsingTable(const ActionTable& actionTable,
-    const GotoTable& gotoTable) {
-    // ȡսͷս
+void SLRGenerator::printParsingTable() const {
+    std::cout << "\nSLR分析表：" << std::endl;
+    // 获取所有终结符和非终结符
     std::set<std::string> terminals, nonTerminals;
-    for (const auto& prod : productions) {
+    for (const auto& prod : grammar.productions) {
         if (!isTerminal(prod.left)) {
             nonTerminals.insert(prod.left);
         }
@@ -308,23 +856,23 @@ void SLRGenerator::printParsingTable(const ActionTable& actionTable,
     }
     terminals.insert("#");
 
-    // ӡͷ
-    std::cout << "״̬\t";
+    // 打印表头
+    std::cout << "状态\t";
     for (const auto& term : terminals) {
         std::cout << term << "\t";
     }
     for (const auto& nonTerm : nonTerminals) {
-        if (nonTerm != "S'") {
+        if (nonTerm != grammar.productions[0].left) {
             std::cout << nonTerm << "\t";
         }
     }
     std::cout << std::endl;
 
-    // ӡÿһ
+    // 打印每一行
     for (const auto& state : states) {
         std::cout << state.stateNum << "\t";
 
-        // ӡACTION
+        // 打印ACTION部分
         for (const auto& term : terminals) {
             if (actionTable.count(state.stateNum) &&
                 actionTable.at(state.stateNum).count(term)) {
@@ -333,9 +881,9 @@ void SLRGenerator::printParsingTable(const ActionTable& actionTable,
             std::cout << "\t";
         }
 
-        // ӡGOTO
+        // 打印GOTO部分
         for (const auto& nonTerm : nonTerminals) {
-            if (nonTerm != "S'" &&
+            if (nonTerm != grammar.productions[0].left &&
                 gotoTable.count(state.stateNum) &&
                 gotoTable.at(state.stateNum).count(nonTerm)) {
                 std::cout << gotoTable.at(state.stateNum).at(nonTerm);
@@ -344,22 +892,4 @@ void SLRGenerator::printParsingTable(const ActionTable& actionTable,
         }
         std::cout << std::endl;
     }
-}
-
-void SLRGenerator::generateArithmeticTable() {
-    std::cout << "ʽSLR..." << std::endl;
-    initArithmeticGrammar();//ʼķͬ
-    generateParsingTable();
-}
-
-void SLRGenerator::generateBooleanTable() {
-    std::cout << "ɲʽSLR..." << std::endl;
-    initBooleanGrammar();
-    generateParsingTable();
-}
-
-void SLRGenerator::generateStatementTable() {
-    std::cout << "ɳSLR..." << std::endl;
-    initStatementGrammar();
-    generateParsingTable();
 }
\ No newline at end of file
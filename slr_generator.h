@@ -1,37 +1,124 @@
-#pragma once
-#include "production.h"
-#include "lr0_item.h"
-#include <string>
-#include <vector>
-#include <map>
-#include <set>
-
-using ActionTable = std::map<int, std::map<std::string, std::string>>;
-using GotoTable = std::map<int, std::map<std::string, std::string>>;
-
-class SLRGenerator {
-public:
-    SLRGenerator();
-
-    void generateArithmeticTable();
-    void generateBooleanTable();
-    void generateStatementTable();
-
-private:
-    std::vector<Production> productions;
-    std::map<std::string, std::set<std::string>> first;
-    std::map<std::string, std::set<std::string>> follow;
-    std::vector<State> states;
-
-    void initArithmeticGrammar();
-    void initBooleanGrammar();
-    void initStatementGrammar();
-    void computeFirstSets();
-    void computeFollowSets();
-    void constructLR0Items();
-    void generateParsingTable();
-    bool isTerminal(const std::string& symbol);
-    void closure(std::set<LR0Item>& items);
-    std::set<LR0Item> computeGoto(const std::set<LR0Item>& items, const std::string& symbol);
-    void printParsingTable(const ActionTable& actionTable, const GotoTable& gotoTable);
+#pragma once
+#include "grammar.h"
+#include "lr0_item.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <functional>
+#include <memory>
+
+using ActionTable = std::map<int, std::map<std::string, std::string>>;
+using GotoTable = std::map<int, std::map<std::string, std::string>>;
+
+class SLRGenerator {
+public:
+    // threadCount为0时使用全部硬件线程构造LR(0)项目集族
+    explicit SLRGenerator(const Grammar& grammar, unsigned threadCount = 0);
+    SLRGenerator(SLRGenerator&&) noexcept;
+    SLRGenerator& operator=(SLRGenerator&&) noexcept;
+    ~SLRGenerator();
+
+    static Grammar arithmeticGrammar();
+    static Grammar booleanGrammar();
+    static Grammar statementGrammar();
+
+    // 计算FIRST/FOLLOW集、LR(0)项目集族和SLR分析表
+    void generateParsingTable();
+    void printParsingTable() const;
+
+    // 惰性模式：只准备FIRST/FOLLOW集和初始状态，
+    // 其余状态和分析表行在action/gotoState第一次查询时构造并记住。
+    // 惰性模式的状态按查询顺序编号，与完整构造的编号不同，但分析结果相同
+    void prepareLazyTable();
+    bool isLazy() const { return lazy; }
+
+    // 查询分析表，出错时action返回空串、gotoState返回-1
+    std::string action(int stateNum, const std::string& symbol);
+    int gotoState(int stateNum, const std::string& nonTerminal);
+    // 用分析表分析终结符序列（不含结束符#），reductions按顺序记录规约所用的产生式编号
+    bool parse(const std::vector<std::string>& input, std::vector<int>* reductions = nullptr);
+
+    // 每完成一个阶段（FIRST、FOLLOW、LR0、TABLE）调用一次，供基准测试统计各阶段开销
+    void setPhaseCallback(std::function<void(const std::string&)> callback) {
+        phaseCallback = callback;
+    }
+
+    const Grammar& getGrammar() const { return grammar; }
+    const std::vector<State>& getStates() const { return states; }
+    const ActionTable& getActionTable() const { return actionTable; }
+    const GotoTable& getGotoTable() const { return gotoTable; }
+    const std::map<std::string, std::set<std::string>>& getFirstSets() const { return first; }
+    const std::map<std::string, std::set<std::string>>& getFollowSets() const { return follow; }
+
+    // 增量更新的统计信息
+    struct UpdateStats {
+        bool fullRebuild = false;     // 是否退化为完整重建
+        size_t firstRecomputed = 0;   // 重算FIRST集的非终结符数
+        size_t followRecomputed = 0;  // 重算FOLLOW集的非终结符数
+        size_t statesReused = 0;      // 沿用旧闭包与转移的状态数
+        size_t statesRebuilt = 0;     // 重新求闭包和GOTO的状态数
+        size_t rowsPatched = 0;       // 沿用并改编号的分析表行数
+        size_t rowsRegenerated = 0;   // 重新生成的分析表行数
+    };
+    // 在已生成的分析表上增删产生式（删除的产生式从原位置移除，新增的追加在末尾），
+    // 只重算受影响的FIRST/FOLLOW集、项目集闭包和分析表行，结果与对新文法完整重建相同。
+    // 删除不存在的产生式、添加已有产生式或删除拓广产生式时抛出std::runtime_error
+    UpdateStats updateProductions(const std::vector<Production>& added,
+        const std::vector<Production>& removed);
+
+private:
+    Grammar grammar;
+    unsigned threadCount;
+    std::map<std::string, std::vector<size_t>> productionsByLeft;  // 左部 -> 产生式下标
+    std::map<std::string, std::set<std::string>> first;
+    std::map<std::string, std::set<std::string>> follow;
+    std::vector<State> states;
+    std::vector<int> previousStateOf;  // 增量构造时新状态对应的旧状态号，无对应为-1
+
+    // 核心项目集在并发映射中的表项，两次构造之间保留以支持增量更新
+    struct KernelEntry {
+        const std::set<LR0Item>* kernel = nullptr;
+        size_t shard = 0;
+        int stateNum = -1;                 // 本轮编号，-1表示本层新发现、尚未编号
+        int previousNum = -1;              // 上一轮构造中的状态号
+        unsigned long long firstSeen = 0;  // 本层内的最小发现序号
+        unsigned generation = 0;           // 最近一次到达该核心的构造轮次
+    };
+    class KernelMap;
+    std::unique_ptr<KernelMap> kernelMap;
+    std::vector<KernelEntry*> stateEntries;  // 状态号 -> 核心表项
+    unsigned generation = 0;
+    ActionTable actionTable;
+    GotoTable gotoTable;
+    std::function<void(const std::string&)> phaseCallback;
+
+    // 惰性模式
+    bool lazy = false;
+    std::map<std::set<LR0Item>, int> lazyKernels;  // 核心项目集 -> 状态号
+    std::vector<char> lazyRowReady;                // 状态的转移与分析表行是否已生成
+    std::map<Production, int> lazyProductionIndex;
+    void ensureRow(int stateNum);
+
+    void computeFirstSets();
+    void computeFollowSets();
+    // 增量构造时可复用的旧自动机
+    struct PreviousAutomaton {
+        std::vector<State> states;           // 可复用状态的项目集会被移走
+        std::vector<char> clean;             // 闭包不受本次修改影响的状态
+        std::vector<KernelEntry*> entries;   // 旧状态号 -> 核心表项
+    };
+    void constructLR0Items(PreviousAutomaton* previous = nullptr);
+    std::set<std::string> updateFirstSets(const std::set<std::string>& changed);
+    std::set<std::string> updateFollowSets(const std::vector<Production>& delta,
+        const std::set<std::string>& firstChanged);
+    std::map<Production, int> indexProductions() const;
+    void generateTableRow(const State& state, const std::map<Production, int>& productionIndex);
+    void phaseDone(const std::string& phase);
+    bool isTerminal(const std::string& symbol) const;
+    bool firstOfSequence(const std::vector<std::string>& symbols, size_t from,
+        std::set<std::string>& result);
+    void closure(std::set<LR0Item>& items) const;
+    std::set<LR0Item> computeKernel(const std::set<LR0Item>& items, const std::string& symbol) const;
+    std::set<LR0Item> computeGoto(const std::set<LR0Item>& items, const std::string& symbol) const;
 };
\ No newline at end of file
@@ -0,0 +1,595 @@
+#include "ssa.h"
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+void compute_dominance_frontiers(const CFG& cfg, std::vector<int>& df_offset, std::vector<int>& df) {
+    int num_blocks = cfg.num_blocks();
+    // 汇合块b的每个前驱沿支配树向上走到 idom(b) 为止，途经的块的支配边界都含b
+    std::vector<std::pair<int, int>> pairs;
+    std::vector<int> marker(num_blocks, -1);
+    for (int b = 0; b < num_blocks; b++) {
+        // 入口块另有一条来自程序开始的隐含边
+        int incoming = cfg.pred_end(b) - cfg.pred_begin(b) + (cfg.idom[b] == b ? 1 : 0);
+        if (!cfg.reachable(b) || incoming < 2) continue;
+        // 入口块没有严格支配者，一直走到入口块本身为止
+        int stop = cfg.idom[b] == b ? -1 : cfg.idom[b];
+        for (int p = cfg.pred_begin(b); p < cfg.pred_end(b); p++) {
+            int runner = cfg.pred[p];
+            if (!cfg.reachable(runner)) continue;
+            while (runner != stop && marker[runner] != b) {
+                marker[runner] = b;
+                pairs.push_back({ runner, b });
+                if (runner == cfg.idom[runner]) break;  // 入口块
+                runner = cfg.idom[runner];
+            }
+        }
+    }
+    df_offset.assign(num_blocks + 1, 0);
+    for (const auto& pair : pairs) df_offset[pair.first + 1]++;
+    for (int b = 0; b < num_blocks; b++) df_offset[b + 1] += df_offset[b];
+    df.assign(pairs.size(), 0);
+    std::vector<int> fill(df_offset.begin(), df_offset.end() - 1);
+    for (const auto& pair : pairs) df[fill[pair.first]++] = pair.second;
+}
+
+// 构造SSA视图
+SSAForm build_ssa(const std::vector<Quadruple>& quads, const CFG& cfg) {
+    SSAForm ssa;
+    int n = static_cast<int>(quads.size());
+    int num_blocks = cfg.num_blocks();
+
+    // 1. 为变量与临时变量编号，记下每条四元式的引用与定值名字
+    std::unordered_map<std::string, int> nameId;
+    auto idOf = [&](const std::string& s) {
+        if (s.empty() || is_number(s)) return -1;
+        auto it = nameId.find(s);
+        if (it != nameId.end()) return it->second;
+        int id = static_cast<int>(ssa.names.size());
+        nameId[s] = id;
+        ssa.names.push_back(s);
+        return id;
+    };
+    std::vector<int> useName(2 * n, -1), defName(n, -1);
+    for (int i = 0; i < n; i++) {
+        useName[2 * i] = idOf(quads[i].arg1);
+        useName[2 * i + 1] = idOf(quads[i].arg2);
+        if (!is_jump(quads[i].op)) defName[i] = idOf(quads[i].result);
+    }
+    int num_names = static_cast<int>(ssa.names.size());
+
+    // 2. 跨块活跃的名字（块内先引用后定值）与各名字的定值块。
+    //    变量在程序结束时的值也是引用，变量一律看作跨块活跃
+    std::vector<char> global(num_names, 0);
+    for (int name = 0; name < num_names; name++) {
+        if (!is_temp(ssa.names[name])) {
+            global[name] = 1;
+            ssa.exit_names.push_back(name);
+        }
+    }
+    std::vector<std::vector<int>> defBlocks(num_names);
+    std::vector<int> definedIn(num_names, -1);
+    for (int b : cfg.rpo) {
+        for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+            for (int k = 0; k < 2; k++) {
+                int name = useName[2 * i + k];
+                if (name >= 0 && definedIn[name] != b) global[name] = 1;
+            }
+            int name = defName[i];
+            if (name >= 0 && definedIn[name] != b) {
+                definedIn[name] = b;
+                defBlocks[name].push_back(b);
+            }
+        }
+    }
+
+    // 3. 在迭代支配边界上放置φ函数
+    std::vector<int> df_offset, df;
+    compute_dominance_frontiers(cfg, df_offset, df);
+    std::vector<std::pair<int, int>> placed;  // (块, 名字)
+    std::vector<int> hasPhi(num_blocks, -1), queued(num_blocks, -1), worklist;
+    for (int name = 0; name < num_names; name++) {
+        if (!global[name]) continue;
+        worklist = defBlocks[name];
+        for (int b : worklist) queued[b] = name;
+        while (!worklist.empty()) {
+            int b = worklist.back();
+            worklist.pop_back();
+            for (int k = df_offset[b]; k < df_offset[b + 1]; k++) {
+                int d = df[k];
+                if (hasPhi[d] == name) continue;
+                hasPhi[d] = name;
+                placed.push_back({ d, name });
+                if (queued[d] != name) {
+                    queued[d] = name;
+                    worklist.push_back(d);
+                }
+            }
+        }
+    }
+    std::sort(placed.begin(), placed.end());
+    ssa.phi_offset.assign(num_blocks + 1, 0);
+    for (const auto& phi : placed) {
+        ssa.phi_offset[phi.first + 1]++;
+        int value = ssa.num_values();
+        ssa.values.push_back({ SSAForm::PHI, static_cast<int>(ssa.phis.size()), phi.second });
+        int args = cfg.pred_end(phi.first) - cfg.pred_begin(phi.first) + (phi.first == cfg.rpo[0] ? 1 : 0);
+        ssa.phis.push_back({ phi.first, value, std::vector<int>(args, -1) });
+    }
+    for (int b = 0; b < num_blocks; b++) ssa.phi_offset[b + 1] += ssa.phi_offset[b];
+
+    // 4. 沿支配树先序重命名：每个名字维护一个值栈，离开块时弹出该块压入的值
+    std::vector<int> child_offset(num_blocks + 1, 0), children(cfg.rpo.size(), 0);
+    int entry = cfg.rpo.empty() ? -1 : cfg.rpo[0];
+    for (int b : cfg.rpo) {
+        if (b != entry) child_offset[cfg.idom[b] + 1]++;
+    }
+    for (int b = 0; b < num_blocks; b++) child_offset[b + 1] += child_offset[b];
+    std::vector<int> fill(child_offset.begin(), child_offset.end() - 1);
+    for (int b : cfg.rpo) {
+        if (b != entry) children[fill[cfg.idom[b]]++] = b;
+    }
+
+    ssa.def_value.assign(n, -1);
+    ssa.use_value.assign(2 * n, -1);
+    std::vector<std::vector<int>> stacks(num_names);
+    std::vector<int> entryValue(num_names, -1);
+    std::vector<int> pushed;  // 按压栈顺序记录名字
+    auto current = [&](int name) {
+        if (!stacks[name].empty()) return stacks[name].back();
+        if (entryValue[name] < 0) {
+            entryValue[name] = ssa.num_values();
+            ssa.values.push_back({ SSAForm::ENTRY, -1, name });
+        }
+        return entryValue[name];
+    };
+    auto push = [&](int name, int value) {
+        stacks[name].push_back(value);
+        pushed.push_back(name);
+    };
+
+    std::vector<int> exitIndex(num_blocks, -1);
+    for (size_t e = 0; e < cfg.exits.size(); e++) exitIndex[cfg.exits[e]] = static_cast<int>(e);
+    ssa.exit_values.assign(cfg.exits.size() * ssa.exit_names.size(), -1);
+
+    if (entry >= 0) {
+        for (int p = ssa.phi_offset[entry]; p < ssa.phi_offset[entry + 1]; p++) {
+            ssa.phis[p].args.back() = current(ssa.values[ssa.phis[p].value].name);
+        }
+    }
+
+    struct Frame { int block, child; size_t mark; };
+    std::vector<Frame> walk;
+    if (entry >= 0) walk.push_back({ entry, -1, 0 });
+    while (!walk.empty()) {
+        Frame& frame = walk.back();
+        int b = frame.block;
+        if (frame.child < 0) {
+            frame.mark = pushed.size();
+            frame.child = child_offset[b];
+            for (int p = ssa.phi_offset[b]; p < ssa.phi_offset[b + 1]; p++) {
+                push(ssa.values[ssa.phis[p].value].name, ssa.phis[p].value);
+            }
+            for (int i = cfg.first_quad(b); i <= cfg.last_quad(b); i++) {
+                for (int k = 0; k < 2; k++) {
+                    if (useName[2 * i + k] >= 0) ssa.use_value[2 * i + k] = current(useName[2 * i + k]);
+                }
+                if (defName[i] >= 0) {
+                    int value = ssa.num_values();
+                    ssa.values.push_back({ SSAForm::QUAD, i, defName[i] });
+                    ssa.def_value[i] = value;
+                    push(defName[i], value);
+                }
+            }
+            if (exitIndex[b] >= 0) {
+                size_t at = exitIndex[b] * ssa.exit_names.size();
+                for (size_t k = 0; k < ssa.exit_names.size(); k++) ssa.exit_values[at + k] = current(ssa.exit_names[k]);
+            }
+            for (int s = cfg.succ_begin(b); s < cfg.succ_end(b); s++) {
+                int succ = cfg.succ[s];
+                int index = 0;
+                while (cfg.pred[cfg.pred_begin(succ) + index] != b) index++;
+                for (int p = ssa.phi_offset[succ]; p < ssa.phi_offset[succ + 1]; p++) {
+                    ssa.phis[p].args[index] = current(ssa.values[ssa.phis[p].value].name);
+                }
+            }
+        }
+        if (frame.child < child_offset[b + 1]) {
+            int child = children[frame.child++];
+            walk.push_back({ child, -1, 0 });
+            continue;
+        }
+        while (pushed.size() > frame.mark) {
+            stacks[pushed.back()].pop_back();
+            pushed.pop_back();
+        }
+        walk.pop_back();
+    }
+
+    // 5. 每个值的引用者
+    int num_values = ssa.num_values();
+    ssa.use_offset.assign(num_values + 1, 0);
+    for (int value : ssa.use_value) {
+        if (value >= 0) ssa.use_offset[value + 1]++;
+    }
+    for (const auto& phi : ssa.phis) {
+        for (int value : phi.args) {
+            if (value >= 0) ssa.use_offset[value + 1]++;
+        }
+    }
+    for (int v = 0; v < num_values; v++) ssa.use_offset[v + 1] += ssa.use_offset[v];
+    ssa.users.assign(ssa.use_offset[num_values], 0);
+    std::vector<int> next(ssa.use_offset.begin(), ssa.use_offset.end() - 1);
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < 2; k++) {
+            int value = ssa.use_value[2 * i + k];
+            if (value >= 0 && (k == 0 || value != ssa.use_value[2 * i])) {
+                ssa.users[next[value]++] = 2 * i;
+            }
+        }
+    }
+    for (size_t p = 0; p < ssa.phis.size(); p++) {
+        const auto& args = ssa.phis[p].args;
+        for (size_t k = 0; k < args.size(); k++) {
+            if (args[k] >= 0 && std::find(args.begin(), args.begin() + k, args[k]) == args.begin() + k) {
+                ssa.users[next[args[k]]++] = 2 * static_cast<int>(p) + 1;
+            }
+        }
+    }
+    // 同一条四元式或φ函数重复引用同一个值时只记一次，收缩数组
+    std::vector<int> compact;
+    compact.reserve(ssa.users.size());
+    for (int v = 0; v < num_values; v++) {
+        int begin = ssa.use_offset[v];
+        ssa.use_offset[v] = static_cast<int>(compact.size());
+        compact.insert(compact.end(), ssa.users.begin() + begin, ssa.users.begin() + next[v]);
+    }
+    ssa.use_offset[num_values] = static_cast<int>(compact.size());
+    ssa.users.swap(compact);
+    return ssa;
+}
+
+namespace {
+
+// 并行复制（目标互不相同）排成顺序复制：目标不再被其他复制读取的先做；
+// 剩下的复制都在环上时，先把一个目标的旧值存入临时变量，读它的复制改读临时变量
+void sequentialize(std::vector<std::pair<std::string, std::string>>& copies,
+    const std::function<std::string()>& newTemp, std::vector<Quadruple>& out, SSADestructStats& stats) {
+    copies.erase(std::remove_if(copies.begin(), copies.end(),
+        [](const std::pair<std::string, std::string>& copy) { return copy.first == copy.second; }), copies.end());
+    std::unordered_map<std::string, int> readers, writer;
+    for (size_t k = 0; k < copies.size(); k++) {
+        readers[copies[k].second]++;
+        writer[copies[k].first] = static_cast<int>(k);
+    }
+    std::vector<char> done(copies.size(), 0);
+    std::vector<int> ready;
+    for (size_t k = 0; k < copies.size(); k++) {
+        if (!readers.count(copies[k].first)) ready.push_back(static_cast<int>(k));
+    }
+    size_t emitted = 0, scan = 0;
+    while (emitted < copies.size()) {
+        while (!ready.empty()) {
+            int k = ready.back();
+            ready.pop_back();
+            const auto& copy = copies[k];
+            out.push_back(Quadruple{ 0, ":=", copy.second, "", copy.first });
+            done[k] = 1;
+            emitted++;
+            stats.copies++;
+            auto it = writer.find(copy.second);
+            if (--readers[copy.second] == 0 && it != writer.end() && !done[it->second]) ready.push_back(it->second);
+        }
+        if (emitted == copies.size()) break;
+        while (done[scan]) scan++;
+        std::string saved = copies[scan].first, temp = newTemp();
+        out.push_back(Quadruple{ 0, ":=", saved, "", temp });
+        stats.copies++;
+        stats.cycles++;
+        for (size_t k = 0; k < copies.size(); k++) {
+            if (!done[k] && copies[k].second == saved) copies[k].second = temp;
+        }
+        readers[temp] = readers[saved];
+        readers[saved] = 0;
+        ready.push_back(static_cast<int>(scan));
+    }
+}
+
+}
+
+// 退出SSA
+SSADestructStats destruct_ssa(std::vector<Quadruple>& quads, const CFG& cfg, const SSAForm& ssa) {
+    SSADestructStats stats;
+    int n = static_cast<int>(quads.size());
+    if (n == 0 || cfg.rpo.empty()) return stats;
+    int base = cfg.base_label;
+    int num_blocks = cfg.num_blocks();
+    int num_values = ssa.num_values();
+    int num_names = static_cast<int>(ssa.names.size());
+    int entry = cfg.rpo[0];
+    size_t width = ssa.exit_names.size();
+    auto newTemp = temp_allocator(quads);
+
+    std::vector<int> defBlock(num_values, -1);
+    for (int v = 0; v < num_values; v++) {
+        const SSAForm::Value& value = ssa.values[v];
+        if (value.kind == SSAForm::QUAD) defBlock[v] = cfg.block_of_quad[value.def];
+        else if (value.kind == SSAForm::PHI) defBlock[v] = ssa.phis[value.def].block;
+    }
+    auto predIndex = [&](int block, int pred) {
+        for (int p = cfg.pred_begin(block); p < cfg.pred_end(block); p++) {
+            if (cfg.pred[p] == pred) return p - cfg.pred_begin(block);
+        }
+        return -1;
+    };
+
+    // 1. 有用的φ函数：被四元式、出口或有用的φ函数引用（视图可能已被改写，不用 ssa.users）
+    std::vector<char> used(num_values, 0);
+    std::vector<int> work;
+    auto markUsed = [&](int v) {
+        if (v >= 0 && !used[v]) {
+            used[v] = 1;
+            if (ssa.values[v].kind == SSAForm::PHI) work.push_back(v);
+        }
+    };
+    for (int i = 0; i < n; i++) {
+        if (!cfg.reachable(cfg.block_of_quad[i])) continue;
+        markUsed(ssa.use_value[2 * i]);
+        markUsed(ssa.use_value[2 * i + 1]);
+    }
+    for (int v : ssa.exit_values) markUsed(v);
+    while (!work.empty()) {
+        int v = work.back();
+        work.pop_back();
+        for (int arg : ssa.phis[ssa.values[v].def].args) markUsed(arg);
+    }
+    auto livePhi = [&](int p) { return used[ssa.phis[p].value] != 0; };
+
+    // 2. 引用按值排成压缩数组：2i 为第i条四元式处的引用，2b+1 为块b末尾的引用（φ参数、出口）
+    std::vector<std::pair<int, int>> uses;
+    for (int i = 0; i < n; i++) {
+        if (!cfg.reachable(cfg.block_of_quad[i])) continue;
+        for (int k = 0; k < 2; k++) {
+            if (ssa.use_value[2 * i + k] >= 0) uses.push_back({ ssa.use_value[2 * i + k], 2 * i });
+        }
+    }
+    for (size_t p = 0; p < ssa.phis.size(); p++) {
+        if (!livePhi(static_cast<int>(p))) continue;
+        const SSAForm::Phi& phi = ssa.phis[p];
+        for (int k = 0; k < cfg.pred_end(phi.block) - cfg.pred_begin(phi.block); k++) {
+            if (phi.args[k] >= 0) uses.push_back({ phi.args[k], 2 * cfg.pred[cfg.pred_begin(phi.block) + k] + 1 });
+        }
+    }
+    for (size_t e = 0; e < cfg.exits.size(); e++) {
+        if (!cfg.reachable(cfg.exits[e])) continue;
+        for (size_t k = 0; k < width; k++) {
+            int v = ssa.exit_values[e * width + k];
+            if (v >= 0) uses.push_back({ v, 2 * cfg.exits[e] + 1 });
+        }
+    }
+    std::vector<int> use_offset(num_values + 1, 0), use_at(uses.size());
+    for (const auto& use : uses) use_offset[use.first + 1]++;
+    for (int v = 0; v < num_values; v++) use_offset[v + 1] += use_offset[v];
+    std::vector<int> fill(use_offset.begin(), use_offset.end() - 1);
+    for (const auto& use : uses) use_at[fill[use.first]++] = use.second;
+
+    // 3. 活跃块：从每个引用沿前驱向上标记到定值块为止，代价与生存期覆盖的块数成正比
+    std::vector<std::vector<int>> live_out(num_blocks);
+    std::vector<int> markIn(num_blocks, -1), markOut(num_blocks, -1);
+    auto liveOut = [&](int b, int v) {
+        if (markOut[b] == v) return;
+        markOut[b] = v;
+        live_out[b].push_back(v);
+    };
+    auto liveIn = [&](int b, int v) {
+        work.assign(1, b);
+        while (!work.empty()) {
+            int x = work.back();
+            work.pop_back();
+            if (markIn[x] == v) continue;
+            markIn[x] = v;
+            for (int p = cfg.pred_begin(x); p < cfg.pred_end(x); p++) {
+                int pred = cfg.pred[p];
+                if (!cfg.reachable(pred)) continue;
+                liveOut(pred, v);
+                if (defBlock[v] != pred) work.push_back(pred);
+            }
+        }
+    };
+    for (int v = 0; v < num_values; v++) {
+        const SSAForm::Value& value = ssa.values[v];
+        for (int k = use_offset[v]; k < use_offset[v + 1]; k++) {
+            int at = use_at[k];
+            if (at % 2 == 0) {
+                int i = at / 2, b = cfg.block_of_quad[i];
+                bool local = defBlock[v] == b && (value.kind == SSAForm::PHI || value.def < i);
+                if (!local) liveIn(b, v);
+            }
+            else {
+                int b = at / 2;
+                liveOut(b, v);
+                if (defBlock[v] != b) liveIn(b, v);
+            }
+        }
+    }
+
+    // 4. 同名值的重叠：逐块从块尾向前扫描，定值处（包括块首的φ函数）同名的其他值仍活跃即重叠
+    std::vector<std::pair<int, int>> overlaps;
+    std::vector<char> isLive(num_values, 0);
+    std::vector<std::vector<int>> liveOfName(num_names);
+    std::vector<int> touchedNames;
+    auto add = [&](int v) {
+        if (isLive[v]) return;
+        isLive[v] = 1;
+        auto& list = liveOfName[ssa.values[v].name];
+        if (list.empty()) touchedNames.push_back(ssa.values[v].name);
+        list.push_back(v);
+    };
+    auto kill = [&](int v) {
+        if (!isLive[v]) return;
+        isLive[v] = 0;
+        auto& list = liveOfName[ssa.values[v].name];
+        list.erase(std::find(list.begin(), list.end(), v));
+    };
+    auto define = [&](int v) {
+        for (int w : liveOfName[ssa.values[v].name]) overlaps.push_back({ v, w });
+    };
+    for (int b : cfg.rpo) {
+        for (int v : live_out[b]) add(v);
+        for (int i = cfg.last_quad(b); i >= cfg.first_quad(b); i--) {
+            int d = ssa.def_value[i];
+            if (d >= 0) {
+                kill(d);
+                define(d);
+            }
+            for (int k = 0; k < 2; k++) {
+                if (ssa.use_value[2 * i + k] >= 0) add(ssa.use_value[2 * i + k]);
+            }
+        }
+        for (int p = ssa.phi_offset[b]; p < ssa.phi_offset[b + 1]; p++) {
+            if (livePhi(p)) kill(ssa.phis[p].value);
+        }
+        for (int p = ssa.phi_offset[b]; p < ssa.phi_offset[b + 1]; p++) {
+            if (livePhi(p)) define(ssa.phis[p].value);
+        }
+        for (int name : touchedNames) {
+            for (int v : liveOfName[name]) isLive[v] = 0;
+            liveOfName[name].clear();
+        }
+        touchedNames.clear();
+    }
+
+    // 5. 命名：入口值、出口值优先保留原名，其余按编号；与已保留原名的同名值重叠时换用新临时变量
+    std::vector<int> overlap_offset(num_values + 1, 0), overlap(2 * overlaps.size());
+    for (const auto& pair : overlaps) {
+        overlap_offset[pair.first + 1]++;
+        overlap_offset[pair.second + 1]++;
+    }
+    for (int v = 0; v < num_values; v++) overlap_offset[v + 1] += overlap_offset[v];
+    fill.assign(overlap_offset.begin(), overlap_offset.end() - 1);
+    for (const auto& pair : overlaps) {
+        overlap[fill[pair.first]++] = pair.second;
+        overlap[fill[pair.second]++] = pair.first;
+    }
+    std::vector<int> order;
+    std::vector<char> ordered(num_values, 0);
+    for (int v = 0; v < num_values; v++) {
+        if (ssa.values[v].kind == SSAForm::ENTRY) {
+            order.push_back(v);
+            ordered[v] = 1;
+        }
+    }
+    for (int v : ssa.exit_values) {
+        if (v >= 0 && !ordered[v]) {
+            order.push_back(v);
+            ordered[v] = 1;
+        }
+    }
+    for (int v = 0; v < num_values; v++) {
+        if (!ordered[v]) order.push_back(v);
+    }
+    std::vector<char> original(num_values, 0);
+    std::vector<std::string> fresh(num_values);
+    for (int v : order) {
+        bool free = true;
+        for (int k = overlap_offset[v]; k < overlap_offset[v + 1] && free; k++) free = !original[overlap[k]];
+        if (free) original[v] = 1;
+        else {
+            fresh[v] = newTemp();
+            stats.renamed++;
+        }
+    }
+    auto nameOf = [&](int v) -> const std::string& { return original[v] ? ssa.name_of(v) : fresh[v]; };
+
+    // 6. 重写四元式并插入复制。编号：原四元式为下标，插入的从 n+1 起，最后统一重新编号
+    int nextId = n + 1;
+    std::vector<Quadruple> result, stubs;
+    result.reserve(n + n / 8);
+    std::vector<std::pair<std::string, std::string>> copies;
+    std::vector<Quadruple> sequence;
+    // 块b经过到 target（原下标，n 为程序出口）的边时要做的复制
+    auto edgeCopies = [&](int b, int target) {
+        copies.clear();
+        sequence.clear();
+        if (target >= n) {
+            auto it = std::find(cfg.exits.begin(), cfg.exits.end(), b);
+            size_t e = it - cfg.exits.begin();
+            for (size_t k = 0; k < width && it != cfg.exits.end(); k++) {
+                int v = ssa.exit_values[e * width + k];
+                if (v >= 0) copies.push_back({ ssa.names[ssa.exit_names[k]], nameOf(v) });
+            }
+        }
+        else {
+            int to = cfg.block_of_quad[target];
+            int k = predIndex(to, b);
+            for (int p = ssa.phi_offset[to]; p < ssa.phi_offset[to + 1] && k >= 0; p++) {
+                if (livePhi(p) && ssa.phis[p].args[k] >= 0) {
+                    copies.push_back({ nameOf(ssa.phis[p].value), nameOf(ssa.phis[p].args[k]) });
+                }
+            }
+        }
+        sequentialize(copies, newTemp, sequence, stats);
+        for (auto& quad : sequence) quad.label = nextId++;
+        return !sequence.empty();
+    };
+    for (int b = 0; b < num_blocks; b++) {
+        int first = cfg.first_quad(b), last = cfg.last_quad(b);
+        bool reachable = cfg.reachable(b);
+        if (b == entry) {
+            // 程序开始时的复制：入口块φ函数的最后一个参数
+            copies.clear();
+            sequence.clear();
+            for (int p = ssa.phi_offset[b]; p < ssa.phi_offset[b + 1]; p++) {
+                if (livePhi(p) && ssa.phis[p].args.back() >= 0) {
+                    copies.push_back({ nameOf(ssa.phis[p].value), nameOf(ssa.phis[p].args.back()) });
+                }
+            }
+            sequentialize(copies, newTemp, sequence, stats);
+            for (auto& quad : sequence) {
+                quad.label = nextId++;
+                result.push_back(std::move(quad));
+            }
+        }
+        for (int i = first; i <= last; i++) {
+            Quadruple quad = quads[i];
+            quad.label = i;
+            if (is_jump(quad.op)) quad.result = std::to_string(jump_target(quad) - base);
+            if (reachable) {
+                if (ssa.use_value[2 * i] >= 0) quad.arg1 = nameOf(ssa.use_value[2 * i]);
+                if (ssa.use_value[2 * i + 1] >= 0) quad.arg2 = nameOf(ssa.use_value[2 * i + 1]);
+                if (ssa.def_value[i] >= 0) quad.result = nameOf(ssa.def_value[i]);
+            }
+            if (i < last || !reachable) {
+                result.push_back(std::move(quad));
+                continue;
+            }
+            // 块尾：无条件跳转之前做复制；条件跳转的跳转边拆出新块放在程序末尾，顺序边的复制紧接其后
+            int fall = std::min(last + 1, n);
+            if (quad.op == "j") {
+                if (edgeCopies(b, std::min(std::stoi(quad.result), n))) {
+                    result.insert(result.end(), sequence.begin(), sequence.end());
+                }
+                result.push_back(std::move(quad));
+                continue;
+            }
+            if (is_cond_jump(quad.op) && edgeCopies(b, std::min(std::stoi(quad.result), n))) {
+                sequence.push_back(Quadruple{ nextId++, "j", "", "", quad.result });
+                quad.result = std::to_string(sequence.front().label);
+                stubs.insert(stubs.end(), sequence.begin(), sequence.end());
+                stats.split++;
+            }
+            result.push_back(std::move(quad));
+            if (edgeCopies(b, fall)) {
+                result.insert(result.end(), sequence.begin(), sequence.end());
+                stats.split += is_cond_jump(quads[i].op);
+            }
+        }
+    }
+    if (!stubs.empty()) {
+        if (result.back().op != "j") result.push_back(Quadruple{ nextId++, "j", "", "", std::to_string(n) });
+        result.insert(result.end(), stubs.begin(), stubs.end());
+    }
+    relabel_quads(result, base, n);
+    quads.swap(result);
+    return stats;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef SSA_H
+#define SSA_H
+
+#include "assembler.h"
+#include "cfg.h"
+#include <string>
+#include <vector>
+
+// 四元式的SSA视图：不改动四元式，只为每个定值与引用分配紧凑的值编号。
+// 值有三种来源：四元式的定值、块首的φ函数、变量在程序入口处的初值。
+// φ函数按迭代支配边界放置，只为跨块活跃的名字放置（半剪枝SSA）
+struct SSAForm {
+    enum ValueKind { ENTRY, QUAD, PHI };
+    struct Value {
+        ValueKind kind;
+        int def;   // QUAD: 四元式下标；PHI: φ函数下标；ENTRY: -1
+        int name;  // 名字编号
+    };
+    struct Phi {
+        int block;
+        int value;              // φ函数定义的值
+        // 与 cfg 中该块的前驱一一对应，前驱不可达时为 -1；
+        // 入口块的φ函数在最后多一个参数，对应程序开始时的初值
+        std::vector<int> args;
+    };
+
+    std::vector<std::string> names;   // 名字编号 -> 变量或临时变量名
+    std::vector<Value> values;
+    std::vector<Phi> phis;
+    std::vector<int> phi_offset;      // 块b的φ函数为 phis[phi_offset[b] .. phi_offset[b+1])
+    std::vector<int> def_value;       // 四元式下标 -> 定义的值，没有定值时为 -1
+    std::vector<int> use_value;       // 四元式下标*2 + 0/1 -> arg1/arg2 引用的值，常数或空为 -1
+
+    // 值的引用者：use_offset/users 为压缩数组，引用者编码为 四元式下标*2 或 φ下标*2+1
+    std::vector<int> use_offset, users;
+
+    // 程序结束时各变量（非临时变量）的值，看作出口块末尾的引用，不记入 users：
+    // cfg.exits 中第e个出口块结束时变量 exit_names[k] 的值为 exit_values[e*exit_names.size()+k]，
+    // 出口块不可达时为 -1
+    std::vector<int> exit_names;
+    std::vector<int> exit_values;
+
+    int num_values() const { return static_cast<int>(values.size()); }
+    const std::string& name_of(int value) const { return names[values[value].name]; }
+};
+
+// 计算每个块的支配边界，结果为压缩数组（df_offset/df）
+void compute_dominance_frontiers(const CFG& cfg, std::vector<int>& df_offset, std::vector<int>& df);
+// 构造SSA视图，cfg 须已计算支配树；不可达块中的四元式不分配值
+SSAForm build_ssa(const std::vector<Quadruple>& quads, const CFG& cfg);
+
+// 退出SSA：按视图中的引用（use_value、φ参数、exit_values，优化遍可以先改写它们）重写四元式。
+// 每个值尽量沿用原来的名字，同名的值生存期重叠时后者换用新的临时变量；
+// φ函数在前驱末尾变成并行复制，关键边上的复制放在新的跳转块中，
+// 并行复制按依赖排成顺序复制，成环时用一个临时变量打断。视图未改动时四元式不变
+struct SSADestructStats {
+    int renamed = 0;  // 换用新名字的值
+    int copies = 0;   // 插入的复制
+    int cycles = 0;   // 打断的复制环
+    int split = 0;    // 拆分的关键边
+};
+SSADestructStats destruct_ssa(std::vector<Quadruple>& quads, const CFG& cfg, const SSAForm& ssa);
+
+#endif // SSA_H
@@ -0,0 +1,235 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <algorithm>
+#include <set>
+
+namespace {
+
+// 一条比较链：依次比较同一变量与互不相同的常数，相等时转到各自的目标，都不相等时转到 fallback
+struct Case {
+    int16_t value;
+    int target;  // 目标四元式的下标，n 表示跳出程序
+};
+struct Chain {
+    std::string var;
+    int head = 0;              // 第一个比较四元式的下标
+    std::vector<int> removed;  // 链中其余的比较与它们之间只有一条 j 的块
+    std::vector<Case> cases;
+    int fallback = 0;
+};
+
+class SwitchLowering {
+public:
+    SwitchLowering(std::vector<Quadruple>& quads, const SwitchOptions& options, SwitchStats& stats)
+        : quads(quads), options(options), stats(stats), n(static_cast<int>(quads.size())), base(quads[0].label),
+          cfg(build_cfg(quads)), edits(quads.size()), newTemp(temp_allocator(quads)) {}
+
+    bool run() {
+        int blocks = cfg.num_blocks();
+        // 先为每个比较块找链中的下一个，没有前一个的比较块是链头
+        std::vector<int> next(blocks, -1);
+        std::vector<char> hasPrev(blocks, 0);
+        for (int b = 0; b < blocks; b++) {
+            std::string var;
+            if (!test(cfg.last_quad(b), var)) continue;
+            std::vector<int> between;
+            int c = follow(notEqual(cfg.last_quad(b)), between);
+            std::string other;
+            if (c >= 0 && cfg.first_quad(c) == cfg.last_quad(c) && predecessors(c) == 1 &&
+                test(cfg.last_quad(c), other) && other == var && c != b) {
+                next[b] = c;
+                hasPrev[c] = 1;
+            }
+        }
+
+        std::vector<Chain> chains;
+        for (int b = 0; b < blocks; b++) {
+            std::string var;
+            if (hasPrev[b] || !test(cfg.last_quad(b), var)) continue;
+            Chain chain = collect(b, next);
+            if (static_cast<int>(chain.cases.size()) >= options.min_cases) chains.push_back(std::move(chain));
+        }
+
+        // 跳到别的链的链头时落到那条链插入的序列上（apply_edits 的约定）；跳到别的链中要删的比较或 j 时
+        // 无处可落，放弃那条链。放弃的链不再删四元式，反复检查直到没有这样的目标
+        std::vector<int> owner(n, -1);
+        for (size_t c = 0; c < chains.size(); c++) {
+            for (int i : chains[c].removed) owner[i] = static_cast<int>(c);
+        }
+        std::vector<char> dropped(chains.size(), 0);
+        for (bool again = true; again;) {
+            again = false;
+            for (size_t c = 0; c < chains.size(); c++) {
+                if (dropped[c]) continue;
+                std::vector<int> targets = { chains[c].fallback };
+                for (const auto& k : chains[c].cases) targets.push_back(k.target);
+                for (int target : targets) {
+                    int other = target < n ? owner[target] : -1;
+                    if (other < 0 || other == static_cast<int>(c) || dropped[other]) continue;
+                    dropped[other] = 1;
+                    again = true;
+                }
+            }
+        }
+
+        bool changed = false;
+        for (size_t c = 0; c < chains.size(); c++) {
+            if (dropped[c]) continue;
+            lower(chains[c]);
+            changed = true;
+        }
+        if (changed) apply_edits(quads, edits);
+        return changed;
+    }
+
+private:
+    std::vector<Quadruple>& quads;
+    const SwitchOptions& options;
+    SwitchStats& stats;
+    int n, base;
+    CFG cfg;
+    QuadEdits edits;
+    std::function<std::string()> newTemp;
+
+    // 第 i 条是否为变量与常数的 j= 或 j<>，是则把变量名写入 var
+    bool test(int i, std::string& var) const {
+        const Quadruple& quad = quads[i];
+        if (quad.op != "j=" && quad.op != "j<>") return false;
+        bool constant1 = is_number(quad.arg1), constant2 = is_number(quad.arg2);
+        if (constant1 == constant2) return false;
+        var = constant1 ? quad.arg2 : quad.arg1;
+        return true;
+    }
+    int16_t constant(int i) const {
+        const Quadruple& quad = quads[i];
+        return constant_value(is_number(quad.arg1) ? quad.arg1 : quad.arg2);
+    }
+    int target(int i) const { return std::min(jump_target(quads[i]) - base, n); }
+    int equal(int i) const { return quads[i].op == "j=" ? target(i) : i + 1; }
+    int notEqual(int i) const { return quads[i].op == "j=" ? i + 1 : target(i); }
+    int predecessors(int b) const { return cfg.pred_end(b) - cfg.pred_begin(b); }
+
+    // 从下标 i 开始，穿过只有一个前驱、只含一条 j 的块，返回到达的块（跳出程序时为 -1），
+    // 穿过的 j 记在 between 中
+    int follow(int i, std::vector<int>& between) const {
+        while (i < n) {
+            int b = cfg.block_of_quad[i];
+            if (quads[i].op != "j" || cfg.first_quad(b) != i || predecessors(b) != 1) return b;
+            between.push_back(i);
+            i = target(i);
+            if (between.size() > static_cast<size_t>(n)) return -1;
+        }
+        return -1;
+    }
+
+    Chain collect(int head, const std::vector<int>& next) {
+        // 链上的各比较四元式，以及到达它之前穿过的 j
+        std::vector<int> tests = { cfg.last_quad(head) };
+        std::vector<std::vector<int>> passed(1);
+        std::set<int16_t> seen = { constant(tests[0]) };
+        for (int b = next[head]; b >= 0; b = next[b]) {
+            // 常数重复的比较永远不成立，作为链外的后继
+            int i = cfg.last_quad(b);
+            if (!seen.insert(constant(i)).second) break;
+            passed.emplace_back();
+            follow(notEqual(tests.back()), passed.back());
+            tests.push_back(i);
+        }
+        // 相等时的目标是链中要删的四元式时（只在很怪的控制流中出现），从后面截短链
+        while (tests.size() > 1) {
+            std::set<int> gone;
+            for (size_t k = 1; k < tests.size(); k++) {
+                gone.insert(tests[k]);
+                gone.insert(passed[k].begin(), passed[k].end());
+            }
+            bool clash = false;
+            for (int i : tests) clash = clash || gone.count(equal(i)) || gone.count(notEqual(tests.back()));
+            if (!clash) break;
+            tests.pop_back();
+            passed.pop_back();
+        }
+
+        Chain chain;
+        test(tests[0], chain.var);
+        chain.head = tests[0];
+        for (size_t k = 0; k < tests.size(); k++) {
+            chain.cases.push_back({ constant(tests[k]), equal(tests[k]) });
+            if (k == 0) continue;
+            chain.removed.insert(chain.removed.end(), passed[k].begin(), passed[k].end());
+            chain.removed.push_back(tests[k]);
+        }
+        chain.fallback = notEqual(tests.back());
+        return chain;
+    }
+
+    // 链中的比较换成插在链头之后的一段四元式，链头与链中其余的比较删去。
+    // 插入的跳转按 apply_edits 的约定写目标的原下标（别的链的链头落到那条链插入的序列上），
+    // 跳回链头的改写为插入序列的第一条
+    void lower(const Chain& chain) {
+        auto ref = [&](int target) { return target == chain.head ? -1 : target; };
+        std::vector<Case> cases = chain.cases;
+        for (auto& c : cases) c.target = ref(c.target);
+        std::sort(cases.begin(), cases.end(), [](const Case& x, const Case& y) { return x.value < y.value; });
+        int count = static_cast<int>(cases.size());
+        int fallback = ref(chain.fallback);
+
+        std::vector<Quadruple> code;
+        int lo = cases.front().value, hi = cases.back().value;
+        int range = hi - lo + 1;
+        if (range <= options.max_table && count >= options.min_density * range) {
+            // 密集：越界时转到 fallback，否则按 x-lo 查跳转表
+            std::string index = chain.var;
+            code.push_back({ 0, "j<", chain.var, constant_string(static_cast<int16_t>(lo)), std::to_string(fallback) });
+            code.push_back({ 0, "j>", chain.var, constant_string(static_cast<int16_t>(hi)), std::to_string(fallback) });
+            if (lo != 0) {
+                index = newTemp();
+                code.push_back({ 0, "-", chain.var, constant_string(static_cast<int16_t>(lo)), index });
+            }
+            code.push_back({ 0, "switch", index, std::to_string(range), "" });
+            std::vector<int> table(range, fallback);
+            for (const auto& c : cases) table[c.value - lo] = c.target;
+            for (int target : table) code.push_back({ 0, "j", "", "", std::to_string(target) });
+            stats.tables++;
+            stats.entries += range;
+        }
+        else {
+            tree(cases, 0, cases.size(), chain.var, fallback, code);
+            stats.trees++;
+        }
+        stats.chains++;
+        stats.cases += count;
+        stats.added += static_cast<int>(code.size()) - 1 - static_cast<int>(chain.removed.size());
+
+        edits.removed[chain.head] = 1;
+        edits.after[chain.head] = std::move(code);
+        for (int i : chain.removed) edits.removed[i] = 1;
+    }
+
+    // 稀疏：按常数二分比较。不超过3个常数时逐个比较
+    void tree(const std::vector<Case>& cases, size_t l, size_t r, const std::string& var, int fallback,
+        std::vector<Quadruple>& code) const {
+        if (r - l <= 3) {
+            for (size_t k = l; k < r; k++) {
+                code.push_back({ 0, "j=", var, constant_string(cases[k].value), std::to_string(cases[k].target) });
+            }
+            code.push_back({ 0, "j", "", "", std::to_string(fallback) });
+            return;
+        }
+        size_t mid = (l + r) / 2;
+        size_t less = code.size();
+        code.push_back({ 0, "j<", var, constant_string(cases[mid].value), "" });
+        code.push_back({ 0, "j=", var, constant_string(cases[mid].value), std::to_string(cases[mid].target) });
+        tree(cases, mid + 1, r, var, fallback, code);
+        code[less].result = std::to_string(-1 - static_cast<int>(code.size()));
+        tree(cases, l, mid, var, fallback, code);
+    }
+};
+
+}
+
+SwitchStats lower_switches(std::vector<Quadruple>& quads, const SwitchOptions& options) {
+    SwitchStats stats;
+    if (quads.empty()) return stats;
+    SwitchLowering(quads, options, stats).run();
+    return stats;
+}
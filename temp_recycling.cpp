@@ -0,0 +1,91 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+// 临时变量重用（区间着色）
+// 按四元式顺序给每个临时变量一个生存区间：位置 2i 表示第i条四元式读运算对象，2i+1 表示写结果，
+// 区间覆盖它的全部定值与引用，并延伸到它活跃进入的块首、活跃离开的块尾。
+// 区间不相交的临时变量不会同时活跃，可以共用一个名字；按起点排序贪心分配编号最小的空闲名字，
+// 用到的名字数等于同一位置上最多重叠的区间数。临时变量因此不再只赋值一次，本遍应在其他优化之后进行
+TempStats recycle_temps(std::vector<Quadruple>& quads) {
+    TempStats stats;
+    if (quads.empty()) return stats;
+    CFG cfg = build_cfg(quads);
+    compute_dominators(cfg);
+    Liveness live = compute_liveness(quads, cfg);
+
+    struct Range { int start, end; };
+    std::unordered_map<std::string, int> index;
+    std::vector<std::string> names;
+    std::vector<Range> ranges;
+    auto touch = [&](const std::string& name, int position) {
+        if (!is_temp(name)) return;
+        auto it = index.find(name);
+        if (it == index.end()) {
+            index.emplace(name, static_cast<int>(names.size()));
+            names.push_back(name);
+            ranges.push_back(Range{ position, position });
+            return;
+        }
+        Range& range = ranges[it->second];
+        range.start = std::min(range.start, position);
+        range.end = std::max(range.end, position);
+    };
+    int n = static_cast<int>(quads.size());
+    for (int i = 0; i < n; i++) {
+        const Quadruple& quad = quads[i];
+        touch(quad.arg1, 2 * i);
+        touch(quad.arg2, 2 * i);
+        if (!is_jump(quad.op)) touch(quad.result, 2 * i + 1);
+    }
+    for (int b = 0; b < cfg.num_blocks(); b++) {
+        live.live_in[b].for_each([&](size_t bit) { touch(live.names[bit], 2 * cfg.first_quad(b)); });
+        live.live_out[b].for_each([&](size_t bit) { touch(live.names[bit], 2 * cfg.last_quad(b) + 1); });
+    }
+    stats.before = static_cast<int>(names.size());
+
+    // 按起点扫描，区间结束早于当前起点的名字归还空闲堆
+    std::vector<int> order(names.size());
+    for (size_t k = 0; k < order.size(); k++) order[k] = static_cast<int>(k);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return ranges[a].start != ranges[b].start ? ranges[a].start < ranges[b].start : a < b;
+    });
+    using Active = std::pair<int, int>;  // (区间终点, 名字编号)
+    std::priority_queue<Active, std::vector<Active>, std::greater<Active>> active;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> free;
+    std::vector<int> color(names.size());
+    int colors = 0;
+    for (int k : order) {
+        while (!active.empty() && active.top().first < ranges[k].start) {
+            free.push(active.top().second);
+            active.pop();
+        }
+        if (free.empty()) {
+            color[k] = ++colors;
+        }
+        else {
+            color[k] = free.top();
+            free.pop();
+        }
+        active.push({ ranges[k].end, color[k] });
+    }
+    stats.after = colors;
+
+    std::vector<std::string> renamed(names.size());
+    for (size_t k = 0; k < names.size(); k++) {
+        renamed[k] = "T" + std::to_string(color[k]);
+        stats.renamed += renamed[k] != names[k];
+    }
+    for (auto& quad : quads) {
+        for (std::string* name : { &quad.arg1, &quad.arg2, &quad.result }) {
+            if (is_jump(quad.op) && name == &quad.result) continue;
+            auto it = index.find(*name);
+            if (it != index.end()) *name = renamed[it->second];
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,128 @@
+#include "optimizer.h"
+#include "cfg.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// 基本块内的值编号表
+class ValueTable {
+public:
+    // 名字（变量、临时变量或常数）当前的值编号，块内首次出现时分配新编号
+    int valueOf(const std::string& name) {
+        auto it = numbers.find(name);
+        if (it != numbers.end()) return it->second;
+        int vn = fresh();
+        numbers[name] = vn;
+        holders[vn].push_back(name);
+        return vn;
+    }
+
+    int fresh() {
+        holders.emplace_back();
+        return static_cast<int>(holders.size()) - 1;
+    }
+
+    // 名字被重新赋值为编号vn；它原先持有的值不再由它保存
+    void assign(const std::string& name, int vn) {
+        numbers[name] = vn;
+        holders[vn].push_back(name);
+    }
+
+    // 找出当前仍保存编号vn的名字，优先选择只赋值一次的临时变量
+    std::string holder(int vn, const NameCounts& names) {
+        std::string best;
+        for (const auto& name : holders[vn]) {
+            auto it = numbers.find(name);
+            if (it == numbers.end() || it->second != vn) continue;
+            if (is_temp(name) && names.defs_of(name) == 1) return name;
+            if (best.empty()) best = name;
+        }
+        return best;
+    }
+
+    // 表达式键：运算符与两个运算对象的值编号，+ 与 * 满足交换律，按编号排序
+    int lookup(const std::string& op, int left, int right) {
+        if ((op == "+" || op == "*") && left > right) std::swap(left, right);
+        std::string key = op + "\x1f" + std::to_string(left) + "," + std::to_string(right);
+        auto it = expressions.find(key);
+        if (it != expressions.end()) return it->second;
+        int vn = fresh();
+        expressions[key] = vn;
+        return -1 - vn;  // 负数表示新表达式，编号为 -1 - 返回值
+    }
+
+private:
+    std::unordered_map<std::string, int> numbers;
+    std::unordered_map<std::string, int> expressions;
+    std::vector<std::vector<std::string>> holders;
+};
+
+}
+
+// 局部值编号的块内部分：counts[0] 为删除的四元式数，counts[1] 为改写为复制的四元式数。
+// 临时变量由语法分析器为每个运算新建，只赋值一次，因此被删除的临时变量可以在整个程序中
+// 改名为先前的结果；结果为普通变量或多次赋值的临时变量时只把运算改写为复制
+void number_values_in_block(BlockWork& work, const NameCounts& names) {
+    ValueTable table;
+    std::unordered_map<std::string, std::string> rename;
+    auto renamed = [&](std::string& name) {
+        auto it = rename.find(name);
+        if (it != rename.end()) name = it->second;
+    };
+    for (size_t k = 0; k < work.quads.size(); k++) {
+        Quadruple& quad = work.quads[k];
+        renamed(quad.arg1);
+        renamed(quad.arg2);
+        if (is_jump(quad.op) || quad.result.empty()) continue;
+
+        if (quad.op == ":=") {
+            table.assign(quad.result, table.valueOf(quad.arg1));
+            continue;
+        }
+        if (quad.arg2.empty()) {
+            table.assign(quad.result, table.fresh());
+            continue;
+        }
+
+        int found = table.lookup(quad.op, table.valueOf(quad.arg1), table.valueOf(quad.arg2));
+        if (found < 0) {
+            table.assign(quad.result, -1 - found);
+            continue;
+        }
+        std::string holder = table.holder(found, names);
+        if (holder.empty() || holder == quad.result) {
+            table.assign(quad.result, found);
+            continue;
+        }
+        if (is_temp(quad.result) && names.defs_of(quad.result) == 1 &&
+            is_temp(holder) && names.defs_of(holder) == 1) {
+            rename[quad.result] = holder;
+            work.renames.emplace_back(quad.result, holder);
+            work.removed[k] = 1;
+            work.counts[0]++;
+        }
+        else {
+            quad = Quadruple{ quad.label, ":=", holder, "", quad.result };
+            table.assign(quad.result, found);
+            work.counts[1]++;
+        }
+    }
+}
+
+// 局部值编号：逐块编号，跨块引用（包括循环回边上先于定值出现的引用）在合并时统一改名
+LVNStats local_value_numbering(std::vector<Quadruple>& quads) {
+    LVNStats stats;
+    if (quads.empty()) return stats;
+    NameCounts names = count_names(quads);
+    CFG cfg = build_cfg(quads);
+    std::vector<BlockWork> works;
+    for (int b = 0; b < cfg.num_blocks(); b++) {
+        works.push_back(block_work(quads, cfg, b));
+        number_values_in_block(works.back(), names);
+        stats.removed += works.back().counts[0];
+        stats.copies += works.back().counts[1];
+    }
+    merge_block_work(quads, works);
+    return stats;
+}